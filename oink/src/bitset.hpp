@@ -17,8 +17,16 @@
 #ifndef BITSET_HPP
 #define BITSET_HPP
 
+#include <cstdlib>
 #include <libpopcnt.h>
 
+#include "mempolicy.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BITSET_SIMD_X86
+#endif
+
 namespace pg
 {
 
@@ -27,6 +35,166 @@ static inline int bsr(uint64_t x)
     return __builtin_clzll(x) ^ 63;
 }
 
+/**
+ * Kernels for the whole-set operations of bitset on <len> blocks, with AVX-512 and AVX2
+ * variants selected at runtime, as the tools and tests are not built with -march=native.
+ * The vector kernels only pay off for longer sets; short sets use the scalar loops.
+ */
+
+enum { BITSET_SCALAR = 0, BITSET_AVX2 = 1, BITSET_AVX512 = 2 };
+
+static inline int
+bitset_isa_detect()
+{
+#ifdef BITSET_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return BITSET_AVX512;
+    if (__builtin_cpu_supports("avx2")) return BITSET_AVX2;
+#endif
+    return BITSET_SCALAR;
+}
+
+static inline int
+bitset_isa()
+{
+    static const int isa = bitset_isa_detect();
+    return isa;
+}
+
+static const size_t BITSET_SIMD_MIN = 8; // minimum number of blocks for the vector kernels
+
+enum { BITSET_OR, BITSET_AND, BITSET_ANDNOT, BITSET_XOR };
+
+template <int OP>
+static inline uint64_t
+bitset_apply(uint64_t a, uint64_t b)
+{
+    return OP == BITSET_OR ? a | b : OP == BITSET_AND ? a & b : OP == BITSET_ANDNOT ? a & ~b : a ^ b;
+}
+
+#ifdef BITSET_SIMD_X86
+
+template <int OP>
+__attribute__ ((target ("avx512f")))
+static inline __m512i
+bitset_apply_avx512(__m512i a, __m512i b)
+{
+    return OP == BITSET_OR ? _mm512_or_si512(a, b) : OP == BITSET_AND ? _mm512_and_si512(a, b) :
+           OP == BITSET_ANDNOT ? _mm512_andnot_si512(b, a) : _mm512_xor_si512(a, b);
+}
+
+template <int OP>
+__attribute__ ((target ("avx512f")))
+static inline void
+bitset_op_avx512(uint64_t *p, const uint64_t *q, size_t len)
+{
+    size_t i = 0;
+    for (; i+8 <= len; i += 8) {
+        const __m512i a = _mm512_loadu_si512((const void*)(p+i));
+        const __m512i b = _mm512_loadu_si512((const void*)(q+i));
+        _mm512_storeu_si512((void*)(p+i), bitset_apply_avx512<OP>(a, b));
+    }
+    if (i < len) {
+        const __mmask8 m = (__mmask8)((1u << (len-i)) - 1);
+        const __m512i a = _mm512_maskz_loadu_epi64(m, p+i);
+        const __m512i b = _mm512_maskz_loadu_epi64(m, q+i);
+        _mm512_mask_storeu_epi64(p+i, m, bitset_apply_avx512<OP>(a, b));
+    }
+}
+
+__attribute__ ((target ("avx512f")))
+static inline bool
+bitset_equal_avx512(const uint64_t *p, const uint64_t *q, size_t len)
+{
+    size_t i = 0;
+    for (; i+8 <= len; i += 8) {
+        const __m512i a = _mm512_loadu_si512((const void*)(p+i));
+        const __m512i b = _mm512_loadu_si512((const void*)(q+i));
+        if (_mm512_cmpneq_epi64_mask(a, b)) return false;
+    }
+    if (i < len) {
+        const __mmask8 m = (__mmask8)((1u << (len-i)) - 1);
+        const __m512i a = _mm512_maskz_loadu_epi64(m, p+i);
+        const __m512i b = _mm512_maskz_loadu_epi64(m, q+i);
+        if (_mm512_cmpneq_epi64_mask(a, b)) return false;
+    }
+    return true;
+}
+
+template <int OP>
+__attribute__ ((target ("avx2")))
+static inline __m256i
+bitset_apply_avx2(__m256i a, __m256i b)
+{
+    return OP == BITSET_OR ? _mm256_or_si256(a, b) : OP == BITSET_AND ? _mm256_and_si256(a, b) :
+           OP == BITSET_ANDNOT ? _mm256_andnot_si256(b, a) : _mm256_xor_si256(a, b);
+}
+
+template <int OP>
+__attribute__ ((target ("avx2")))
+static inline void
+bitset_op_avx2(uint64_t *p, const uint64_t *q, size_t len)
+{
+    size_t i = 0;
+    for (; i+4 <= len; i += 4) {
+        const __m256i a = _mm256_loadu_si256((const __m256i*)(p+i));
+        const __m256i b = _mm256_loadu_si256((const __m256i*)(q+i));
+        _mm256_storeu_si256((__m256i*)(p+i), bitset_apply_avx2<OP>(a, b));
+    }
+    for (; i < len; i++) p[i] = bitset_apply<OP>(p[i], q[i]);
+}
+
+__attribute__ ((target ("avx2")))
+static inline bool
+bitset_equal_avx2(const uint64_t *p, const uint64_t *q, size_t len)
+{
+    size_t i = 0;
+    for (; i+4 <= len; i += 4) {
+        const __m256i a = _mm256_loadu_si256((const __m256i*)(p+i));
+        const __m256i b = _mm256_loadu_si256((const __m256i*)(q+i));
+        const __m256i x = _mm256_xor_si256(a, b);
+        if (!_mm256_testz_si256(x, x)) return false;
+    }
+    for (; i < len; i++) if (p[i] != q[i]) return false;
+    return true;
+}
+
+#endif
+
+/**
+ * p[i] := p[i] OP q[i] for the <len> blocks at <p> and <q>.
+ */
+template <int OP>
+static inline void
+bitset_op(uint64_t *p, const uint64_t *q, size_t len)
+{
+#ifdef BITSET_SIMD_X86
+    if (len >= BITSET_SIMD_MIN) {
+        const int isa = bitset_isa();
+        if (isa == BITSET_AVX512) return bitset_op_avx512<OP>(p, q, len);
+        if (isa == BITSET_AVX2) return bitset_op_avx2<OP>(p, q, len);
+    }
+#endif
+    while (len-- != 0) {
+        *p = bitset_apply<OP>(*p, *q++);
+        p++;
+    }
+}
+
+static inline bool
+bitset_equal(const uint64_t *p, const uint64_t *q, size_t len)
+{
+#ifdef BITSET_SIMD_X86
+    if (len >= BITSET_SIMD_MIN) {
+        const int isa = bitset_isa();
+        if (isa == BITSET_AVX512) return bitset_equal_avx512(p, q, len);
+        if (isa == BITSET_AVX2) return bitset_equal_avx2(p, q, len);
+    }
+#endif
+    while (len-- != 0) if ((*p++) != (*q++)) return false;
+    return true;
+}
+
 class bitset
 {
 public:
@@ -75,8 +243,9 @@ public:
         _size = newsize;
         _bitssize = (_size+63)/64;
         _allocsize = _bitssize * 8;
-        _bits = new uint64_t[_bitssize];
-        std::fill(_bits, _bits+_bitssize, '\0');
+        _bits = (uint64_t*)mem_alloc(_allocsize);
+        if (_bits == NULL and _allocsize != 0) abort();
+        mem_set(_bits, 0, _allocsize);
     }
 
     bitset(const bitset &other)
@@ -84,13 +253,14 @@ public:
         _size = other._size;
         _bitssize = other._bitssize;
         _allocsize = _bitssize * 8;
-        _bits = new uint64_t[_bitssize];
-        std::copy(other._bits, other._bits+_bitssize, _bits);
+        _bits = (uint64_t*)mem_alloc(_allocsize);
+        if (_bits == NULL and _allocsize != 0) abort();
+        mem_copy(_bits, other._bits, _allocsize);
     }
 
     ~bitset()
     {
-        if (_bits != NULL) delete[] _bits;
+        if (_bits != NULL) mem_free(_bits, _allocsize);
     }
 
     /**
@@ -215,6 +385,51 @@ public:
         return (_bits[block_index(pos)] & bit_mask(pos)) != 0;
     }
 
+    /**
+     * Returns block <i>, i.e., the bits 64*i to 64*i+63.
+     */
+    inline uint64_t block(size_t i) const
+    {
+        return _bits[i];
+    }
+
+    /**
+     * Atomic variants, for threads that update different bits of the same block.
+     * atomic_set and atomic_reset return true if the bit changed.
+     */
+    inline bool atomic_set(size_t pos)
+    {
+        const uint64_t mask = bit_mask(pos);
+        return (__atomic_fetch_or(_bits + block_index(pos), mask, __ATOMIC_RELAXED) & mask) == 0;
+    }
+
+    inline bool atomic_reset(size_t pos)
+    {
+        const uint64_t mask = bit_mask(pos);
+        return (__atomic_fetch_and(_bits + block_index(pos), ~mask, __ATOMIC_RELAXED) & mask) != 0;
+    }
+
+    inline bool atomic_test(size_t pos) const
+    {
+        return (__atomic_load_n(_bits + block_index(pos), __ATOMIC_RELAXED) & bit_mask(pos)) != 0;
+    }
+
+    /**
+     * Atomically set the bits of <mask> in block <i>, i.e., the bits 64*i to 64*i+63.
+     */
+    inline void atomic_set_block(size_t i, uint64_t mask)
+    {
+        __atomic_fetch_or(_bits + i, mask, __ATOMIC_RELAXED);
+    }
+
+    /**
+     * Returns block <i>, read atomically.
+     */
+    inline uint64_t atomic_block(size_t i) const
+    {
+        return __atomic_load_n(_bits + i, __ATOMIC_RELAXED);
+    }
+
     reference operator[](size_t pos)
     {
         return reference(_bits[block_index(pos)], bit_index(pos));
@@ -234,47 +449,31 @@ public:
 
     bitset& operator-=(const bitset& other)
     {
-        uint64_t *p = _bits;
-        const uint64_t *q = other._bits;
-        std::size_t len = num_blocks();
-        while (len-- != 0) (*p++) &= ~(*q++);
+        bitset_op<BITSET_ANDNOT>(_bits, other._bits, num_blocks());
         return *this;
     }
 
     bitset& operator&=(const bitset& other)
     {
-        uint64_t *p = _bits;
-        const uint64_t *q = other._bits;
-        std::size_t len = num_blocks();
-        while (len-- != 0) (*p++) &= (*q++);
+        bitset_op<BITSET_AND>(_bits, other._bits, num_blocks());
         return *this;
     }
 
     bitset& operator|=(const bitset &other)
     {
-        uint64_t *p = _bits;
-        const uint64_t *q = other._bits;
-        std::size_t len = num_blocks();
-        while (len-- != 0) (*p++) |= (*q++);
+        bitset_op<BITSET_OR>(_bits, other._bits, num_blocks());
         return *this;
     }
 
     bitset& operator^=(const bitset &other)
     {
-        uint64_t *p = _bits;
-        const uint64_t *q = other._bits;
-        std::size_t len = num_blocks();
-        while (len-- != 0) (*p++) ^= (*q++);
+        bitset_op<BITSET_XOR>(_bits, other._bits, num_blocks());
         return *this;
     }
 
     bool operator==(const bitset &other) const
     {
-        const uint64_t *p = _bits;
-        const uint64_t *q = other._bits;
-        std::size_t len = num_blocks();
-        while (len-- != 0) if ((*p++) != (*q++)) return false;
-        return true;
+        return bitset_equal(_bits, other._bits, num_blocks());
     }
 
     bool operator!=(const bitset &other) const
@@ -353,8 +552,127 @@ public:
         }
     }
 
+    /**
+     * Number of bits set in both this bitset and <other>.
+     */
+    size_t count_and(const bitset& other) const
+    {
+        size_t res = 0;
+        for (size_t i=0; i<num_blocks(); i++) res += popcnt64(_bits[i] & other._bits[i]);
+        return res;
+    }
+
+    /**
+     * Number of bits set in this bitset but not in <other>, i.e., the count of this - other.
+     */
+    size_t count_andnot(const bitset& other) const
+    {
+        size_t res = 0;
+        for (size_t i=0; i<num_blocks(); i++) res += popcnt64(_bits[i] & ~other._bits[i]);
+        return res;
+    }
+
+    /**
+     * Returns true if any bit in <lo> (inclusive) to <hi> (exclusive) is set.
+     */
+    bool any_range(size_t lo, size_t hi) const
+    {
+        if (hi > _size) hi = _size;
+        if (lo >= hi) return false;
+        const size_t first = block_index(lo), last = block_index(hi-1);
+        const uint64_t lomask = ~uint64_t(0) << bit_index(lo);
+        const uint64_t himask = ~uint64_t(0) >> (63 - bit_index(hi-1));
+        if (first == last) return (_bits[first] & lomask & himask) != 0;
+        if (_bits[first] & lomask) return true;
+        for (size_t i=first+1; i<last; i++) if (_bits[i]) return true;
+        return (_bits[last] & himask) != 0;
+    }
+
+    /**
+     * Call <f> on every set bit in <lo> (inclusive) to <hi> (exclusive), in increasing order.
+     * Decodes a block at a time, so <f> must not change this bitset.
+     */
+    template <typename F>
+    void for_each(F f, size_t lo = 0, size_t hi = npos) const
+    {
+        scan_up([this](size_t i) { return _bits[i]; }, f, lo, hi);
+    }
+
+    /**
+     * As for_each, in decreasing order.
+     */
+    template <typename F>
+    void for_each_reverse(F f, size_t lo = 0, size_t hi = npos) const
+    {
+        scan_down([this](size_t i) { return _bits[i]; }, f, lo, hi);
+    }
+
+    /**
+     * As for_each, for the bits set in both this bitset and <other>.
+     */
+    template <typename F>
+    void for_each_and(const bitset& other, F f, size_t lo = 0, size_t hi = npos) const
+    {
+        const uint64_t *q = other._bits;
+        scan_up([this, q](size_t i) { return _bits[i] & q[i]; }, f, lo, hi);
+    }
+
+    /**
+     * As for_each_and, in decreasing order.
+     */
+    template <typename F>
+    void for_each_and_reverse(const bitset& other, F f, size_t lo = 0, size_t hi = npos) const
+    {
+        const uint64_t *q = other._bits;
+        scan_down([this, q](size_t i) { return _bits[i] & q[i]; }, f, lo, hi);
+    }
+
     static const size_t npos = static_cast<size_t>(-1);
 
+private:
+    /**
+     * Decode the blocks given by <word> from <lo> to <hi>, calling <f> on every set bit.
+     */
+    template <typename W, typename F>
+    void scan_up(W word, F f, size_t lo, size_t hi) const
+    {
+        if (hi > _size) hi = _size;
+        if (lo >= hi) return;
+        size_t i = block_index(lo);
+        const size_t last = block_index(hi-1);
+        uint64_t w = word(i) & (~uint64_t(0) << bit_index(lo));
+        for (;;) {
+            if (i == last) w &= ~uint64_t(0) >> (63 - bit_index(hi-1));
+            while (w) {
+                const size_t b = __builtin_ctzll(w);
+                w &= w-1;
+                f(i*64 + b);
+            }
+            if (i == last) return;
+            w = word(++i);
+        }
+    }
+
+    template <typename W, typename F>
+    void scan_down(W word, F f, size_t lo, size_t hi) const
+    {
+        if (hi > _size) hi = _size;
+        if (lo >= hi) return;
+        const size_t first = block_index(lo);
+        size_t i = block_index(hi-1);
+        uint64_t w = word(i) & (~uint64_t(0) >> (63 - bit_index(hi-1)));
+        for (;;) {
+            if (i == first) w &= ~uint64_t(0) << bit_index(lo);
+            while (w) {
+                const size_t b = bsr(w);
+                w ^= uint64_t(1) << b;
+                f(i*64 + b);
+            }
+            if (i == first) return;
+            w = word(--i);
+        }
+    }
+
 protected:
     uint64_t *_bits;
     size_t _size, _bitssize;
@@ -185,6 +185,11 @@ DPSolver::run()
                 } else if (res == -1) {
                     // found dominion
                     setDominion(p);
+                    // continue on a compacted copy if most vertices are solved
+                    if (oink->compactionDue()) {
+                        i = -1;
+                        break;
+                    }
                     // restart algorithm and break inner loop
                     i = nodecount() - 1;
                     // reset everything... (sadly)
@@ -276,6 +281,9 @@ DPSolver::run()
     delete[] inverse;
 
     logger << "solved with " << promotions << " promotions, " << performances << "x performing delayed promotions (delayed " << delayed << ", discarded " << discarded << ", total " << promotions+discarded << ")" << std::endl;
+    stats.count("promotions", promotions);
+    stats.count("delayed", delayed);
+    stats.count("discarded", discarded);
 }
 
 }
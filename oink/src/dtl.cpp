@@ -19,6 +19,7 @@
 #include <cstring> // for memset
 
 #include "dtl.hpp"
+#include "phases.hpp"
 
 #define CHECK_UNIQUE (1 or !NDEBUG) // detect duplicate dominions
 
@@ -210,6 +211,7 @@ DTLSolver::attractTangles(const int pl, int v, bitset &R, bitset &Z, bitset &G,
 bool
 DTLSolver::extractTangles(int startvertex, bitset &R, int *str)
 {
+    OINK_PHASE("extractTangles");
     bool new_tangles = false;
     const int pr = priority(startvertex);
     const int pl = pr&1;
@@ -1140,6 +1142,10 @@ DTLSolver::run()
 
     logger << "found " << dominions << " dominions and "<< tangles << " tangles.\n";
     logger << "solved in " << iterations << " iterations and " << steps << " pruning steps.\n";
+    stats.count("dominions", dominions);
+    stats.count("tangles", tangles);
+    stats.count("iterations", iterations);
+    stats.count("pruning_steps", steps);
     logger << "odd iterations: " << odd_iterations << std::endl;
     logger << "even iterations: " << even_iterations << std::endl;
 
@@ -31,24 +31,17 @@ FPISolver::~FPISolver()
 {
 }
 
+/**
+ * The bitsets are updated with atomic operations, so tasks can split the vertices anywhere.
+ */
 TASK_3(int, update_block_rec, FPISolver*, solver, int, i, int, n)
 {
-    if (n>128) {
-        // because dynamic bitset is not thread safe, work in blocks of 64...
-        if (i&127) {
-            // start not yet aligned
-            int N = 128 - (i&127);
-            SPAWN(update_block_rec, solver, i+N, n-N);
-            int a = solver->updateBlock(i, N);
-            int b = SYNC(update_block_rec);
-            return a+b;
-        } else {
-            int N = (n/128)*64;
-            SPAWN(update_block_rec, solver, i+N, n-N);
-            int a = CALL(update_block_rec, solver, i, N);
-            int b = SYNC(update_block_rec);
-            return a+b;
-        }
+    if (n>64) {
+        int N = n/2;
+        SPAWN(update_block_rec, solver, i+N, n-N);
+        int a = CALL(update_block_rec, solver, i, N);
+        int b = SYNC(update_block_rec);
+        return a+b;
     } else {
         return solver->updateBlock(i, n);
     }
@@ -56,75 +49,112 @@ TASK_3(int, update_block_rec, FPISolver*, solver, int, i, int, n)
 
 VOID_TASK_4(freeze_thaw_reset_rec, FPISolver*, solver, int, i, int, n, int, p)
 {
-    if (n>128) {
-        // because dynamic bitset is not thread safe, work in blocks of 64...
-        if (i&127) {
-            // start not yet aligned
-            int N = 128 - (i&127);
-            SPAWN(freeze_thaw_reset_rec, solver, i+N, n-N, p);
-            solver->freezeThawReset(i, N, p);
-            SYNC(freeze_thaw_reset_rec);
-        } else {
-            int N = (n/128)*64;
-            SPAWN(freeze_thaw_reset_rec, solver, i+N, n-N, p);
-            CALL(freeze_thaw_reset_rec, solver, i, N, p);
-            SYNC(freeze_thaw_reset_rec);
-        }
+    if (n>64) {
+        int N = n/2;
+        SPAWN(freeze_thaw_reset_rec, solver, i+N, n-N, p);
+        CALL(freeze_thaw_reset_rec, solver, i, N, p);
+        SYNC(freeze_thaw_reset_rec);
     } else {
         solver->freezeThawReset(i, n, p);
     }
 }
 
+/**
+ * Put the predecessors of <v> on the frontier, after the winner of <v> changed.
+ */
+void
+FPISolver::touchPredecessors(int v)
+{
+    for (auto curedge = ins(v); *curedge != -1; curedge++) {
+        int from = *curedge;
+        if (!disabled[from]) frontier.atomic_set(from);
+    }
+}
+
+/**
+ * Returns the priority of the first vertex >= <v> on the frontier, or <d>+1 if there is none.
+ * The blocks before it have nothing to update.
+ */
+int
+FPISolver::nextBlock(int v, int d)
+{
+    const size_t next = v == 0 ? frontier.find_first() : frontier.find_next(v-1);
+    return next == bitset::npos ? d+1 : priority(next);
+}
+
+/**
+ * Update the vertices i..i+n-1 on the frontier.
+ * The other vertices still have the same one step winner, as their successors did not change.
+ * Returns the number of new distractions.
+ */
 int
 FPISolver::updateBlock(int i, int n)
 {
     int res = 0;
-    for (; n != 0; i++, n--) {
-        if (disabled[i]) continue;
-        if (frozen[i]) continue;
-        if (distraction[i]) continue;
+    unsigned long long visits = 0;
+    const int end = i+n;
+    while (i < end) {
+        // find the next vertex on the frontier; reread the block every time, as new distractions
+        // put their predecessors on the frontier, possibly further on in this block
+        const uint64_t block = frontier.atomic_block(i/64) & (~uint64_t(0) << (i&63));
+        if (block == 0) {
+            i = (i|63)+1;
+            continue;
+        }
+        i = (i&~63) + __builtin_ctzll(block);
+        if (i >= end) break;
+        const int v = i++;
+
+        // frozen vertices and distractions return to the frontier when thawed or reset
+        frontier.atomic_reset(v);
+        if (frozen[v]) continue;
+        if (distraction.atomic_test(v)) continue;
 
-        // update whether current vertex <i> is a distraction by computing the one step winner
+        // update whether current vertex <v> is a distraction by computing the one step winner
         int onestep_winner;
-        if (owner(i) == 0) {
+        if (owner(v) == 0) {
             // see if player Even can go to a vertex currently good for Even
             onestep_winner = 1;
-            for (auto curedge = outs(i); *curedge != -1; curedge++) {
+            for (auto curedge = outs(v); *curedge != -1; curedge++) {
                 int to = *curedge;
+                visits++;
                 if (disabled[to]) continue;
-                const int winner_to = parity[to] ^ distraction[to];
+                const int winner_to = parity[to] ^ distraction.atomic_test(to);
                 if (winner_to == 0) {
                     // good for player Even
                     onestep_winner = 0;
                     // and set the strategy
-                    strategy[i] = to;
+                    strategy[v] = to;
                     break;
                 }
             }
         } else {
             // see if player Odd can go to a vertex currently good for Odd
             onestep_winner = 0;
-            for (auto curedge = outs(i); *curedge != -1; curedge++) {
+            for (auto curedge = outs(v); *curedge != -1; curedge++) {
                 int to = *curedge;
+                visits++;
                 if (disabled[to]) continue;
-                const int winner_to = parity[to] ^ distraction[to];
+                const int winner_to = parity[to] ^ distraction.atomic_test(to);
                 if (winner_to == 1) {
                     // good for player Odd
                     onestep_winner = 1;
                     // and set the strategy
-                    strategy[i] = to;
+                    strategy[v] = to;
                     break;
                 }
             }
         }
-        if (parity[i] != onestep_winner) {
-            distraction[i] = true;
+        if (parity[v] != onestep_winner) {
+            distraction.atomic_set(v);
+            touchPredecessors(v);
             res++;
 #ifndef NDEBUG
-            if (trace >= 2) logger << "vertex " << label_vertex(i) << " is now a distraction (won by " << onestep_winner << ")" << std::endl;
+            if (trace >= 2) logger << "vertex " << label_vertex(v) << " is now a distraction (won by " << onestep_winner << ")" << std::endl;
 #endif
         }
     }
+    if (visits != 0) __atomic_fetch_add(&edge_visits, visits, __ATOMIC_RELAXED);
     return res;
 }
 
@@ -145,19 +175,22 @@ FPISolver::freezeThawReset(int i, int n, int p)
                 frozen[i] = p;
             } else {
                 frozen[i] = 0;
-                distraction[i] = 0;
+                if (distraction.atomic_reset(i)) touchPredecessors(i);
+                frontier.atomic_set(i);
 #ifndef NDEBUG
                 if (trace >= 2) logger << "\033[38;5;202;1mthaw\033[m " << label_vertex(i) << std::endl;
 #endif
             }
-        } else if (distraction[i]) {
+        } else if (distraction.atomic_test(i)) {
             if (parity[i] == pl) {
                 frozen[i] = p;
 #ifndef NDEBUG
                 if (trace >= 2) logger << "\033[38;5;51;1mfreeze\033[m " << label_vertex(i) << " at priority " << p << std::endl;
 #endif
             } else {
-                distraction[i] = 0;
+                distraction.atomic_reset(i);
+                touchPredecessors(i);
+                frontier.atomic_set(i);
 #ifndef NDEBUG
                 if (trace >= 2) logger << "\033[31;1mresetting\033[m " << label_vertex(i) << std::endl;
 #endif
@@ -211,8 +244,8 @@ VOID_TASK_1(fpi_run_par, FPISolver*, _this)
             if (_this->trace >= 2) _this->logger << "restarting after finding distractions" << std::endl;
 #endif
         } else {
-            // nothing changed
-            p++;
+            // nothing changed, continue with the next block that has vertices on the frontier
+            p = _this->nextBlock(p_start[p]+p_len[p], d);
         }
     }
 
@@ -232,6 +265,9 @@ FPISolver::runPar()
     distraction.resize(nodecount());
     parity.reset();
     distraction.reset();
+    frontier.resize(nodecount());
+    frontier.set();
+    frontier -= disabled; // initially, evaluate every vertex
     strategy = new int[nodecount()]; // the current strategy for winning the game
     frozen = new int[nodecount()]; // records for every vertex at which level it is frozen (or 0 if not frozen)
 
@@ -250,7 +286,9 @@ FPISolver::runPar()
     delete[] strategy;
     delete[] frozen;
 
-    logger << "solved with " << iterations << " iterations." << std::endl;
+    logger << "solved with " << iterations << " iterations, " << edge_visits << " edge visits (" << edge_visits/iterations << " per iteration)." << std::endl;
+    stats.count("iterations", iterations);
+    stats.count("edge_visits", edge_visits);
 }
 
 void
@@ -260,6 +298,9 @@ FPISolver::runSeq()
      * Allocate and initialize data structures
      */
     distraction.resize(nodecount());
+    frontier.resize(nodecount());
+    frontier.set();
+    frontier -= disabled; // initially, evaluate every vertex
     strategy = new int[nodecount()]; // the current strategy for winning the game
     frozen = new int[nodecount()]; // records for every vertex at which level it is frozen (or 0 if not frozen)
     memset(frozen, 0, sizeof(int[nodecount()])); // initially no vertex is frozen (we don't freeze at level 0)
@@ -293,10 +334,15 @@ FPISolver::runSeq()
     iterations = 1;
     int p = 0;
     while (p <= d) {
-        if (p_len[p] == 0 or updateBlock(p_start[p], p_len[p]) == 0) {
+        if (p_len[p] == 0) {
             p++;
             continue;
-        } 
+        }
+        if (updateBlock(p_start[p], p_len[p]) == 0) {
+            // nothing changed, continue with the next block that has vertices on the frontier
+            p = nextBlock(p_start[p]+p_len[p], d);
+            continue;
+        }
 
         if (p != 0) {
             // actually we don't freeze at priority 0 :-)
@@ -327,7 +373,9 @@ FPISolver::runSeq()
     delete[] p_start;
     delete[] p_len;
 
-    logger << "solved with " << iterations << " iterations." << std::endl;
+    logger << "solved with " << iterations << " iterations, " << edge_visits << " edge visits (" << edge_visits/iterations << " per iteration)." << std::endl;
+    stats.count("iterations", iterations);
+    stats.count("edge_visits", edge_visits);
 
 #ifndef NDEBUG
     if (trace) {
@@ -31,15 +31,21 @@ public:
     virtual ~FPISolver();
 
     int updateBlock(int i, int n);
+    int nextBlock(int v, int d);
     void freezeThawReset(int i, int n, int p);
     void runPar(void);
     void runSeq(void);
 
     unsigned long long iterations = 0;
+    unsigned long long edge_visits = 0;
     int *frozen;
     int *strategy;
     bitset parity;
     bitset distraction;
+    bitset frontier; // vertices to (re)evaluate, as a successor changed since the last time
+
+protected:
+    void touchPredecessors(int v);
 
     virtual void run();
 };
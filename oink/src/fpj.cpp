@@ -180,6 +180,7 @@ FPJSolver::runSeqGreedy()
     delete[] strategy;
 
     logger << "solved with " << iterations << " iterations." << std::endl;
+    stats.count("iterations", iterations);
 }
 
 
@@ -203,9 +204,10 @@ FPJSolver::runSeq()
      * Initialize loop
      */
 
-    int cur_parity = parity[0]; // parity of current block
     int i = 0; // the current vertex
-    int blockstart = 0; // first vertex of the current block
+    while (i < nodecount() and disabled[i]) i++; // restarts go back to blockstart, so it must be enabled
+    int cur_parity = i < nodecount() ? parity[i] : 0; // parity of current block
+    int blockstart = i; // first vertex of the current block
 
     for (;;) {
         /**
@@ -352,12 +354,217 @@ FPJSolver::runSeq()
     delete[] strategy;
 
     logger << "solved with " << iterations << " iterations." << std::endl;
+    stats.count("iterations", iterations);
+}
+
+/**
+ * Compute the one step winner of <v> and update its strategy.
+ * Returns true if <v> is now a distraction.
+ */
+bool
+FPJSolver::evaluate(int v)
+{
+    int onestep_winner, str = -1;
+    if (owner(v) == 0) {
+        // see if player Even can go to a vertex currently good for Even
+        onestep_winner = 1;
+        for (auto curedge = outs(v); *curedge != -1; curedge++) {
+            int to = *curedge;
+            if (disabled[to]) continue;
+            if ((parity[to] ^ distraction[to]) == 0) {
+                onestep_winner = 0;
+                str = to;
+                break;
+            }
+        }
+    } else {
+        // see if player Odd can go to a vertex currently good for Odd
+        onestep_winner = 0;
+        for (auto curedge = outs(v); *curedge != -1; curedge++) {
+            int to = *curedge;
+            if (disabled[to]) continue;
+            if ((parity[to] ^ distraction[to]) == 1) {
+                onestep_winner = 1;
+                str = to;
+                break;
+            }
+        }
+    }
+    strategy[v] = str;
+    return parity[v] != onestep_winner;
+}
+
+/**
+ * Evaluate the unjustified vertices i..i+n-1 of the current block.
+ * Distractions only change between blocks, so all vertices of a block can be evaluated in parallel.
+ */
+VOID_TASK_3(fpj_block_rec, FPJSolver*, s, int, i, int, n)
+{
+    if (n > 128) {
+        SPAWN(fpj_block_rec, s, i+n/2, n-n/2);
+        CALL(fpj_block_rec, s, i, n/2);
+        SYNC(fpj_block_rec);
+        return;
+    }
+    for (int v=i; v<i+n; v++) {
+        if (s->disabled[v] or s->justified.atomic_test(v)) continue;
+        if (s->greedy) s->justified.atomic_set(v);
+        if (s->evaluate(v)) s->queue[__atomic_fetch_add(&s->queue_size, 1, __ATOMIC_RELAXED)] = v;
+    }
+}
+
+/**
+ * Justify the unjustified vertices i..i+n-1, as the block has no distractions.
+ */
+VOID_TASK_3(fpj_justify_rec, FPJSolver*, s, int, i, int, n)
+{
+    if (n > 1024) {
+        SPAWN(fpj_justify_rec, s, i+n/2, n-n/2);
+        CALL(fpj_justify_rec, s, i, n/2);
+        SYNC(fpj_justify_rec);
+        return;
+    }
+    // a word at a time, only the words at the boundaries are shared with other tasks
+    const int end = i+n;
+    while (i < end) {
+        const int bits = 64 - (i&63) < end - i ? 64 - (i&63) : end - i;
+        const uint64_t mask = (bits == 64 ? ~uint64_t(0) : ((uint64_t(1) << bits) - 1)) << (i&63);
+        s->justified.atomic_set_block(i/64, mask & ~s->disabled.atomic_block(i/64));
+        i += bits;
+    }
+}
+
+/**
+ * Mark the distractions queue[i..i+n-1] as distraction (and justified).
+ */
+VOID_TASK_3(fpj_mark_rec, FPJSolver*, s, int, i, int, n)
+{
+    if (n > 1024) {
+        SPAWN(fpj_mark_rec, s, i+n/2, n-n/2);
+        CALL(fpj_mark_rec, s, i, n/2);
+        SYNC(fpj_mark_rec);
+        return;
+    }
+    for (int k=i; k<i+n; k++) {
+        const int v = s->queue[k];
+        s->justified.atomic_set(v);
+        s->distraction.atomic_set(v);
+    }
+}
+
+/**
+ * Reset the justified predecessors of queue[i..i+n-1] that depend on them, and add them to <next>.
+ * A vertex is reset only once, by the task that clears its justified bit.
+ */
+VOID_TASK_3(fpj_reset_rec, FPJSolver*, s, int, i, int, n)
+{
+    if (n > 64) {
+        SPAWN(fpj_reset_rec, s, i+n/2, n-n/2);
+        CALL(fpj_reset_rec, s, i, n/2);
+        SYNC(fpj_reset_rec);
+        return;
+    }
+    for (int k=i; k<i+n; k++) {
+        const int v = s->queue[k];
+        for (auto curedge = s->ins(v); *curedge != -1; curedge++) {
+            const int from = *curedge;
+            if (s->strategy[from] != -1 and s->strategy[from] != v) continue;
+            if (!s->justified.atomic_test(from) or !s->justified.atomic_reset(from)) continue;
+            s->distraction.atomic_reset(from);
+            s->next[__atomic_fetch_add(&s->next_size, 1, __ATOMIC_RELAXED)] = from;
+            int cur = __atomic_load_n(&s->restart, __ATOMIC_RELAXED);
+            while (from < cur and !__atomic_compare_exchange_n(&s->restart, &cur, from, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) { }
+        }
+    }
+}
+
+VOID_TASK_1(fpj_run_par, FPJSolver*, s)
+{
+    const int n = s->nodecount();
+    int i = 0;
+    while (i < n) {
+        if (s->disabled[i]) { i++; continue; }
+
+        // the block runs from <i> until the next vertex of the other parity
+        const int end = s->runend[i];
+        s->queue_size = 0;
+        CALL(fpj_block_rec, s, i, end-i);
+
+        if (s->queue_size == 0) {
+            // the current strategy of all unjustified vertices of the block is justified
+            if (!s->greedy) CALL(fpj_justify_rec, s, i, end-i);
+            i = end;
+            continue;
+        }
+
+        // set the distractions, then reset all justified vertices that are no longer justified
+        CALL(fpj_mark_rec, s, 0, s->queue_size);
+        s->restart = end;
+        while (s->queue_size != 0) {
+            s->next_size = 0;
+            CALL(fpj_reset_rec, s, 0, s->queue_size);
+            std::swap(s->queue, s->next);
+            s->queue_size = s->next_size;
+        }
+#ifndef NDEBUG
+        if (s->trace) s->logger << "restarting after finding distractions of prio " << s->priority(end-1) << std::endl;
+#endif
+        s->iterations++;
+
+        // afterwards, continue at the lowest unjustified vertex
+        if (s->greedy) i = s->restart;
+        else i = s->restart < i ? s->restart : i;
+    }
+}
+
+/**
+ * Parallel variant of runSeq and runSeqGreedy, with the same blocks and the same iterations.
+ */
+void
+FPJSolver::runPar()
+{
+    strategy = new int[nodecount()];
+    runend = new int[nodecount()];
+    queue = new int[nodecount()];
+    next = new int[nodecount()];
+    parity.resize(nodecount());
+    justified.resize(nodecount());
+    distraction.resize(nodecount());
+
+    // compute the parities and the end of the run of every vertex, skipping disabled vertices
+    const int n = nodecount();
+    int first[2] = { n, n };
+    for (int v=nodecount()-1; v>=0; v--) {
+        const int p = priority(v)&1;
+        parity[v] = p;
+        runend[v] = first[1-p];
+        if (!disabled[v]) first[p] = v;
+    }
+
+    RUN(fpj_run_par, this);
+
+    // done
+    for (int v=0; v<nodecount(); v++) {
+        if (disabled[v]) continue;
+        const int winner = parity[v] ^ distraction[v];
+        oink->solve(v, winner, winner == owner(v) ? strategy[v] : -1);
+    }
+
+    // free allocated data structures
+    delete[] strategy;
+    delete[] runend;
+    delete[] queue;
+    delete[] next;
+
+    logger << "solved with " << iterations << " iterations." << std::endl;
+    stats.count("iterations", iterations);
 }
 
 void
 FPJSolver::run()
 {
-    if (greedy) runSeqGreedy();
+    if (lace_workers() != 0) runPar();
+    else if (greedy) runSeqGreedy();
     else runSeq();
 }
 
@@ -33,6 +33,21 @@ public:
 
     void runSeqGreedy(void);
     void runSeq(void);
+    void runPar(void);
+
+    // state of the parallel solver, shared with the Lace tasks
+    int *strategy;
+    int *runend;        // for every vertex, the first vertex after it of the other parity (or nodecount)
+    bitset parity;
+    bitset justified;
+    bitset distraction;
+    int *queue;         // distractions of the current block, then the vertices reset in the last round
+    int *next;          // the vertices reset in the current round
+    unsigned queue_size;
+    unsigned next_size;
+    int restart;        // the lowest vertex that was reset
+
+    bool evaluate(int v);
 
     virtual void run();
 };
@@ -21,6 +21,9 @@
 #include <ctime>
 
 #include "game.hpp"
+#include "mempolicy.hpp"
+#include "phases.hpp"
+#include "subgame.hpp"
 
 #define USE_MMAP 1
 
@@ -29,19 +32,19 @@ using namespace std;
 namespace pg
 {
 
-    Game::Game() : _owner(0), solved(0), winner(0)
+    Game::Game() : _meta(0), solved(0), winner(0)
     {
         n_vertices = 0;
         n_edges = 0;
+        _prio16 = NULL;
         _priority = NULL;
-        _label = NULL;
+        _labelidx = NULL;
         _outvec = NULL;
         _outedges = NULL;
         _firstouts = NULL;
-        _outcount = NULL;
         _inedges = NULL;
         _firstins = NULL;
-        _incount = NULL;
+        i_size = 0;
         is_ordered = true;
         v_allocated = 0;
         e_allocated = 0;
@@ -52,18 +55,12 @@ namespace pg
 
     Game::~Game()
     {
-        for (int i = 0; i < n_vertices; i++)
-        {
-            if (_label[i])
-                delete _label[i];
-        }
-
-        free(_priority);
-        free(_label);
-        free(strategy);
-        free(_firstouts);
-        free(_outcount);
-        free(_outedges);
+        mem_free(_prio16, sizeof(uint16_t[v_allocated]));
+        mem_free(_priority, sizeof(int[v_allocated]));
+        free(_labelidx);
+        mem_free(strategy, sizeof(int[v_allocated]));
+        mem_free(_firstouts, sizeof(int[v_allocated]));
+        mem_free(_outedges, sizeof(int[e_allocated]));
 
         if (_outvec != NULL)
         {
@@ -72,13 +69,12 @@ namespace pg
 
         if (_inedges != NULL)
         {
-            delete[] _inedges;
-            delete[] _firstins;
-            delete[] _incount;
+            mem_free(_inedges, sizeof(int[i_size]));
+            mem_free(_firstins, sizeof(int[v_allocated]));
         }
     }
 
-    Game::Game(int vcount, int ecount) : _owner(vcount), solved(vcount), winner(vcount)
+    Game::Game(int vcount, int ecount) : _meta(2 * vcount), solved(vcount), winner(vcount)
     {
         assert(vcount > 0);
         if (ecount == -1)
@@ -91,34 +87,33 @@ namespace pg
         e_allocated = vcount + ecount + 1; // extra space for -1
         e_size = 0;
 
-        _priority = (int *)malloc(sizeof(int[v_allocated]));
-        _label = (string **)calloc(sizeof(string *), v_allocated);
-        strategy = (int *)malloc(sizeof(int[v_allocated]));
-        _firstouts = (int *)malloc(sizeof(int[v_allocated]));
-        _outcount = (int *)malloc(sizeof(int[v_allocated]));
-        _outedges = (int *)malloc(sizeof(int[e_allocated]));
-        if (_priority == (int *)0)
-            abort();
-        if (_label == (string **)0)
+        _prio16 = (uint16_t *)mem_alloc(sizeof(uint16_t[v_allocated]));
+        strategy = (int *)mem_alloc(sizeof(int[v_allocated]));
+        _firstouts = (int *)mem_alloc(sizeof(int[v_allocated]));
+        _outedges = (int *)mem_alloc(sizeof(int[e_allocated]));
+        if (_prio16 == (uint16_t *)0)
             abort();
         if (strategy == (int *)0)
             abort();
         if (_firstouts == (int *)0)
             abort();
-        if (_outcount == (int *)0)
-            abort();
         if (_outedges == (int *)0)
             abort();
 
+        _priority = NULL;
+        _labelidx = NULL;
         _outvec = NULL;
         _inedges = NULL;
         _firstins = NULL;
-        _incount = NULL;
+        i_size = 0;
         is_ordered = true;
 
         _outedges[0] = -1;
         e_size++;
 
+        // all vertices start without successors (the empty list at 0), e.g. for vec_init
+        std::fill(_firstouts, _firstouts + vcount, 0);
+
         std::fill(strategy, strategy + vcount, '\xff');
 
         set_random_seed(static_cast<unsigned int>(std::time(0)));
@@ -133,30 +128,40 @@ namespace pg
     {
         n_edges = other.n_edges;
 
-        memcpy(_priority, other._priority, sizeof(int[n_vertices]));
-        _owner = other._owner;
-        for (int i = 0; i < n_vertices; i++)
+        if (other._priority != NULL)
         {
-            if (other._label[i])
-                _label[i] = new std::string(*other._label[i]);
+            widen_priorities();
+            memcpy(_priority, other._priority, sizeof(int[n_vertices]));
+        }
+        else
+        {
+            memcpy(_prio16, other._prio16, sizeof(uint16_t[n_vertices]));
+        }
+        _meta = other._meta;
+        if (other._labelidx != NULL)
+        {
+            _labelpool = other._labelpool;
+            _labelidx = (uint32_t *)malloc(sizeof(uint32_t[v_allocated]));
+            if (_labelidx == (uint32_t *)0)
+                abort();
+            memcpy(_labelidx, other._labelidx, sizeof(uint32_t[n_vertices]));
         }
 
         // clone the edge out ARRAY
         e_size = other.e_size;
-        memcpy(_outedges, other._outedges, sizeof(int[e_size]));
-        memcpy(_firstouts, other._firstouts, sizeof(int[n_vertices]));
-        memcpy(_outcount, other._outcount, sizeof(int[n_vertices]));
+        mem_copy(_outedges, other._outedges, sizeof(int[e_size]));
+        mem_copy(_firstouts, other._firstouts, sizeof(int[n_vertices]));
 
         // copy inedges
         if (other._inedges != NULL)
         {
-            size_t len = n_vertices + n_edges;
-            _inedges = new int[len];
-            _firstins = new int[n_vertices];
-            _incount = new int[n_vertices];
-            memcpy(_inedges, other._inedges, sizeof(int[len]));
-            memcpy(_firstins, other._firstins, sizeof(int[n_vertices]));
-            memcpy(_incount, other._incount, sizeof(int[n_vertices]));
+            i_size = other.i_size;
+            _inedges = (int *)mem_alloc(sizeof(int[i_size]));
+            _firstins = (int *)mem_alloc(sizeof(int[v_allocated]));
+            if (_inedges == (int *)0 or _firstins == (int *)0)
+                abort();
+            mem_copy(_inedges, other._inedges, sizeof(int[i_size]));
+            mem_copy(_firstins, other._firstins, sizeof(int[n_vertices]));
         }
 
         is_ordered = other.is_ordered;
@@ -299,38 +304,85 @@ namespace pg
             v_sizeup();
         set_priority(v, priority);
         set_owner(v, owner);
-        this->_label[v] = 0; // just ensure that it's properly zeroed before use
         set_label(v, label);
     }
 
     void
     Game::set_priority(int node, int priority)
     {
-        _priority[node] = priority;
+        put_priority(node, priority);
         if (is_ordered)
         {
-            if (node > 0 and _priority[node - 1] > _priority[node])
+            if (node > 0 and this->priority(node - 1) > priority)
                 is_ordered = false;
             // just assume we get vertices in-order...
             // else if (node < (n_vertices-1) and _priority[node] > _priority[node+1]) is_ordered = false;
         }
     }
 
+    void
+    Game::put_priority(int node, int priority)
+    {
+        if (_priority == NULL)
+        {
+            if (priority >= 0 and priority <= UINT16_MAX)
+                _prio16[node] = priority;
+            else
+            {
+                widen_priorities();
+                _priority[node] = priority;
+            }
+        }
+        else
+        {
+            _priority[node] = priority;
+        }
+        _meta[2 * node + 1] = priority & 1;
+    }
+
+    void
+    Game::widen_priorities(void)
+    {
+        if (_priority != NULL)
+            return;
+        _priority = (int *)mem_alloc(sizeof(int[v_allocated]));
+        if (_priority == (int *)0)
+            abort();
+        std::copy(_prio16, _prio16 + n_vertices, _priority);
+        mem_free(_prio16, sizeof(uint16_t[v_allocated]));
+        _prio16 = NULL;
+    }
+
     void
     Game::set_owner(int node, int owner)
     {
-        this->_owner[node] = owner ? 1 : 0;
+        _meta[2 * node] = owner ? 1 : 0;
     }
 
+    /**
+     * Labels are appended to the pool; a replaced label keeps its space in the pool.
+     */
     void
     Game::set_label(int node, std::string label)
     {
-        if (this->_label[node])
-            delete this->_label[node];
-        if (label != "")
-            this->_label[node] = new std::string(label);
-        else
-            this->_label[node] = 0;
+        if (label == "")
+        {
+            if (_labelidx != NULL)
+                _labelidx[node] = 0;
+            return;
+        }
+        if (_labelidx == NULL)
+        {
+            _labelidx = (uint32_t *)calloc(sizeof(uint32_t), v_allocated);
+            if (_labelidx == (uint32_t *)0)
+                abort();
+            _labelpool.assign(1, '\0'); // offset 0 is no label
+        }
+        if (_labelpool.size() + label.size() >= UINT32_MAX)
+            throw "too many labels";
+        _labelidx[node] = _labelpool.size();
+        _labelpool.append(label);
+        _labelpool.push_back('\0');
     }
 
     /**
@@ -431,6 +483,7 @@ namespace pg
     void
     Game::parse_pgsolver(std::istream &inp, bool removeBadLoops)
     {
+        OINK_PHASE("parse_pgsolver");
         std::streambuf *rd = inp.rdbuf();
 
         char buf[64];
@@ -510,7 +563,7 @@ namespace pg
                 throw "missing priority";
             if (n > INT_MAX)
                 throw "priority too high"; // don't be ridiculous
-            _priority[id] = n;
+            put_priority(id, n);
 
             skip_whitespace(rd);
             if (!read_uint64(rd, &n))
@@ -521,14 +574,13 @@ namespace pg
             }
             else if (n == 1)
             {
-                _owner[id] = true;
+                _meta[2 * id] = true;
             }
             else
             {
                 throw "invalid owner";
             }
 
-            _label[id] = 0;
             e_start(id);
 
             bool has_self = false;
@@ -546,7 +598,7 @@ namespace pg
                     throw "invalid successor";
                 }
 
-                if (id == n and removeBadLoops and (_owner[id] != (_priority[id] & 1)))
+                if (id == n and removeBadLoops and owner(id) != parity(id))
                 {
                     has_self = true;
                 }
@@ -567,14 +619,15 @@ namespace pg
                     break; // end of line
                 if (ch == '\"')
                 {
-                    _label[id] = new std::string();
+                    std::string label;
                     while (true)
                     {
                         inp >> ch;
                         if (ch == '\"')
                             break;
-                        *_label[id] += ch;
+                        label += ch;
                     }
+                    set_label(id, label);
                     // now read ;
                     skip_whitespace(rd);
                     if (!(inp >> ch) or ch != ';')
@@ -602,7 +655,7 @@ namespace pg
         is_ordered = true;
         for (int i = 1; i < n_vertices; i++)
         {
-            if (_priority[i - 1] > _priority[i])
+            if (priority(i - 1) > priority(i))
             {
                 is_ordered = false;
                 break;
@@ -652,7 +705,7 @@ namespace pg
             winner[ident] = w;
 
             // parse strategy
-            if (w == _owner[ident])
+            if (w == owner(ident))
             {
                 int str;
                 if (!(ss >> str))
@@ -687,8 +740,9 @@ namespace pg
                     os << ",";
                 os << *curedge;
             }
-            if (_label[i] != 0 and !_label[i]->empty())
-                os << " \"" << *_label[i] << "\"";
+            const char *label = rawlabel(i);
+            if (label != NULL)
+                os << " \"" << label << "\"";
             os << ";" << std::endl;
         }
     }
@@ -724,7 +778,7 @@ namespace pg
             if (solved[i])
             {
                 out << i << " " << (winner[i] ? "1" : "0");
-                if (winner[i] == _owner[i] and strategy[i] != -1)
+                if (winner[i] == owner(i) and strategy[i] != -1)
                     out << " " << strategy[i];
                 out << ";" << std::endl;
             }
@@ -779,6 +833,129 @@ namespace pg
         }
     }
 
+    /**
+     * Sort all vertices by priority, then by Reverse Cuthill-McKee order.
+     */
+    void
+    Game::sort_locality(int *mapping)
+    {
+        OINK_PHASE("sort_locality");
+
+        // the edges in both directions, without self-loops
+        std::vector<int> first(n_vertices + 1, 0);
+        for (int v = 0; v < n_vertices; v++)
+        {
+            for (auto curedge = outs(v); *curedge != -1; curedge++)
+            {
+                if (*curedge == v)
+                    continue;
+                first[v + 1]++;
+                first[*curedge + 1]++;
+            }
+        }
+        for (int v = 0; v < n_vertices; v++)
+            first[v + 1] += first[v];
+        std::vector<int> adj(first[n_vertices]);
+        {
+            std::vector<int> pos(first.begin(), first.end() - 1);
+            for (int v = 0; v < n_vertices; v++)
+            {
+                for (auto curedge = outs(v); *curedge != -1; curedge++)
+                {
+                    if (*curedge == v)
+                        continue;
+                    adj[pos[v]++] = *curedge;
+                    adj[pos[*curedge]++] = v;
+                }
+            }
+        }
+        auto degree = [&](int v) { return first[v + 1] - first[v]; };
+        auto by_degree = [&](int a, int b) { return degree(a) != degree(b) ? degree(a) < degree(b) : a < b; };
+
+        // Cuthill-McKee: breadth-first from a vertex of minimal degree, neighbours by degree
+        std::vector<int> order, start(n_vertices);
+        order.reserve(n_vertices);
+        std::vector<char> seen(n_vertices, 0);
+        for (int v = 0; v < n_vertices; v++)
+            start[v] = v;
+        std::sort(start.begin(), start.end(), by_degree);
+        for (int s : start)
+        {
+            if (seen[s])
+                continue;
+            seen[s] = 1;
+            order.push_back(s);
+            for (size_t head = order.size() - 1; head < order.size(); head++)
+            {
+                const int v = order[head];
+                const size_t begin = order.size();
+                for (int k = first[v]; k < first[v + 1]; k++)
+                {
+                    if (!seen[adj[k]])
+                    {
+                        seen[adj[k]] = 1;
+                        order.push_back(adj[k]);
+                    }
+                }
+                std::sort(order.begin() + begin, order.end(), by_degree);
+            }
+        }
+
+        // the reversed order, within each priority
+        std::vector<int> rank(n_vertices);
+        for (int i = 0; i < n_vertices; i++)
+            rank[order[i]] = n_vertices - 1 - i;
+
+        int *sorted = mapping != NULL ? mapping : new int[n_vertices];
+        for (int i = 0; i < n_vertices; i++)
+            sorted[i] = i;
+        std::sort(sorted, sorted + n_vertices, [&](const int &a, const int &b)
+                  {
+                      const unsigned int pa = priority(a), pb = priority(b);
+                      return pa != pb ? pa < pb : rank[a] < rank[b];
+                  });
+
+        int *inverse = new int[n_vertices];
+        for (int i = 0; i < n_vertices; i++)
+            inverse[sorted[i]] = i;
+        unsafe_permute(inverse);
+        delete[] inverse;
+        if (mapping == NULL)
+            delete[] sorted;
+        is_ordered = true;
+
+        relayout_edges();
+    }
+
+    /**
+     * Rewrite the edge arrays in vertex order, with sorted successors.
+     * A permutation only swaps the offsets of the vertices, so without this, the successors
+     * of consecutive vertices can be anywhere in the edge array.
+     */
+    void
+    Game::relayout_edges(void)
+    {
+        int *edges = (int *)mem_alloc(sizeof(int[e_allocated]));
+        if (edges == (int *)0)
+            abort();
+        int pos = 0;
+        for (int v = 0; v < n_vertices; v++)
+        {
+            const int first = pos;
+            for (auto curedge = outs(v); *curedge != -1; curedge++)
+                edges[pos++] = *curedge;
+            std::sort(edges + first, edges + pos);
+            _firstouts[v] = first;
+            edges[pos++] = -1;
+        }
+        mem_free(_outedges, sizeof(int[e_allocated]));
+        _outedges = edges;
+        e_size = pos;
+
+        if (_inedges != NULL)
+            build_in_array(true);
+    }
+
     /**
      * The "safe" permute: apply the mapping, then update is_ordered.
      */
@@ -791,7 +968,7 @@ namespace pg
         is_ordered = true;
         for (int i = 1; i < n_vertices; i++)
         {
-            if (_priority[i - 1] > _priority[i])
+            if (priority(i - 1) > priority(i))
             {
                 is_ordered = false;
                 break;
@@ -835,22 +1012,24 @@ namespace pg
                 mapping[i] = mapping[k];
                 mapping[k] = k;
                 // swap i and k
-                std::swap(_priority[i], _priority[k]);
+                if (_priority != NULL)
+                    std::swap(_priority[i], _priority[k]);
+                else
+                    std::swap(_prio16[i], _prio16[k]);
+                for (int b = 0; b < 2; b++)
                 {
-                    bool b = _owner[k];
-                    _owner[k] = _owner[i];
-                    _owner[i] = b;
+                    // owner and parity
+                    bool x = _meta[2 * k + b];
+                    _meta[2 * k + b] = _meta[2 * i + b];
+                    _meta[2 * i + b] = x;
                 }
-                std::swap(_label[i], _label[k]);
+                if (_labelidx != NULL)
+                    std::swap(_labelidx[i], _labelidx[k]);
                 // swap out array
                 std::swap(_firstouts[i], _firstouts[k]);
-                std::swap(_outcount[i], _outcount[k]);
                 // swap in array
                 if (_inedges != NULL)
-                {
                     std::swap(_firstins[i], _firstins[k]);
-                    std::swap(_incount[i], _incount[k]);
-                }
                 // swap solution
                 {
                     bool b = solved[k];
@@ -880,7 +1059,7 @@ namespace pg
         int prio = -1;
         for (int i = 0; i < n_vertices; i++)
         {
-            const int p_mod_i = _priority[i] & 1;
+            const int p_mod_i = parity(i);
             if (prio == -1)
                 prio = p_mod_i;
             else if (p_mod_i != prio % 2)
@@ -893,7 +1072,7 @@ namespace pg
                 prio += 2;
                 d++;
             }
-            _priority[i] = prio;
+            put_priority(i, prio);
         }
 
         return d;
@@ -912,7 +1091,7 @@ namespace pg
         int prio = -1;
         for (int i = 0; i < n_vertices; i++)
         {
-            const int p_mod_i = _priority[i] & 1;
+            const int p_mod_i = parity(i);
             if (prio == -1)
                 prio = p_mod_i;
             else if (p_mod_i != prio % 2)
@@ -920,7 +1099,7 @@ namespace pg
                 prio += 1;
                 d++;
             }
-            _priority[i] = prio;
+            put_priority(i, prio);
         }
 
         return d;
@@ -939,7 +1118,7 @@ namespace pg
         int prio = -1, last = -1;
         for (int i = 0; i < n_vertices; i++)
         {
-            const int p_mod_i = _priority[i] & 1;
+            const int p_mod_i = parity(i);
             if (prio == -1)
                 prio = p_mod_i;
             else if (p_mod_i != prio % 2)
@@ -947,13 +1126,13 @@ namespace pg
                 prio += 1;
                 d++;
             }
-            else if (last != _priority[i])
+            else if (last != priority(i))
             {
                 prio += 2;
                 d++;
             }
-            last = _priority[i];
-            _priority[i] = prio;
+            last = priority(i);
+            put_priority(i, prio);
         }
 
         return d;
@@ -968,8 +1147,8 @@ namespace pg
         int prio = -1, last = -1;
         for (int i = 0; i < n_vertices; i++)
         {
-            const int d = _priority[i] + 1;
-            _owner[i] = 1 - _owner[i];
+            const int d = priority(i) + 1;
+            _meta[2 * i] = !owner(i);
 
             const int p_mod_i = d & 1;
             if (prio == -1)
@@ -979,7 +1158,7 @@ namespace pg
             else if (last != d)
                 prio += 2;
             last = d;
-            _priority[i] = prio;
+            put_priority(i, prio);
         }
     }
 
@@ -992,110 +1171,28 @@ namespace pg
         int prio = -1, last = -1;
         for (int i = n_vertices - 1; i >= 0; i--)
         {
-            const int p_mod_i = _priority[i] & 1;
+            const int p_mod_i = parity(i);
             if (prio == -1)
                 prio = p_mod_i;
             else if (p_mod_i != prio % 2)
                 prio += 1;
-            else if (last != _priority[i])
+            else if (last != priority(i))
                 prio += 2;
-            last = _priority[i];
-            _priority[i] = prio;
+            last = priority(i);
+            put_priority(i, prio);
         }
     }
 
     Game *
     Game::extract_subgame(std::vector<int> &selection)
     {
-        // translate to a bitmask
-        bitset sel(n_vertices);
-        for (int i : selection)
-            sel[i] = true;
-        return extract_subgame(sel);
+        return SubgameView(*this, selection).materialize();
     }
 
     Game *
     Game::extract_subgame(bitset mask)
     {
-        // check if there are any dead ends (not allowed)
-        // also count the number of edges in the subgame
-
-        int nv = mask.count();
-        int ne = 0;
-        for (int v = 0; v < n_vertices; v++)
-        {
-            if (mask[v])
-            {
-                bool bad = true;
-                for (auto curedge = outs(v); *curedge != -1; curedge++)
-                {
-                    if (mask[*curedge])
-                    {
-                        bad = false;
-                        ne++;
-                    }
-                }
-                if (bad)
-                {
-                    std::cerr << "no successor for vertex " << label_vertex(v) << " in extract_subgame!" << std::endl;
-                    std::cerr << "successors not in subgame:";
-                    for (auto curedge = outs(v); *curedge != -1; curedge++)
-                    {
-                        std::cerr << " " << label_vertex(*curedge);
-                    }
-                    std::cerr << std::endl;
-                    abort(); // bad!
-                }
-            }
-        }
-
-        Game *res = new Game(nv, ne);
-
-        // create mapping from game to subgame
-        // our v is their invmap[v]
-        // their w is our mapping[w]
-        // also count the number of vertices in the subgame
-        int *mapping = new int[n_vertices];
-        int *invmap = new int[nv];
-
-        int vertices = 0;
-        for (int v = 0; v < n_vertices; v++)
-        {
-            if (!mask[v])
-                continue;
-
-            // update mapping and invmapping
-            int w = vertices++;
-            invmap[w] = v;
-            mapping[v] = w;
-
-            // initialize most stuff (except edges)
-            if (_label[v] != 0)
-                res->init_vertex(w, _priority[v], _owner[v], *_label[v]);
-            else
-                res->init_vertex(w, _priority[v], _owner[v], "");
-        }
-
-        // now add all edges
-
-        for (int w = 0; w < nv; w++)
-        {
-            int v = invmap[w];
-            res->e_start(w);
-            for (auto curedge = outs(v); *curedge != -1; curedge++)
-            {
-                if (mask[*curedge])
-                    res->e_add(w, mapping[*curedge]);
-            }
-            res->e_finish();
-        }
-
-        delete[] mapping;
-        delete[] invmap;
-
-        // TODO: fix is_ordered?
-
-        return res;
+        return SubgameView(*this, mask).materialize();
     }
 
     Game &
@@ -1111,16 +1208,17 @@ namespace pg
     {
         std::swap(n_vertices, other.n_vertices);
         std::swap(n_edges, other.n_edges);
+        std::swap(_prio16, other._prio16);
         std::swap(_priority, other._priority);
-        std::swap(_owner, other._owner);
-        std::swap(_label, other._label);
+        std::swap(_meta, other._meta);
+        std::swap(_labelpool, other._labelpool);
+        std::swap(_labelidx, other._labelidx);
         std::swap(_outvec, other._outvec);
         std::swap(_outedges, other._outedges);
         std::swap(_firstouts, other._firstouts);
-        std::swap(_outcount, other._outcount);
         std::swap(_inedges, other._inedges);
         std::swap(_firstins, other._firstins);
-        std::swap(_incount, other._incount);
+        std::swap(i_size, other.i_size);
         std::swap(solved, other.solved);
         std::swap(winner, other.winner);
         std::swap(strategy, other.strategy);
@@ -1149,8 +1247,9 @@ namespace pg
     void
     Game::e_sizeup(void)
     {
+        const size_t old_allocated = e_allocated;
         e_allocated += e_allocated / 2;
-        _outedges = (int *)realloc(_outedges, sizeof(int[e_allocated]));
+        _outedges = (int *)mem_realloc(_outedges, sizeof(int[old_allocated]), sizeof(int[e_allocated]));
         if (_outedges == NULL)
             abort();
     }
@@ -1158,24 +1257,35 @@ namespace pg
     void
     Game::v_sizeup(void)
     {
+        const size_t old_allocated = v_allocated;
         v_allocated += v_allocated / 2;
         n_vertices = v_allocated;
-        _priority = (int *)realloc(_priority, sizeof(int[v_allocated]));
-        strategy = (int *)realloc(strategy, sizeof(int[v_allocated]));
-        _firstouts = (int *)realloc(_firstouts, sizeof(int[v_allocated]));
-        _outcount = (int *)realloc(_outcount, sizeof(int[v_allocated]));
-        _label = (string **)realloc(_label, sizeof(string *[v_allocated]));
-        if (_priority == (int *)0)
-            abort();
+        if (_priority != NULL)
+        {
+            _priority = (int *)mem_realloc(_priority, sizeof(int[old_allocated]), sizeof(int[v_allocated]));
+            if (_priority == (int *)0)
+                abort();
+        }
+        else
+        {
+            _prio16 = (uint16_t *)mem_realloc(_prio16, sizeof(uint16_t[old_allocated]), sizeof(uint16_t[v_allocated]));
+            if (_prio16 == (uint16_t *)0)
+                abort();
+        }
+        strategy = (int *)mem_realloc(strategy, sizeof(int[old_allocated]), sizeof(int[v_allocated]));
+        _firstouts = (int *)mem_realloc(_firstouts, sizeof(int[old_allocated]), sizeof(int[v_allocated]));
         if (strategy == (int *)0)
             abort();
         if (_firstouts == (int *)0)
             abort();
-        if (_outcount == (int *)0)
-            abort();
-        if (_label == (string **)0)
-            abort();
-        _owner.resize(v_allocated);
+        if (_labelidx != NULL)
+        {
+            _labelidx = (uint32_t *)realloc(_labelidx, sizeof(uint32_t[v_allocated]));
+            if (_labelidx == (uint32_t *)0)
+                abort();
+            std::fill(_labelidx + old_allocated, _labelidx + v_allocated, 0);
+        }
+        _meta.resize(2 * v_allocated);
         solved.resize(v_allocated);
         winner.resize(v_allocated);
     }
@@ -1186,7 +1296,7 @@ namespace pg
         while (newsize > v_allocated)
             v_sizeup();
         n_vertices = newsize;
-        _owner.resize(n_vertices);
+        _meta.resize(2 * n_vertices);
         solved.resize(n_vertices);
         winner.resize(n_vertices);
     }
@@ -1195,16 +1305,15 @@ namespace pg
     Game::e_start(int source)
     {
         _firstouts[source] = e_size;
-        _outcount[source] = 0;
     }
 
     void
     Game::e_add(int source, int target)
     {
+        (void)source; // the successors of <source> end at the -1 of e_finish
         if (e_size == e_allocated)
             e_sizeup();
         _outedges[e_size++] = target;
-        _outcount[source] += 1;
         n_edges++;
     }
 
@@ -1216,16 +1325,57 @@ namespace pg
         _outedges[e_size++] = -1;
     }
 
+    void
+    Game::init_csr(int count, const int *outcount, int maxprio)
+    {
+        long total = 0;
+        for (int v = 0; v < count; v++)
+            total += outcount[v];
+        if (total + count >= INT32_MAX)
+            throw "too many edges";
+
+        Game g(count, total);
+        swap(g);
+        if (maxprio > UINT16_MAX)
+            widen_priorities(); // before the vertices are filled in parallel
+
+        e_size = 0;
+        for (int v = 0; v < count; v++)
+        {
+            _firstouts[v] = e_size;
+            e_size += outcount[v];
+            _outedges[e_size++] = -1;
+        }
+        n_edges = total;
+
+        // vertices may be filled in any order, so set_priority does not track the order
+        is_ordered = false;
+    }
+
+    void
+    Game::csr_finish(void)
+    {
+        is_ordered = true;
+        for (int v = 1; v < n_vertices; v++)
+        {
+            if (priority(v - 1) > priority(v))
+            {
+                is_ordered = false;
+                break;
+            }
+        }
+    }
+
     void
     Game::build_in_array(bool rebuild)
     {
+        OINK_PHASE("build_in_array");
         if (_inedges != NULL)
         {
             if (rebuild)
             {
-                delete[] _inedges;
-                delete[] _firstins;
-                delete[] _incount;
+                mem_free(_inedges, sizeof(int[i_size]));
+                mem_free(_firstins, sizeof(int[v_allocated]));
             }
             else
             {
@@ -1233,28 +1383,31 @@ namespace pg
             }
         }
 
-        _inedges = new int[e_size];
-        _firstins = new int[n_vertices];
-        _incount = new int[n_vertices];
+        i_size = n_vertices + n_edges;
+        _inedges = (int *)mem_alloc(sizeof(int[i_size]));
+        _firstins = (int *)mem_alloc(sizeof(int[v_allocated]));
+        if (_inedges == (int *)0 or _firstins == (int *)0)
+            abort();
 
-        // set incount of each vertex
+        // set incount of each vertex (in _firstins, which is overwritten below)
 
-        memset(_incount, 0, sizeof(int[n_vertices]));
+        memset(_firstins, 0, sizeof(int[n_vertices]));
         for (int v = 0; v < n_vertices; v++)
         {
             for (auto curedge = outs(v); *curedge != -1; curedge++)
             {
                 int to = *curedge;
-                _incount[to]++;
+                _firstins[to]++;
             }
         }
 
         unsigned long pos = 0;
         for (int v = 0; v < n_vertices; v++)
         {
-            _firstins[v] = pos + _incount[v]; // start at end!!
+            const int incount = _firstins[v];
+            _firstins[v] = pos + incount; // start at end!!
             _inedges[_firstins[v]] = -1;
-            pos += (_incount[v] + 1);
+            pos += (incount + 1);
         }
 
         for (int v = 0; v < n_vertices; v++)
@@ -1267,4 +1420,34 @@ namespace pg
         }
     }
 
-}
\ No newline at end of file
+    void
+    Game::place_arrays(void)
+    {
+        OINK_PHASE("place_arrays");
+        _outedges = (int *)mem_move(_outedges, sizeof(int[e_allocated]), sizeof(int[e_size]));
+        _firstouts = (int *)mem_move(_firstouts, sizeof(int[v_allocated]), sizeof(int[n_vertices]));
+        if (_inedges != NULL)
+        {
+            _inedges = (int *)mem_move(_inedges, sizeof(int[i_size]), sizeof(int[i_size]));
+            _firstins = (int *)mem_move(_firstins, sizeof(int[v_allocated]), sizeof(int[n_vertices]));
+        }
+        if (_priority != NULL)
+            _priority = (int *)mem_move(_priority, sizeof(int[v_allocated]), sizeof(int[n_vertices]));
+        else
+            _prio16 = (uint16_t *)mem_move(_prio16, sizeof(uint16_t[v_allocated]), sizeof(uint16_t[n_vertices]));
+        strategy = (int *)mem_move(strategy, sizeof(int[v_allocated]), sizeof(int[n_vertices]));
+        {
+            bitset b(_meta);
+            _meta.swap(b);
+        }
+        {
+            bitset b(solved);
+            solved.swap(b);
+        }
+        {
+            bitset b(winner);
+            winner.swap(b);
+        }
+    }
+
+}
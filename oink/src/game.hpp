@@ -18,7 +18,9 @@
 #define GAME_HPP
 
 #include <cassert>
+#include <cstdint>
 #include <sstream>
+#include <string>
 #include <vector>
 #include <map>
 #include <boost/random/mersenne_twister.hpp>
@@ -38,6 +40,14 @@ namespace pg
      * Edges are stored consecutively in a single array, ending with th evalue -1.
      * For game solving, the build_in_array method creates the reverse array.
      *
+     * The large arrays are allocated with mem_alloc, following the memory policy.
+     *
+     * Vertex data is kept compact, as our largest games have hundreds of millions of edges:
+     * - the successors of a vertex are found by its offset only; outcount() counts them
+     * - priorities are stored in 16 bits until a priority does not fit, then in 32 bits
+     * - the owner and the parity of the priority of a vertex are adjacent bits
+     * - labels are stored in a single pool, and not at all if no vertex has a label
+     *
      * There is a special vector representation of edges to allow for "random-order" modification
      * or game-building:
      * - vec_init() initializes the vectors with the current edges
@@ -59,6 +69,11 @@ namespace pg
      * - use e_finish to finish adding successors of the vertex
      * - use v_sizeup (or v_resize) to increase the number of vertices if needed
      * - use v_resize to set the final number of vertices
+     *
+     * Usage scenario for making a game (bulk, e.g. the parallel generators):
+     * - use init_csr with the number of successors of every vertex
+     * - use set_priority, set_owner and outslots to fill in each vertex
+     * - use csr_finish
      */
 
     class Game
@@ -177,6 +192,16 @@ namespace pg
          */
         void sort(int *mapping = NULL);
 
+        /**
+         * Sort the vertices in order of priority (low to high), and within each priority in
+         * Reverse Cuthill-McKee order of the edges (in both directions), so vertices that are
+         * connected get nearby numbers. Then lay out the edge arrays in vertex order with
+         * the successors of every vertex sorted, so attractors touch nearby memory.
+         * If <mapping> is given as an int array of size vertexcount(),
+         * then it can be used with permute to reverse the procedure (but not the edge order).
+         */
+        void sort_locality(int *mapping = NULL);
+
         /**
          * Ensure that vertices are ordered by priority.
          */
@@ -226,6 +251,13 @@ namespace pg
          */
         void build_in_array(bool rebuild = false);
 
+        /**
+         * Move the edge arrays, the vertex arrays and the solution to new memory, allocated
+         * with the current memory policy (see mempolicy.hpp), e.g., to spread them over
+         * the NUMA nodes before a parallel solver runs.
+         */
+        void place_arrays(void);
+
         /**
          * Dynamic size methods.
          */
@@ -240,6 +272,18 @@ namespace pg
         void e_add(int source, int target);
         void e_finish(void);
 
+        /**
+         * Bulk construction of the edge array.
+         * init_csr(count, outcount) initializes the game as Game(count), with room for
+         * outcount[v] successors of every vertex <v>, to be written to outslots(v).
+         * Ranges of vertices that start at multiples of 64 can be filled in parallel,
+         * with priorities up to <maxprio>.
+         * Afterwards, csr_finish() updates is_ordered.
+         */
+        void init_csr(int count, const int *outcount, int maxprio = 0);
+        inline int *outslots(const int vertex) { return _outedges + _firstouts[vertex]; }
+        void csr_finish(void);
+
         /**
          * Return the number of vertices.
          */
@@ -263,6 +307,8 @@ namespace pg
 
         /**
          * Create a new Game of the subgame of the vertices given in <selection>.
+         * Vertices without successors in the subgame become dead ends.
+         * (See SubgameView, to solve a subgame without copying it.)
          */
         Game *extract_subgame(std::vector<int> &selection);
         Game *extract_subgame(bitset mask);
@@ -292,7 +338,7 @@ namespace pg
          */
         inline int priority(const int vertex) const
         {
-            return _priority[vertex];
+            return _priority != NULL ? _priority[vertex] : _prio16[vertex];
         }
 
         /**
@@ -300,15 +346,24 @@ namespace pg
          */
         inline int owner(const int vertex) const
         {
-            return _owner[vertex];
+            return _meta[2 * vertex];
+        }
+
+        /**
+         * Get the parity of the priority of a vertex (without reading the priority)
+         */
+        inline int parity(const int vertex) const
+        {
+            return _meta[2 * vertex + 1];
         }
 
         /**
-         * Get the "real" label of a vertex
+         * Get the "real" label of a vertex (or NULL if it has none)
+         * The pointer is valid until the next set_label.
          */
-        inline std::string *rawlabel(const int vertex) const
+        inline const char *rawlabel(const int vertex) const
         {
-            return _label[vertex];
+            return _labelidx != NULL and _labelidx[vertex] != 0 ? _labelpool.data() + _labelidx[vertex] : NULL;
         }
 
         /**
@@ -337,12 +392,18 @@ namespace pg
 
         inline long outcount(const int vertex) const
         {
-            return _outcount[vertex];
+            const int *e = outs(vertex);
+            while (*e != -1)
+                e++;
+            return e - outs(vertex);
         }
 
         inline long incount(const int vertex) const
         {
-            return _incount[vertex];
+            const int *e = ins(vertex);
+            while (*e != -1)
+                e++;
+            return e - ins(vertex);
         }
 
         inline const int *outs(const int vertex) const
@@ -377,19 +438,20 @@ namespace pg
          */
 
     private:
-        long n_vertices;      // number of vertices
-        long n_edges;         // number of edges
-        int *_priority;       // priority of each vertex
-        bitset _owner;        // owner of each vertex (1 for odd, 0 for even)
-        std::string **_label; // (optional) vertex labels
+        long n_vertices;        // number of vertices
+        long n_edges;           // number of edges
+        uint16_t *_prio16;      // priority of each vertex, while all priorities fit
+        int *_priority;         // priority of each vertex, otherwise (else NULL)
+        bitset _meta;           // owner (bit 2v, 1 for odd) and priority parity (bit 2v+1)
+        std::string _labelpool; // (optional) vertex labels, each ending with a '\0'
+        uint32_t *_labelidx;    // offset of the label of each vertex in the pool (0 for none)
 
         int *_outedges;  // outgoing edges as array
         int *_firstouts; // first outgoing edge of each vertex
-        int *_outcount;  // outgoing edge count of each vertex
 
         int *_inedges;  // incoming edges as array
         int *_firstins; // first incoming edge of each vertex
-        int *_incount;  // incoming edge count of each vertex
+        size_t i_size;  // number of entries in the incoming edge array
 
         std::vector<int> *_outvec; // outgoing edges as vector
 
@@ -418,11 +480,11 @@ namespace pg
                 }
                 else
                 {
-                    std::string *l = lv.g.rawlabel(lv.v);
-                    if (l == NULL or l->empty())
+                    const char *l = lv.g.rawlabel(lv.v);
+                    if (l == NULL)
                         out << lv.v << "/" << lv.g.priority(lv.v);
                     else
-                        out << *l;
+                        out << l;
                 }
                 return out;
             }
@@ -434,6 +496,9 @@ namespace pg
 
     private:
         void unsafe_permute(int *mapping); // apply a reordering
+        void relayout_edges(void);         // rewrite the edge arrays in vertex order
+        void put_priority(int v, int p);   // store a priority, widening the array if needed
+        void widen_priorities(void);       // switch to 32-bit priorities
 
         boost::random::mt19937 generator;
         inline long rng(long low, long high) { return boost::random::uniform_int_distribution<>(low, high)(generator); }
@@ -0,0 +1,916 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <unordered_set>
+
+#include "generators.hpp"
+#include "lace.h"
+
+namespace pg
+{
+
+    namespace generators
+    {
+
+        /**
+         * Vertices per range. A multiple of 64, so ranges never share a word of the owner bitset.
+         */
+        static const int GEN_RANGE = 4096;
+
+        typedef std::function<void(int)> range_fn;
+
+        VOID_TASK_3(gen_ranges, const range_fn *, fn, int, first, int, count)
+        {
+            if (count > 1)
+            {
+                SPAWN(gen_ranges, fn, first + count / 2, count - count / 2);
+                CALL(gen_ranges, fn, first, count / 2);
+                SYNC(gen_ranges);
+            }
+            else if (count == 1)
+            {
+                (*fn)(first);
+            }
+        }
+
+        /**
+         * Call <fn> on every range of <n> vertices, in parallel if Lace is running.
+         */
+        static void
+        for_ranges(int n, const range_fn &fn)
+        {
+            const int ranges = (n + GEN_RANGE - 1) / GEN_RANGE;
+            if (lace_workers() != 0)
+            {
+                RUN(gen_ranges, &fn, 0, ranges);
+            }
+            else
+            {
+                for (int r = 0; r < ranges; r++)
+                    fn(r);
+            }
+        }
+
+        /**
+         * splitmix64 finalizer, to derive independent seeds.
+         */
+        static uint64_t
+        mix(uint64_t x)
+        {
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        static std::mt19937_64
+        range_rng(uint64_t seed, int pass, int range)
+        {
+            return std::mt19937_64(mix(mix(seed) + ((uint64_t)pass << 32) + (uint64_t)range));
+        }
+
+        static inline int
+        uniform(std::mt19937_64 &rng, int low, int high)
+        {
+            return std::uniform_int_distribution<int>(low, high)(rng);
+        }
+
+        /**
+         * Write <d> distinct random values of 0..<m>-1 to <out> (Floyd's algorithm).
+         * Membership is a linear search for small <d>, otherwise it uses <chosen>.
+         */
+        static void
+        sample(std::mt19937_64 &rng, int m, int d, int *out, std::unordered_set<int> &chosen)
+        {
+            const bool small = d <= 64;
+            if (!small)
+                chosen.clear();
+            for (int j = m - d, k = 0; j < m; j++, k++)
+            {
+                int t = uniform(rng, 0, j);
+                if (small ? std::find(out, out + k, t) != out + k : !chosen.insert(t).second)
+                {
+                    t = j; // not yet chosen, as all earlier values are below j
+                    if (!small)
+                        chosen.insert(t);
+                }
+                out[k] = t;
+            }
+        }
+
+        /**
+         * Replace <game> by an empty game of <n> vertices, for the vector API.
+         */
+        static void
+        reset(Game &game, int n)
+        {
+            Game g(n);
+            game.swap(g);
+            game.vec_init();
+        }
+
+        template <typename... Args>
+        static std::string
+        format(const char *fmt, Args... args)
+        {
+            const int size = snprintf(NULL, 0, fmt, args...) + 1;
+            std::unique_ptr<char[]> buf(new char[size]);
+            snprintf(buf.get(), size, fmt, args...);
+            return std::string(buf.get(), buf.get() + size - 1);
+        }
+
+        void
+        random(Game &game, int n, int maxP, int minD, int maxD, bool selfloops, uint64_t seed)
+        {
+            if (n < 1)
+                throw "number of vertices < 1";
+            if (maxP < 0)
+                throw "max priority < 0";
+            if (minD < 1)
+                throw "min degree < 1";
+            if (minD > maxD)
+                throw "min degree > max degree";
+            if (maxD > n)
+                throw "max degree > number of vertices";
+            if (maxD == n and !selfloops)
+                maxD--; // just fix the number
+            if (minD > maxD)
+                throw "min degree > number of other vertices";
+
+            std::vector<int> degree(n);
+
+            for_ranges(n, [&](int r)
+            {
+                std::mt19937_64 rng = range_rng(seed, 0, r);
+                const int end = std::min(n, (r + 1) * GEN_RANGE);
+                for (int v = r * GEN_RANGE; v < end; v++)
+                    degree[v] = uniform(rng, minD, maxD);
+            });
+
+            game.init_csr(n, degree.data(), maxP);
+
+            for_ranges(n, [&](int r)
+            {
+                std::mt19937_64 rng = range_rng(seed, 1, r);
+                std::unordered_set<int> chosen;
+                const int m = selfloops ? n : n - 1;
+                const int end = std::min(n, (r + 1) * GEN_RANGE);
+                for (int v = r * GEN_RANGE; v < end; v++)
+                {
+                    game.set_priority(v, uniform(rng, 0, maxP));
+                    game.set_owner(v, uniform(rng, 0, 1));
+                    int *out = game.outslots(v);
+                    sample(rng, m, degree[v], out, chosen);
+                    if (!selfloops)
+                    {
+                        // values 0..n-2 stand for all vertices except v
+                        for (int k = 0; k < degree[v]; k++)
+                            if (out[k] >= v)
+                                out[k]++;
+                    }
+                    std::sort(out, out + degree[v]);
+                }
+            });
+
+            game.csr_finish();
+        }
+
+        /**
+         * Binary search for <val> in the sorted array <arr>.
+         */
+        static int *
+        find(int *arr, int len, int val)
+        {
+            for (;;)
+            {
+                if (len <= 0)
+                    return NULL;
+                int mid = len / 2;
+                int v = arr[mid];
+                if (v == val)
+                {
+                    return arr + mid;
+                }
+                else if (v < val)
+                {
+                    arr += (mid + 1);
+                    len -= (mid + 1);
+                }
+                else
+                {
+                    len = mid;
+                }
+            }
+        }
+
+        void
+        steady(Game &game, int n, int minD, int maxD, int minI, int maxI, uint64_t seed)
+        {
+            if (n < 1)
+                throw "number of vertices < 1";
+            if (minD < 1 or minI < 1)
+                throw "min degree < 1";
+            if (minD > n or minI > n)
+                throw "min degree > number of vertices";
+            if (minD > maxD or minI > maxI)
+                throw "min degree > max degree";
+
+            std::mt19937_64 rng(mix(seed));
+
+            // src and tgt are the sorted vertices that can get more successors/predecessors
+            std::vector<int> src(n), tgt(n);
+            for (int j = 0; j < n; j++)
+                src[j] = j;
+            for (int j = 0; j < n; j++)
+                tgt[j] = j;
+            int src_count = n, tgt_count = n;
+            int intodo = n, outtodo = n;
+
+            std::vector<int> outcounts(n), incounts(n), owners(n);
+            std::vector<std::vector<int>> succ(n);
+
+            // array for temporarily removing unwanted target vertices
+            std::vector<int *> ptrs(maxD + 1);
+
+            for (int i = 0; i < n; i++)
+                owners[i] = uniform(rng, 0, 1);
+
+            while ((outtodo > 0 and tgt_count > 0) or (intodo > 0 and src_count > 0))
+            {
+                // obtain source vertex
+                int from = src[uniform(rng, 0, src_count - 1)];
+
+                // (temporarily) remove the successors of <from> and <from> from tgt array
+                int removed = 0;
+                ptrs[0] = find(tgt.data(), tgt_count, from);
+                const int out_len = succ[from].size();
+                for (int k = 0; k < out_len; k++)
+                    ptrs[k + 1] = find(tgt.data(), tgt_count, succ[from][k]);
+
+                std::sort(ptrs.begin(), ptrs.begin() + out_len + 1, [](int *a, int *b) { return a > b; });
+
+                for (int i = 0; i <= out_len and ptrs[i] != NULL; i++)
+                {
+                    std::swap(*ptrs[i], tgt[tgt_count - 1]);
+                    if (tgt_count <= 1)
+                        throw "cannot satisfy the degree bounds";
+                    tgt_count--;
+                    removed++;
+                }
+
+                // obtain target vertex
+                int to = tgt[uniform(rng, 0, tgt_count - 1)];
+
+                // put removed vertices back in
+                while (removed != 0)
+                {
+                    tgt_count++;
+                    std::swap(*ptrs[removed - 1], tgt[tgt_count - 1]);
+                    removed--;
+                }
+
+                // add the edge, which is new as the successors were removed
+                succ[from].push_back(to);
+                outcounts[from]++;
+                incounts[to]++;
+
+                // update source vertex counts
+                const int from_count = outcounts[from];
+                if (from_count == minD)
+                    outtodo--;
+                if (from_count >= maxD)
+                {
+                    int *ptr = find(src.data(), src_count, from);
+                    std::copy(ptr + 1, src.data() + src_count, ptr);
+                    src_count--;
+                }
+
+                // update target vertex counts
+                const int to_count = incounts[to];
+                if (to_count == minI)
+                    intodo--;
+                if (to_count >= maxI)
+                {
+                    int *ptr = find(tgt.data(), tgt_count, to);
+                    std::copy(ptr + 1, tgt.data() + tgt_count, ptr);
+                    tgt_count--;
+                }
+            }
+
+            game.init_csr(n, outcounts.data());
+            for (int i = 0; i < n; i++)
+            {
+                game.set_priority(i, i);
+                game.set_owner(i, owners[i]);
+                std::sort(succ[i].begin(), succ[i].end());
+                std::copy(succ[i].begin(), succ[i].end(), game.outslots(i));
+            }
+            game.csr_finish();
+        }
+
+        void
+        ladder(Game &game, int n)
+        {
+            if (n < 1)
+                throw "ladder size < 1";
+            if (n > INT32_MAX / 2)
+                throw "ladder size too large";
+
+            const int size = 2 * n;
+            std::vector<int> degree(size, 2);
+            game.init_csr(size, degree.data());
+
+            for_ranges(size, [&](int r)
+            {
+                const int end = std::min(size, (r + 1) * GEN_RANGE);
+                for (int v = r * GEN_RANGE; v < end; v++)
+                {
+                    game.set_priority(v, (v & 1) ? 1 : 2);
+                    game.set_owner(v, v & 1);
+                    int *out = game.outslots(v);
+                    out[0] = (v + 1) % size;
+                    out[1] = (v + 2) % size;
+                }
+            });
+
+            game.csr_finish();
+        }
+
+        void
+        clique(Game &game, int n)
+        {
+            if (n < 2)
+                throw "clique size < 2";
+
+            std::vector<int> degree(n, n - 1);
+            game.init_csr(n, degree.data(), n - 1);
+
+            for_ranges(n, [&](int r)
+            {
+                const int end = std::min(n, (r + 1) * GEN_RANGE);
+                for (int v = r * GEN_RANGE; v < end; v++)
+                {
+                    game.set_priority(v, v);
+                    game.set_owner(v, v & 1);
+                    int *out = game.outslots(v);
+                    for (int w = 0; w < n; w++)
+                        if (w != v)
+                            *out++ = w;
+                }
+            });
+
+            game.csr_finish();
+        }
+
+        void
+        counter_core(Game &game, int n)
+        {
+            n = 2 * n;
+            reset(game, 3 + 3 * n);
+
+            // create n+1 pieces
+            for (int i = 0; i <= n; i++)
+            {
+                game.init_vertex(3 * i + 0, n + 1 + i, (i & 1));
+                game.init_vertex(3 * i + 1, i, (i & 1));
+                game.init_vertex(3 * i + 2, i, 1 - (i & 1));
+                game.vec_add_edge(3 * i + 0, 3 * i + 1);
+                game.vec_add_edge(3 * i + 1, 3 * i + 2);
+                game.vec_add_edge(3 * i + 2, 3 * i + 1);
+                game.vec_add_edge(3 * i + 2, 3 * i + 2);
+            }
+
+            // connect the pieces
+            for (int i = 0; i < n; i++)
+            {
+                game.vec_add_edge(3 * i + 2, 3 * i + 3);
+                game.vec_add_edge(3 * i + 4, 3 * i + 0);
+            }
+
+            game.vec_finish();
+        }
+
+        void
+        counter_dp(Game &game, int n)
+        {
+            reset(game, 4 + n * 4);
+
+            // create n+1 pieces
+            for (int i = 0; i <= n; i++)
+            {
+                game.init_vertex(4 * i + 0, i, 1 - (i & 1));
+                game.init_vertex(4 * i + 1, i, 1 - (i & 1));
+                game.init_vertex(4 * i + 2, i, (i & 1));
+                game.init_vertex(4 * i + 3, i + 3, (i & 1));
+                game.vec_add_edge(4 * i + 0, 4 * i + 1);
+                game.vec_add_edge(4 * i + 1, 4 * i + 0);
+                game.vec_add_edge(4 * i + 1, 4 * i + 2);
+                game.vec_add_edge(4 * i + 2, 4 * i + 1);
+                game.vec_add_edge(4 * i + 3, 4 * i + 2);
+            }
+
+            // connect the pieces
+            for (int i = 0; i < n; i++)
+            {
+                game.vec_add_edge(4 * i + 6, 4 * i + 3);
+                game.vec_add_edge(4 * i + 1, 4 * i + 7);
+            }
+
+            game.vec_finish();
+        }
+
+        void
+        counter_m(Game &game, int n)
+        {
+            reset(game, 3 * n + 3);
+
+            // create n+1 pieces
+            for (int i = 0; i <= n; i++)
+            {
+                game.init_vertex(3 * i + 0, i + 2, (i & 1));
+                game.init_vertex(3 * i + 1, 1 - (i & 1), (i & 1));
+                game.init_vertex(3 * i + 2, 1 - (i & 1), 1 - (i & 1));
+                game.vec_add_edge(3 * i + 0, 3 * i + 1);
+                game.vec_add_edge(3 * i + 1, 3 * i + 2);
+                game.vec_add_edge(3 * i + 2, 3 * i + 1);
+            }
+
+            // connect the pieces
+            for (int i = 0; i < n; i++)
+            {
+                game.vec_add_edge(3 * i + 0, 3 * i + 3);
+                game.vec_add_edge(3 * i + 1, 3 * i + 3);
+                game.vec_add_edge(3 * i + 5, 3 * i + 2);
+            }
+
+            game.vec_finish();
+        }
+
+        void
+        counter_ortl(Game &game, int n)
+        {
+            reset(game, 1 + 5 * n);
+
+            game.init_vertex(0, 0, 1); // root of the distracted tangle
+            game.vec_add_edge(0, 0);   // self-loop
+
+            for (int i = 0; i < n; i++)
+            {
+                int c = 5 * i + 1;
+                int d = 2 * (n + i + 1);
+                game.init_vertex(c + 0, 2 * (n - i), 0); // distracted vertex
+                game.init_vertex(c + 1, d, 0);           // distraction
+                game.init_vertex(c + 2, 1, 1);           // opponent tangle start
+                game.init_vertex(c + 3, 1, 0);           // opponent tangle end
+                game.init_vertex(c + 4, d + 1, 0);       // attracting odd vertex
+                game.vec_add_edge(c + 0, 0);             // from distracted vertex to root
+                game.vec_add_edge(0, c + 0);             // from root to distracted vertex
+                game.vec_add_edge(c + 0, c + 1);         // from distracted vertex to distraction
+                game.vec_add_edge(c + 1, c + 2);         // from distraction to tangle
+                game.vec_add_edge(c + 2, c + 3);         // tangle forward edge
+                game.vec_add_edge(c + 3, c + 2);         // tangle backward edge
+                game.vec_add_edge(c + 3, c + 4);         // tangle to attracting odd vertex
+                game.vec_add_edge(c + 4, c);             // attracting odd vertex to distracted tangle
+            }
+
+            game.vec_finish();
+            game.sort();
+            game.renumber();
+        }
+
+        void
+        counter_qpt(Game &game, int n)
+        {
+            reset(game, 2 * n);
+
+            for (int i = 1; i <= 2 * n; i++)
+            {
+                // vertex i-1 has priority i and label i, owned by Even
+                game.init_vertex(i - 1, i, 0, std::to_string(i));
+                // if even, can go to 0
+                if ((i & 1) == 0)
+                    game.vec_add_edge(i - 1, 0);
+                if (i < 2 * n)
+                    game.vec_add_edge(i - 1, i);
+            }
+
+            game.vec_finish();
+        }
+
+        void
+        counter_rob(Game &game, int n)
+        {
+            n = 2 * n;
+
+            // core: 3*(n+1)
+            // extension: 3*(n*n+(n&1))/4 + n
+            reset(game, 3 * (n + 1) + n + (3 * n * n + (n & 1)) / 4);
+
+            // create n+1 pieces
+            for (int i = 0; i <= n; i++)
+            {
+                game.init_vertex(3 * i + 0, n + 1 + i, (i & 1));
+                game.init_vertex(3 * i + 1, i, (i & 1));
+                game.init_vertex(3 * i + 2, i, 1 - (i & 1));
+                game.vec_add_edge(3 * i + 0, 3 * i + 1);
+                game.vec_add_edge(3 * i + 1, 3 * i + 2);
+                game.vec_add_edge(3 * i + 2, 3 * i + 1);
+                game.vec_add_edge(3 * i + 2, 3 * i + 2);
+            }
+
+            // connect the pieces
+            for (int i = 0; i < n; i++)
+            {
+                game.vec_add_edge(3 * i + 2, 3 * i + 3);
+                game.vec_add_edge(3 * i + 4, 3 * i + 0);
+            }
+
+            // create more connectors
+            int nxt = 3 * n + 3;
+            for (int i = 0; i <= n; i++)
+            {
+                for (int j = i + 1; j <= n; j++)
+                {
+                    int i_parity = 1 - (i & 1); // parity of c_i vertex
+                    int j_parity = 1 - (j & 1); // parity of c_j vertex
+                    int ci = 3 * i + 2;
+                    int cj = 3 * j + 2;
+                    if (i_parity == j_parity)
+                    {
+                        // same parity, only need 1
+                        game.init_vertex(nxt, 0, 1 - i_parity);
+                        game.vec_add_edge(ci, nxt);
+                        game.vec_add_edge(cj, nxt);
+                        game.vec_add_edge(nxt, ci);
+                        game.vec_add_edge(nxt, cj);
+                        nxt++;
+                    }
+                    else
+                    {
+                        // different parity, so we need two
+                        game.init_vertex(nxt, 0, 1 - i_parity);
+                        game.init_vertex(nxt + 1, 0, 1 - j_parity);
+                        game.vec_add_edge(ci, nxt);
+                        game.vec_add_edge(nxt, ci);
+                        game.vec_add_edge(nxt, nxt + 1);
+                        game.vec_add_edge(nxt + 1, nxt);
+                        game.vec_add_edge(cj, nxt + 1);
+                        game.vec_add_edge(nxt + 1, cj);
+                        nxt += 2;
+                    }
+                }
+            }
+
+            game.vec_finish();
+        }
+
+        void
+        counter_rr(Game &game, int n)
+        {
+            reset(game, 4 * n);
+
+            for (int i = 0; i < n; i++)
+            {
+                game.init_vertex(4 * i, n - 1 - i, (n + i) & 1);
+                game.init_vertex(4 * i + 1, n - 1 - i, (n + i) & 1);
+                game.init_vertex(4 * i + 2, n + 1 + i, (n + i) & 1);
+                game.init_vertex(4 * i + 3, n + 1 + i, (n + i) & 1);
+                // add edges within the group
+                game.vec_add_edge(4 * i, 4 * i + 1);
+                game.vec_add_edge(4 * i + 1, 4 * i);
+                game.vec_add_edge(4 * i + 2, 4 * i + 3);
+                game.vec_add_edge(4 * i + 3, 4 * i + 2);
+                game.vec_add_edge(4 * i, 4 * i + 2);
+                game.vec_add_edge(4 * i + 1, 4 * i + 3);
+                // add edges to the next group
+                if (i == (n - 1))
+                {
+                    game.vec_add_edge(4 * i + 2, 0);
+                    game.vec_add_edge(4 * i + 3, 1);
+                }
+                else
+                {
+                    game.vec_add_edge(4 * i + 2, 4 * i + 4);
+                    game.vec_add_edge(4 * i + 3, 4 * i + 5);
+                }
+            }
+
+            game.vec_finish();
+        }
+
+        /**
+         * The inputs (gates/distractions) and high vertices of the bits of the two counters.
+         */
+        struct counters
+        {
+            int n;
+            std::vector<int> in0, in1, hi0, hi1;
+        };
+
+        /**
+         * Make bit <i> of the two counters (tc) at base index <c> with given input/high priorities.
+         */
+        static void
+        tc_bit(Game &game, const counters &tc, const int c, int hipr, int inpr, int lopr, int i)
+        {
+            const int n = tc.n;
+            const int pl = hipr & 1;
+            const std::vector<int> &_in = pl == 0 ? tc.in1 : tc.in0; // select _in of opponent
+
+            // create "core" of the bit
+            const char *plch = pl ? "Odd-" : "Even-";
+
+            game.init_vertex(c, hipr, pl, format("%s%d-H", plch, i));       // high
+            game.init_vertex(c + 1, lopr, 1 - pl, format("%s%d-T", plch, i)); // low (tangle)
+            game.init_vertex(c + 2, inpr, 1 - pl, format("%s%d-L", plch, i)); // gate (distraction/input)
+
+            game.vec_add_edge(c + 1, c);     // from tangle to top
+            game.vec_add_edge(c + 2, c + 1); // from input/distraction to tangle
+            game.vec_add_edge(c + 1, c + 3); // from tangle to first connector
+
+            // create connectors (to higher bits)
+            for (int j = 0; j < i; j++)
+            {
+                const int d = c + 3 + 3 * j;
+
+                game.init_vertex(d, lopr - 1, pl, format("%s%d-S-%d", plch, i, j));         // selector
+                game.init_vertex(d + 1, lopr - 1, 1 - pl, format("%s%d-A-%d", plch, i, j)); // exit one (even)
+                game.init_vertex(d + 2, lopr - 1, 1 - pl, format("%s%d-B-%d", plch, i, j)); // exit two (odd)
+
+                game.vec_add_edge(d, d + 1); // s to one
+                game.vec_add_edge(d, d + 2); // s to two
+
+                game.vec_add_edge(d + 1, d + 3); // one to next selector
+                game.vec_add_edge(d + 2, d + 3); // two to next selector
+
+                const std::vector<int> &ina = pl ? tc.in1 : tc.in0;
+                const std::vector<int> &inb = pl ? tc.in0 : tc.in1;
+                game.vec_add_edge(d + 1, ina[j]); // one to even input of bit <j>
+                game.vec_add_edge(d + 2, inb[j]); // two to odd input of bit <j>
+            }
+
+            // connect from <high> to the next <input>
+            game.vec_add_edge(c, (pl == 0 ? tc.in0 : tc.in1)[(i + n - 1) % n]);
+
+            // even (lower or same bit)
+            // odd (only to lower bits)
+            int x = c + 3 + 3 * i;
+            game.init_vertex(x, lopr - 1, pl, format("%s%d-Z", plch, i)); // Z (distracted)
+            game.vec_add_edge(x, c + 1);                                  // from Z to tangle
+            for (int j = i + 1 - pl; j < n; j++)
+                game.vec_add_edge(x, _in[j]);
+        }
+
+        void
+        two_counters(Game &game, int n)
+        {
+            if (n < 1)
+                throw "number of bits < 1";
+
+            // every bit has 3 vertices (low, high, input) plus 1 (distracted),
+            // and 3 more vertices for every lower bit
+            counters tc;
+            tc.n = n;
+            tc.in0.resize(n);
+            tc.in1.resize(n);
+            tc.hi0.resize(n);
+            tc.hi1.resize(n);
+
+            int size = 0;
+            for (int i = 0; i < n; i++)
+            {
+                tc.hi0[i] = size;
+                tc.in0[i] = size + 2; // set even gate / distraction
+                size += 4 + 3 * i;
+                tc.hi1[i] = size;
+                tc.in1[i] = size + 2; // set odd gate / distraction
+                size += 4 + 3 * i;
+            }
+
+            reset(game, size);
+
+            // create the two counters
+            // - the even bit is higher than the odd bit (hipr)
+            // - strict separation between two bits priorities similarly
+            int toppo = (n + 3) * n + 6 * n; // N*N + 9N actually
+            for (int i = 0; i < n; i++)
+            {
+                tc_bit(game, tc, tc.hi0[i], toppo - 2, toppo - 2 * n - 3, 2, i);
+                tc_bit(game, tc, tc.hi1[i], toppo - 1, toppo - 2 * n - 2, 1, i);
+                toppo -= 2;
+            }
+
+            game.vec_finish();
+            game.sort();
+            game.renumber();
+        }
+
+        /**
+         * Make bit <i> of the two counters (tc+) at base index <c> with given input/high priorities.
+         */
+        static void
+        tcplus_bit(Game &game, const counters &tc, const int c, int hipr, int inpr, int lopr, int i)
+        {
+            const int n = tc.n;
+            const int pl = hipr & 1;
+            const std::vector<int> &inmy = pl ? tc.in1 : tc.in0;
+            const std::vector<int> &inop = pl ? tc.in0 : tc.in1;
+
+            // create "core" of the bit
+            std::string bitid_str = format(pl ? "Odd-%d" : "Even-%d", i);
+            const char *bitid = bitid_str.c_str();
+
+            game.init_vertex(c, hipr, pl, format("%s-H", bitid));         // high
+            game.init_vertex(c + 1, inpr, 1 - pl, format("%s-I", bitid)); // gate (distraction/input)
+            game.init_vertex(c + 2, lopr, 1 - pl, format("%s-T", bitid)); // low (tangle)
+            game.vec_add_edge(c + 1, c + 2);                              // connect I -> T
+            game.vec_add_edge(c + 2, c);                                  // connect T -> H
+            game.vec_add_edge(c, inmy[i == 0 ? n - 1 : i - 1]);           // connect H -> I{(j-1) mod n}
+
+            int d = c + 3;
+
+            // create connectors (to higher bits)
+            game.vec_add_edge(c + 2, d); // connect T -> chain
+            for (int j = 0; j < i; j++)
+            {
+                game.init_vertex(d, lopr - 1, pl, format("%s-S-%d", bitid, j));         // selector
+                game.init_vertex(d + 1, lopr - 1, 1 - pl, format("%s-A-%d", bitid, j)); // exit one (even)
+                game.init_vertex(d + 2, lopr - 1, 1 - pl, format("%s-B-%d", bitid, j)); // exit two (odd)
+
+                game.vec_add_edge(d, d + 1);       // connect Sj -> Aj
+                game.vec_add_edge(d, d + 2);       // connect Sj -> Bj
+                game.vec_add_edge(d + 1, d + 3);   // connect Aj -> S{j+1}
+                game.vec_add_edge(d + 2, d + 3);   // connect Bj -> S{j+1}
+                game.vec_add_edge(d + 1, inmy[j]); // connect Aj -> <my> Ij
+                game.vec_add_edge(d + 2, inop[j]); // connect Bj -> <their> Ij
+
+                d += 3;
+            }
+
+            game.init_vertex(d, lopr + 2, pl, format("%s-Z", bitid));
+            game.vec_add_edge(d, c + 2);
+            d += 1;
+
+            // connect to distractions, i.e., lower bits
+            for (int k = i + 1; k < n; k++)
+            {
+                // create connectors (to higher bits)
+                game.vec_add_edge(c + 2, d); // connect T -> chain
+                for (int j = 0; j < i; j++)
+                {
+                    game.init_vertex(d, lopr - 1, pl, format("%s-%d-S-%d", bitid, k, j));         // selector
+                    game.init_vertex(d + 1, lopr - 1, 1 - pl, format("%s-%d-A-%d", bitid, k, j)); // exit one (even)
+                    game.init_vertex(d + 2, lopr - 1, 1 - pl, format("%s-%d-B-%d", bitid, k, j)); // exit two (odd)
+
+                    game.vec_add_edge(d, d + 1);       // connect Sj -> Aj
+                    game.vec_add_edge(d, d + 2);       // connect Sj -> Bj
+                    game.vec_add_edge(d + 1, d + 3);   // connect Aj -> S{j+1}
+                    game.vec_add_edge(d + 2, d + 3);   // connect Bj -> S{j+1}
+                    game.vec_add_edge(d + 1, inmy[j]); // connect Aj -> <my> Ij
+                    game.vec_add_edge(d + 2, inop[j]); // connect Bj -> <their> Ij
+
+                    d += 3;
+                }
+
+                const int pr = lopr + 2 * (k - i + 1);
+                game.init_vertex(d, pr, pl, format("%s-%d-Z", bitid, k));
+                game.vec_add_edge(d, c + 2);   // dv -> first selector!
+                game.vec_add_edge(d, inop[k]); // dv -> ...-I
+
+                d += 1;
+            }
+        }
+
+        void
+        two_counters_plus(Game &game, int n)
+        {
+            if (n < 1)
+                throw "number of bits < 1";
+
+            counters tc;
+            tc.n = n;
+            tc.in0.resize(n);
+            tc.in1.resize(n);
+            tc.hi0.resize(n);
+            tc.hi1.resize(n);
+
+            int size = 0;
+            for (int i = 0; i < n; i++)
+            {
+                tc.hi0[i] = size;
+                tc.in0[i] = size + 1; // set even gate // distraction
+                size += 3 + (3 * i + 1) * (n - i);
+                tc.hi1[i] = size;
+                tc.in1[i] = size + 1; // set odd gate // distraction
+                size += 3 + (3 * i + 1) * (n - i);
+            }
+
+            reset(game, size);
+
+            int toppo = (n + 3) * n + 6 * n; // N*N + 9N actually
+            for (int i = 0; i < n; i++)
+            {
+                tcplus_bit(game, tc, tc.hi0[i], toppo, toppo - 2 * n - 1, 2, i);
+                tcplus_bit(game, tc, tc.hi1[i], toppo - 1, toppo - 2 * n - 2, 3, i);
+                toppo -= 2;
+            }
+
+            game.vec_finish();
+            std::vector<int> mapping(game.nodecount());
+            game.sort(mapping.data());
+            game.renumber();
+            game.permute(mapping.data());
+        }
+
+        const family families[] = {
+            {"random", "n maxP minD maxD [selfloops=1]", "random game (rngame)"},
+            {"steady", "n minD maxD minI maxI", "random game with bounded in- and out-degrees (stgame)"},
+            {"ladder", "n", "ladder of 2n vertices"},
+            {"clique", "n", "clique of n vertices"},
+            {"core", "n", "counterexample of Benerecetti et al (counter_core)"},
+            {"dp", "n", "counterexample to DP (counter_dp)"},
+            {"m", "n", "counterexample of Gazda (counter_m)"},
+            {"ortl", "n", "counterexample to ORTL (counter_ortl)"},
+            {"qpt", "n", "counterexample of Fearnley et al (counter_qpt)"},
+            {"rob", "n", "SCC version of core (counter_rob)"},
+            {"rr", "n", "counterexample to RR (counter_rr)"},
+            {"tc", "n", "two binary counters (tc)"},
+            {"tc+", "n", "two binary counters modified to defeat RTL (tc+)"},
+            {NULL, NULL, NULL},
+        };
+
+        void
+        generate(Game &game, const std::string &name, const std::vector<long> &args, uint64_t seed)
+        {
+            const family *f = families;
+            while (f->name != NULL and name != f->name)
+                f++;
+            if (f->name == NULL)
+                throw "unknown game family";
+
+            // the number of required and optional arguments, from the argument names
+            size_t required = 0, optional = 0;
+            for (const char *a = f->args; *a; a++)
+            {
+                if (a == f->args or a[-1] == ' ')
+                    (*a == '[' ? optional : required)++;
+            }
+            if (args.size() < required or args.size() > required + optional)
+                throw "wrong number of arguments for game family";
+            for (long a : args)
+                if (a < INT32_MIN or a > INT32_MAX)
+                    throw "argument out of range";
+
+            auto arg = [&](size_t i, int def) { return i < args.size() ? (int)args[i] : def; };
+
+            if (name == "random")
+                random(game, arg(0, 0), arg(1, 0), arg(2, 0), arg(3, 0), arg(4, 1) != 0, seed);
+            else if (name == "steady")
+                steady(game, arg(0, 0), arg(1, 0), arg(2, 0), arg(3, 0), arg(4, 0), seed);
+            else if (name == "ladder")
+                ladder(game, arg(0, 0));
+            else if (name == "clique")
+                clique(game, arg(0, 0));
+            else if (arg(0, 0) < 1)
+                throw "n < 1";
+            else if (name == "core")
+                counter_core(game, arg(0, 0));
+            else if (name == "dp")
+                counter_dp(game, arg(0, 0));
+            else if (name == "m")
+                counter_m(game, arg(0, 0));
+            else if (name == "ortl")
+                counter_ortl(game, arg(0, 0));
+            else if (name == "qpt")
+                counter_qpt(game, arg(0, 0));
+            else if (name == "rob")
+                counter_rob(game, arg(0, 0));
+            else if (name == "rr")
+                counter_rr(game, arg(0, 0));
+            else if (name == "tc")
+                two_counters(game, arg(0, 0));
+            else if (name == "tc+")
+                two_counters_plus(game, arg(0, 0));
+        }
+
+    }
+
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GENERATORS_HPP
+#define GENERATORS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+
+namespace pg
+{
+
+    /**
+     * Generators for random, structured and counterexample parity games.
+     *
+     * Every generator replaces the contents of <game>. The random and structured families
+     * write the edge array directly (Game::init_csr) and fill ranges of vertices in parallel
+     * if Lace is running. Random choices are drawn per range of vertices from a generator
+     * seeded with <seed> and the range, so a seed gives the same game for any number of
+     * workers. Invalid arguments throw a const char* message, as the game parser does.
+     */
+    namespace generators
+    {
+
+        /**
+         * Random game of <n> vertices with priorities 0..<maxP>, random owners and
+         * <minD>..<maxD> distinct random successors per vertex (as rngame).
+         */
+        void random(Game &game, int n, int maxP, int minD, int maxD, bool selfloops, uint64_t seed);
+
+        /**
+         * Random game of <n> vertices with <minD>..<maxD> successors and <minI>..<maxI>
+         * predecessors per vertex, where possible, and priority i for vertex i (as stgame).
+         * This generator is sequential.
+         */
+        void steady(Game &game, int n, int minD, int maxD, int minI, int maxI, uint64_t seed);
+
+        /**
+         * Ladder of 2<n> vertices, each with edges to the next two vertices (cyclic).
+         * Even vertices are owned by Even with priority 2, odd vertices by Odd with priority 1.
+         */
+        void ladder(Game &game, int n);
+
+        /**
+         * Clique of <n> vertices; vertex i has priority i, owner i&1, and an edge to every
+         * other vertex.
+         */
+        void clique(Game &game, int n);
+
+        /**
+         * The counterexample families of the counter_* and tc tools.
+         */
+        void counter_core(Game &game, int n);   // Benerecetti et al, GandALF 2017
+        void counter_dp(Game &game, int n);     // counterexample to DP
+        void counter_m(Game &game, int n);      // Gazda, PhD thesis, Sec. 3.5
+        void counter_ortl(Game &game, int n);   // counterexample to ORTL
+        void counter_qpt(Game &game, int n);    // Fearnley et al, SPIN 2017
+        void counter_rob(Game &game, int n);    // SCC version of counter_core
+        void counter_rr(Game &game, int n);     // counterexample to RR
+        void two_counters(Game &game, int n);   // tc, van Dijk, GandALF 2019
+        void two_counters_plus(Game &game, int n); // tc+, modified to defeat RTL
+
+        struct family
+        {
+            const char *name;
+            const char *args;        // names of the arguments, space separated
+            const char *description;
+        };
+
+        /**
+         * All families that generate() knows, ending with {NULL, NULL, NULL}.
+         */
+        extern const family families[];
+
+        /**
+         * Generate a game of family <name> (see families) with the given arguments.
+         * The deterministic families ignore <seed>.
+         */
+        void generate(Game &game, const std::string &name, const std::vector<long> &args, uint64_t seed = 0);
+
+    }
+
+}
+
+#endif
@@ -778,12 +778,15 @@ static uint64_t ctr_all[CTR_MAX];
  * Reset the counters of Lace.
  */
 void
-lace_count_reset()
+lace_count_reset(void)
 {
 #if LACE_COUNT_EVENTS
     unsigned int i;
     size_t j;
 
+    // wait until all workers are initialized, for instance just after lace_start
+    while (workers_running != n_workers) {}
+
     for (i=0;i<n_workers;i++) {
         for (j=0;j<CTR_MAX;j++) {
             workers_p[i]->ctr[j] = 0;
@@ -802,6 +805,43 @@ lace_count_reset()
 #endif
 }
 
+int
+lace_count_enabled(void)
+{
+    return LACE_COUNT_EVENTS;
+}
+
+void
+lace_count_worker(unsigned int worker, lace_count_t *res)
+{
+    memset(res, 0, sizeof(lace_count_t));
+#if LACE_COUNT_EVENTS
+    if (worker >= n_workers) return;
+    while (workers_running != n_workers) {}
+    uint64_t *ctr = workers_p[worker]->ctr;
+#if LACE_COUNT_TASKS
+    res->tasks = ctr[CTR_tasks];
+#endif
+#if LACE_COUNT_STEALS
+    res->steals = ctr[CTR_steals];
+    res->steal_tries = ctr[CTR_steal_tries];
+    res->leaps = ctr[CTR_leaps];
+    res->leap_tries = ctr[CTR_leap_tries];
+#endif
+#if LACE_PIE_TIMES
+    // the timers count ticks, convert with the tick rate since the last reset
+    long long unsigned us = us_elapsed();
+    if (us == 0) return;
+    double dcpm = (double)(gethrtime() - count_at_start) / (us / 1000.0);
+    res->work_ms = (ctr[CTR_wapp] + ctr[CTR_lapp]) / dcpm;
+    res->idle_ms = (ctr[CTR_init] + ctr[CTR_wsteal] - ctr[CTR_wstealsucc] - ctr[CTR_wsignal]
+                    + ctr[CTR_lsteal] - ctr[CTR_lstealsucc] - ctr[CTR_lsignal]) / dcpm;
+#endif
+#endif
+    return;
+    (void)worker;
+}
+
 /**
  * Report counters to the given file.
  */
@@ -919,10 +959,6 @@ void lace_stop()
 
     while (workers_running != 0) {}
 
-#if LACE_COUNT_EVENTS
-    lace_count_report_file(stdout);
-#endif
-
     // finally, destroy the barriers
     lace_barrier_destroy();
     sem_destroy(&suspend_semaphore);
@@ -946,6 +982,9 @@ void lace_stop()
 
     free(workers_memory);
     workers_memory = 0;
+
+    // lace_workers() returns 0 again, so Lace can be restarted
+    n_workers = 0;
 }
 
 /**
@@ -24,10 +24,19 @@
 #ifndef __LACE_H__
 #define __LACE_H__
 
+/* Statistics, can be enabled when building (cmake -DOINK_LACE_STATS=ON) */
+#ifndef LACE_PIE_TIMES
 #define LACE_PIE_TIMES 0
+#endif
+#ifndef LACE_COUNT_TASKS
 #define LACE_COUNT_TASKS 0
+#endif
+#ifndef LACE_COUNT_STEALS
 #define LACE_COUNT_STEALS 0
+#endif
+#ifndef LACE_COUNT_SPLITS
 #define LACE_COUNT_SPLITS 0
+#endif
 #define LACE_USE_HWLOC 0
 #define LACE_USE_MMAP 0
 
@@ -316,10 +325,38 @@ static inline uint64_t gethrtime()
 #endif
 
 #if LACE_COUNT_EVENTS
-void lace_count_reset();
 void lace_count_report_file(FILE *file);
 #endif
 
+/**
+ * The counters of one worker since lace_count_reset().
+ * Counters that are not compiled in (LACE_COUNT_TASKS, LACE_COUNT_STEALS, LACE_PIE_TIMES) are 0.
+ */
+typedef struct {
+    uint64_t tasks;             // tasks spawned
+    uint64_t steals;            // successful steals
+    uint64_t steal_tries;       // steal attempts
+    uint64_t leaps;             // successful leaps (stealing from the thief of the task we sync on)
+    uint64_t leap_tries;        // leap attempts
+    double work_ms;             // time running stolen or leapt tasks
+    double idle_ms;             // time searching for work, including before the first steal
+} lace_count_t;
+
+/**
+ * Returns 1 if Lace is compiled with counters (LACE_COUNT_EVENTS), else 0.
+ */
+int lace_count_enabled(void);
+
+/**
+ * Reset the counters of all workers.
+ */
+void lace_count_reset(void);
+
+/**
+ * Get the counters of worker <worker>, while Lace is running.
+ */
+void lace_count_worker(unsigned int worker, lace_count_t *res);
+
 #if LACE_COUNT_TASKS
 #define PR_COUNTTASK(s) PR_INC(s,CTR_tasks)
 #else
@@ -0,0 +1,279 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <sys/mman.h>
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "mempolicy.hpp"
+#include "lace.h"
+
+namespace pg
+{
+
+    static mem_policy policy;
+
+    /**
+     * Mapped blocks are whole huge pages, so they can be backed by huge pages, and the
+     * parallel copy works per huge page.
+     */
+    static const size_t MEM_CHUNK = size_t(2) << 20;
+
+    mem_policy
+    mem_policy::parse(const std::string &str)
+    {
+        mem_policy res;
+        std::stringstream ss(str);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            if (item == "default")
+                res = mem_policy();
+            else if (item == "thp")
+                res.pages = PAGES_THP;
+            else if (item == "hugetlb")
+                res.pages = PAGES_HUGETLB;
+            else if (item == "interleave")
+                res.place = PLACE_INTERLEAVE;
+            else if (item == "first-touch")
+                res.place = PLACE_FIRST_TOUCH;
+            else
+                throw "unknown memory policy";
+        }
+        return res;
+    }
+
+    std::string
+    mem_policy::str() const
+    {
+        std::string res;
+        if (pages == PAGES_THP)
+            res = "thp";
+        else if (pages == PAGES_HUGETLB)
+            res = "hugetlb";
+        if (place != PLACE_DEFAULT and !res.empty())
+            res += ",";
+        if (place == PLACE_INTERLEAVE)
+            res += "interleave";
+        else if (place == PLACE_FIRST_TOUCH)
+            res += "first-touch";
+        return res.empty() ? "default" : res;
+    }
+
+    void
+    set_mem_policy(const mem_policy &p)
+    {
+        policy = p;
+    }
+
+    const mem_policy &
+    get_mem_policy(void)
+    {
+        return policy;
+    }
+
+    /**
+     * The online NUMA nodes (up to 64), from sysfs, e.g. "0-1" or "0,2-3".
+     */
+    static uint64_t
+    online_nodes(void)
+    {
+        static const uint64_t nodes = []()
+        {
+            uint64_t mask = 0;
+            std::ifstream file("/sys/devices/system/node/online");
+            std::string range;
+            while (std::getline(file, range, ','))
+            {
+                int first, last;
+                const int n = sscanf(range.c_str(), "%d-%d", &first, &last);
+                if (n < 1)
+                    continue;
+                if (n == 1)
+                    last = first;
+                for (int i = first; i <= last and i < 64; i++)
+                    mask |= uint64_t(1) << i;
+            }
+            return mask;
+        }();
+        return nodes;
+    }
+
+    int
+    numa_nodes(void)
+    {
+        const int n = __builtin_popcountll(online_nodes());
+        return n > 0 ? n : 1;
+    }
+
+    static void
+    interleave(void *ptr, size_t len)
+    {
+#if defined(__linux__) && defined(SYS_mbind)
+        unsigned long mask = online_nodes();
+        if (__builtin_popcountl(mask) < 2)
+            return;
+        // best effort: without permission the pages are placed as usual
+        syscall(SYS_mbind, ptr, len, MPOL_INTERLEAVE, &mask, sizeof(mask) * 8 + 1, 0);
+#else
+        (void)ptr;
+        (void)len;
+#endif
+    }
+
+    static inline size_t
+    map_length(size_t bytes)
+    {
+        return (bytes + MEM_CHUNK - 1) / MEM_CHUNK * MEM_CHUNK;
+    }
+
+    static void *
+    map_block(size_t len)
+    {
+        void *ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if (policy.pages == mem_policy::PAGES_HUGETLB)
+            ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (ptr == MAP_FAILED)
+        {
+            ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED)
+                return NULL;
+#ifdef MADV_HUGEPAGE
+            if (policy.pages != mem_policy::PAGES_DEFAULT)
+                madvise(ptr, len, MADV_HUGEPAGE);
+#endif
+        }
+        if (policy.place == mem_policy::PLACE_INTERLEAVE)
+            interleave(ptr, len);
+        return ptr;
+    }
+
+    void *
+    mem_alloc(size_t bytes)
+    {
+        if (bytes < MEM_LARGE)
+            return malloc(bytes);
+        return map_block(map_length(bytes));
+    }
+
+    void *
+    mem_realloc(void *ptr, size_t old_bytes, size_t bytes)
+    {
+        if (ptr == NULL)
+            return mem_alloc(bytes);
+        if (old_bytes < MEM_LARGE and bytes < MEM_LARGE)
+            return realloc(ptr, bytes);
+#ifdef __linux__
+        if (old_bytes >= MEM_LARGE and bytes >= MEM_LARGE)
+        {
+            // the mapping keeps its huge pages and placement
+            void *res = mremap(ptr, map_length(old_bytes), map_length(bytes), MREMAP_MAYMOVE);
+            if (res != MAP_FAILED)
+                return res;
+        }
+#endif
+        void *res = mem_alloc(bytes);
+        if (res == NULL)
+            return NULL;
+        memcpy(res, ptr, std::min(old_bytes, bytes));
+        mem_free(ptr, old_bytes);
+        return res;
+    }
+
+    void
+    mem_free(void *ptr, size_t bytes)
+    {
+        if (ptr == NULL)
+            return;
+        if (bytes < MEM_LARGE)
+            free(ptr);
+        else
+            munmap(ptr, map_length(bytes));
+    }
+
+    /**
+     * Copy <src> to <dst>, or set <dst> to <value> if <src> is NULL, per huge page.
+     */
+    VOID_TASK_4(mem_chunks, char *, dst, const char *, src, int, value, size_t, bytes)
+    {
+        if (bytes > MEM_CHUNK)
+        {
+            const size_t half = std::max(size_t(1), bytes / MEM_CHUNK / 2) * MEM_CHUNK;
+            SPAWN(mem_chunks, dst + half, src != NULL ? src + half : NULL, value, bytes - half);
+            CALL(mem_chunks, dst, src, value, half);
+            SYNC(mem_chunks);
+        }
+        else if (src != NULL)
+        {
+            memcpy(dst, src, bytes);
+        }
+        else
+        {
+            memset(dst, value, bytes);
+        }
+    }
+
+    static inline bool
+    by_workers(size_t bytes)
+    {
+        return policy.place == mem_policy::PLACE_FIRST_TOUCH and bytes >= MEM_LARGE and lace_workers() > 1;
+    }
+
+    void
+    mem_copy(void *dst, const void *src, size_t bytes)
+    {
+        if (by_workers(bytes))
+            RUN(mem_chunks, (char *)dst, (const char *)src, 0, bytes);
+        else
+            memcpy(dst, src, bytes);
+    }
+
+    void
+    mem_set(void *dst, int value, size_t bytes)
+    {
+        if (by_workers(bytes))
+            RUN(mem_chunks, (char *)dst, NULL, value, bytes);
+        else
+            memset(dst, value, bytes);
+    }
+
+    void *
+    mem_move(void *ptr, size_t bytes, size_t used)
+    {
+        if (ptr == NULL)
+            return NULL;
+        void *res = mem_alloc(bytes);
+        if (res == NULL)
+            abort();
+        mem_copy(res, ptr, used);
+        mem_free(ptr, bytes);
+        return res;
+    }
+
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEMPOLICY_HPP
+#define MEMPOLICY_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace pg
+{
+
+    /**
+     * How the pages of the large arrays of games and solvers are backed and placed.
+     * - PAGES_THP: transparent huge pages (madvise)
+     * - PAGES_HUGETLB: explicit huge pages (MAP_HUGETLB), or transparent huge pages if
+     *   the system has no huge pages reserved
+     * - PLACE_INTERLEAVE: the pages are spread over all NUMA nodes
+     * - PLACE_FIRST_TOUCH: the arrays are initialized by the Lace workers (see mem_copy),
+     *   so every page is placed on the node of the worker that first writes it
+     */
+    struct mem_policy
+    {
+        enum
+        {
+            PAGES_DEFAULT,
+            PAGES_THP,
+            PAGES_HUGETLB
+        } pages = PAGES_DEFAULT;
+
+        enum
+        {
+            PLACE_DEFAULT,
+            PLACE_INTERLEAVE,
+            PLACE_FIRST_TOUCH
+        } place = PLACE_DEFAULT;
+
+        bool is_default() const { return pages == PAGES_DEFAULT and place == PLACE_DEFAULT; }
+
+        /**
+         * Parse a comma separated list of "thp", "hugetlb", "interleave", "first-touch",
+         * or "default". Throws a const char* message for anything else.
+         */
+        static mem_policy parse(const std::string &str);
+
+        std::string str() const;
+    };
+
+    /**
+     * Set the policy of the allocations that follow, in this process.
+     * Blocks that are already allocated keep their pages.
+     */
+    void set_mem_policy(const mem_policy &policy);
+    const mem_policy &get_mem_policy(void);
+
+    /**
+     * Returns the number of NUMA nodes of the system (1 if unknown).
+     */
+    int numa_nodes(void);
+
+    /**
+     * Allocation of large arrays with the current policy. Blocks from MEM_LARGE bytes are
+     * mapped separately (as glibc does for large blocks); smaller blocks use malloc and
+     * ignore the policy. Blocks are not initialized, and must be resized and freed with
+     * their size. Returns NULL if out of memory, like malloc.
+     */
+    static const size_t MEM_LARGE = size_t(1) << 20;
+
+    void *mem_alloc(size_t bytes);
+    void *mem_realloc(void *ptr, size_t old_bytes, size_t bytes);
+    void mem_free(void *ptr, size_t bytes);
+
+    /**
+     * memcpy and memset, by the Lace workers if Lace is running and the policy is
+     * PLACE_FIRST_TOUCH, so the pages of <dst> are spread over their nodes.
+     */
+    void mem_copy(void *dst, const void *src, size_t bytes);
+    void mem_set(void *dst, int value, size_t bytes);
+
+    /**
+     * Move a block of <bytes> (with <used> bytes in use) to a new block of the current
+     * policy. Returns the new block; aborts if out of memory.
+     */
+    void *mem_move(void *ptr, size_t bytes, size_t used);
+
+}
+
+#endif
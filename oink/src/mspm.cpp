@@ -527,6 +527,8 @@ MSPMSolver::run()
     delete[] best;
 
     logger << "solved with " << lift_count << " lifts, " << lift_attempt << " lift attempts." << std::endl;
+    stats.count("lifts", lift_count);
+    stats.count("lift_attempts", lift_attempt);
 }
 
 }
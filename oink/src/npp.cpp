@@ -15,6 +15,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include "npp.hpp"
 
 namespace pg {
@@ -23,18 +25,18 @@ NPPSolver::NPPSolver(Oink * oink, Game * game) :
     Solver(oink, game),
     totqueries(0), totpromos(0), maxqueries(0), maxpromos(0), queries(0), promos(0), doms(0),
     maxprio(priority(nodecount() - 1)), strategy(game->strategy), inverse(new int[maxprio + 1]),
-    Top(0), End(0), Pivot(0)
+    Top(0), Pivot(0), Rend(0), exitstag(0)
 {
     uint resprio = maxprio / 20;
     resprio = (resprio >= 500) ? resprio : 500;
-    outgame.resize(nodecount());
     winzero.resize(nodecount());
-    Phase.reserve(resprio);
-    Supgame.reserve(resprio);
-    Heads.reserve(resprio);
-    Exits.reserve(resprio);
-    Entries.reserve(resprio);
-    R.resize(nodecount());
+    Stack.reserve(resprio);
+    stamp = new uint[nodecount()];
+    Regions = new uint[nodecount()];
+    Heads = new uint[nodecount()];
+    exitmark = new uint[nodecount()];
+    std::fill(exitmark, exitmark + nodecount(), 0);
+    O.resize(nodecount());
     T.resize(nodecount());
     E.resize(nodecount());
 }
@@ -42,15 +44,50 @@ NPPSolver::NPPSolver(Oink * oink, Game * game) :
 NPPSolver::~NPPSolver()
 {
     delete[] inverse;
-    delete Heads[0];
-    delete Exits[0];
-    delete Entries[0];
-    for (uint i = 1; i <= End; ++i)
+    delete[] stamp;
+    delete[] Regions;
+    delete[] Heads;
+    delete[] exitmark;
+}
+
+_INLINE_ bool NPPSolver::isoutgame(uint pos)
+{
+    return (stamp[pos] == 0);
+}
+
+_INLINE_ bool NPPSolver::isinsupgame(uint pos)
+{
+    return (stamp[pos] <= Top);
+}
+
+_INLINE_ bool NPPSolver::isinregion(uint pos)
+{
+    return (stamp[pos] == Top + 1);
+}
+
+_INLINE_ void NPPSolver::addtoregion(uint pos)
+{
+    stamp[pos] = Top + 1;
+    Regions[Rend++] = pos;
+}
+
+_INLINE_ uint NPPSolver::newexitstag()
+{
+    if (++exitstag == 0) // Tags wrapped around, forget all old tags
+    {
+        std::fill(exitmark, exitmark + nodecount(), 0);
+        exitstag = 1;
+    }
+    return (exitstag);
+}
+
+_INLINE_ void NPPSolver::addtoexits(uint pos)
+{
+    // Exits are only added to the pivot slot, which is the last one in the arena
+    if (exitmark[pos] != Stack[Pivot].exitsid)
     {
-        delete Supgame[i];
-        delete Heads[i];
-        delete Exits[i];
-        delete Entries[i];
+        exitmark[pos] = Stack[Pivot].exitsid;
+        Exits.push_back(pos);
     }
 }
 
@@ -58,9 +95,9 @@ _INLINE_ bool NPPSolver::isplayerclosed(uint pos)
 {
     for (auto curedge = outs(pos); *curedge != -1; curedge++) {
         int to = *curedge;
-        if (R[to])
+        if (isinregion(to))
         {
-            strategy[pos] = (!R[pos] || strategy[pos] == -1) ? to : strategy[pos];
+            strategy[pos] = (!isinregion(pos) || strategy[pos] == -1) ? to : strategy[pos];
             return (true);
         }
     }
@@ -72,7 +109,7 @@ _INLINE_ bool NPPSolver::isplayerclosedpromo(uint pos)
     for (auto curedge = outs(pos); *curedge != -1; curedge++)
     {
         int to = *curedge;
-        if (R[to])
+        if (isinregion(to))
         {
             strategy[pos] = to;
             return (true);
@@ -86,7 +123,7 @@ _INLINE_ bool NPPSolver::isopponentclosedongame(uint pos)
     for (auto curedge = outs(pos); *curedge != -1; curedge++)
     {
         int to = *curedge;
-        if (outgame[to] || R[to])
+        if (isoutgame(to) || isinregion(to))
         {
             continue;
         }
@@ -101,15 +138,14 @@ _INLINE_ bool NPPSolver::isopponentclosedongame(uint pos)
 
 _INLINE_ bool NPPSolver::isopponentclosedonsubgame(uint pos)
 {
-    auto & supgame = *(Supgame[Top]);
     for (auto curedge = outs(pos); *curedge != -1; curedge++)
     {
         int to = *curedge;
-        if (outgame[to] || R[to])
+        if (isoutgame(to) || isinregion(to))
         {
             continue;
         }
-        else if (supgame[to])
+        else if (isinsupgame(to))
         {
             E.push(to);
         }
@@ -119,10 +155,9 @@ _INLINE_ bool NPPSolver::isopponentclosedonsubgame(uint pos)
             return (false);
         }
     }
-    auto & exits = *(Exits[Pivot]);
     while (E.nonempty())
     {
-        exits[E.pop()] = true;
+        addtoexits(E.pop());
     }
     strategy[pos] = -1;
     return (true);
@@ -169,13 +204,13 @@ _INLINE_ void NPPSolver::pushinqueueongame(uint pos)
     for (auto curedge = ins(pos); *curedge != -1; curedge++)
     {
         int from = *curedge;
-        if (outgame[from] || R[from])
+        if (isoutgame(from) || isinregion(from))
         {
             continue;
         }
         else if ((uint) owner(from) == alpha)
         {
-            R[from] = true;
+            addtoregion(from);
             strategy[from] = pos;
             T.push(from);
         }
@@ -183,7 +218,7 @@ _INLINE_ void NPPSolver::pushinqueueongame(uint pos)
         {
             if (isopponentclosedongame(from))
             {
-                R[from] = true;
+                addtoregion(from);
                 T.push(from);
             }
         }
@@ -192,20 +227,14 @@ _INLINE_ void NPPSolver::pushinqueueongame(uint pos)
 
 bool NPPSolver::atrongame()
 {
-    auto & entries = *(Entries[Top]);
-    auto lend = entries.end();
-    for (auto liter = entries.begin(); liter != lend; ++liter)
+    const uint eend = Entries.size();
+    for (uint i = Stack[Top].entries; i < eend; ++i)
     {
-        auto & rdeque = *liter;
-        auto dend = rdeque.end();
-        for (auto diter = rdeque.begin(); diter != dend; ++diter)
+        pos = Entries[i];
+        if (!isinregion(pos) && isclosedongame(pos))
         {
-            pos = *diter;
-            if (!R[pos] && isclosedongame(pos))
-            {
-                R[pos] = true;
-                T.push(pos);
-            }
+            addtoregion(pos);
+            T.push(pos);
         }
     }
     if (T.nonempty())
@@ -225,25 +254,23 @@ bool NPPSolver::atrongame()
 
 _INLINE_ void NPPSolver::pushinqueueonsubgamedw(uint pos)
 {
-    auto & supgame = *(Supgame[Top]);
-    auto & entries = *(Entries[Top]->begin());
     for (auto curedge = ins(pos); *curedge != -1; curedge++)
     {
         int from = *curedge;
-        if (outgame[from])
+        if (isoutgame(from))
         {
             continue;
         }
-        else if (supgame[from])
+        else if (isinsupgame(from))
         {
-            entries.push_back(from);
+            Entries.push_back(from);
             continue;
         }
         else if ((uint) owner(from) == alpha)
         {
-            if (!R[from])
+            if (!isinregion(from))
             {
-                R[from] = true;
+                addtoregion(from);
                 strategy[from] = pos;
                 T.push(from);
             }
@@ -253,11 +280,11 @@ _INLINE_ void NPPSolver::pushinqueueonsubgamedw(uint pos)
                 strategy[from] = pos;
             }
         }
-        else if (!R[from])
+        else if (!isinregion(from))
         {
             if (isopponentclosedonsubgame(from))
             {
-                R[from] = true;
+                addtoregion(from);
                 T.push(from);
             }
         }
@@ -273,11 +300,10 @@ _INLINE_ void NPPSolver::pushinqueueonsubgamedw(uint pos)
 
 void NPPSolver::atronsubgamedw()
 {
-    auto & heads = *(Heads[Top]);
-    auto qend = heads.end();
-    for (auto qiter = heads.begin(); qiter != qend; ++qiter)
+    auto & slot = Stack[Top];
+    for (uint i = slot.heads; i < slot.headsend; ++i)
     {
-        pushinqueueonsubgamedw(*qiter);
+        pushinqueueonsubgamedw(Heads[i]);
     }
     while (T.nonempty())
     {
@@ -287,23 +313,21 @@ void NPPSolver::atronsubgamedw()
 
 _INLINE_ void NPPSolver::pushinqueueonsubgameup(uint pos)
 {
-    auto & supgame = *(Supgame[Top]);
-    auto & entries = *(Entries[Pivot]->begin());
     for (auto curedge = ins(pos); *curedge != -1; curedge++)
     {
         int from = *curedge;
-        if (outgame[from] || R[from])
+        if (isoutgame(from) || isinregion(from))
         {
             continue;
         }
-        else if (supgame[from])
+        else if (isinsupgame(from))
         {
-            entries.push_back(from);
+            Entries.push_back(from);
             continue;
         }
         else if ((uint) owner(from) == alpha)
         {
-            R[from] = true;
+            addtoregion(from);
             strategy[from] = pos;
             T.push(from);
         }
@@ -311,7 +335,7 @@ _INLINE_ void NPPSolver::pushinqueueonsubgameup(uint pos)
         {
             if (isopponentclosedonsubgame(from))
             {
-                R[from] = true;
+                addtoregion(from);
                 T.push(from);
             }
         }
@@ -320,21 +344,14 @@ _INLINE_ void NPPSolver::pushinqueueonsubgameup(uint pos)
 
 bool NPPSolver::atronsubgameup()
 {
-    auto & supgame = *(Supgame[Top]);
-    auto & entries = *(Entries[Pivot]);
-    auto lend = entries.end();
-    for (auto liter = entries.begin(); liter != lend; ++liter)
+    const uint eend = Entries.size();
+    for (uint i = Stack[Pivot].entries; i < eend; ++i)
     {
-        auto & rdeque = *liter;
-        auto dend = rdeque.end();
-        for (auto diter = rdeque.begin(); diter != dend; ++diter)
+        pos = Entries[i];
+        if (!isinsupgame(pos) && !isinregion(pos) && isclosedonsubgame(pos))
         {
-            pos = *diter;
-            if (!supgame[pos] && !R[pos] && isclosedonsubgame(pos))
-            {
-                R[pos] = true;
-                T.push(pos);
-            }
+            addtoregion(pos);
+            T.push(pos);
         }
     }
     if (T.nonempty())
@@ -352,68 +369,168 @@ bool NPPSolver::atronsubgameup()
     }
 }
 
-_INLINE_ void NPPSolver::goup()
+_INLINE_ void NPPSolver::initstack()
 {
-    D = *(Supgame[Top]) - *(Supgame[Top - 1]);
-    p = priority(Heads[--Top]->front());
-    beta = p & 1;
+    Top = Pivot = 0;
+    Rend = 0;
+    Entries.clear();
+    Exits.clear();
+    if (Stack.empty())
+    {
+        Stack.emplace_back();
+    }
+    auto & slot = Stack[0];
+    slot.phase = true;
+    slot.prio = p;
+    slot.region = 0;
+    slot.heads = slot.headsend = 0;
+    slot.entries = 0;
+    slot.exits = 0;
+    slot.exitsid = newexitstag();
 }
 
 _INLINE_ void NPPSolver::newstackslot()
 {
-    Phase.push_back(true);
-    Supgame.push_back(new bitset(R | *(Supgame[Top])));
-    Pivot = End = ++Top;
-    Heads.push_back(new uideque());
-    Exits.push_back(new bitset(nodecount()));
-    Entries.push_back(new uidlist());
-    Entries[Top]->push_front(uideque());
+    // The supgame of the new slot is implicit: the region of the current slot has stamp Top+1
+    Pivot = ++Top;
+    if (Top == Stack.size())
+    {
+        Stack.emplace_back();
+    }
+    auto & slot = Stack[Top];
+    slot.phase = true;
+    slot.region = Rend;
+    slot.heads = slot.headsend = Stack[Top - 1].headsend;
+    slot.entries = Entries.size();
+    slot.exits = Exits.size();
+    slot.exitsid = newexitstag();
 }
 
-_INLINE_ void NPPSolver::clearstackslot()
+_INLINE_ void NPPSolver::findtarget()
 {
-    Pivot = ++Top;
-    Phase[Top] = true;
-    *(Supgame[Top]) = *(Supgame[Top - 1]);
-    *(Supgame[Top]) |= R;
-    Heads[Top]->clear();
-    Exits[Top]->reset();
-    Entries[Top]->clear();
-    Entries[Top]->push_front(uideque());
+    // The target is the lowest region of player alpha above the pivot entered by some exit
+    Target = -1;
+    const uint xend = Exits.size();
+    for (uint i = Stack[Pivot].exits; i < xend; ++i)
+    {
+        uint s = stamp[Exits[i]];
+        if (s == 0 || s > Pivot) continue; // not in a region above the pivot (anymore)
+        int t = s - 1;
+        if (t > Target && (Stack[t].prio & 1) == alpha) Target = t;
+    }
 }
 
-_INLINE_ void NPPSolver::nextpriopos()
+_INLINE_ void NPPSolver::promote()
 {
-    auto & supgame = *(Supgame[Top]);
-    int pstar;
-    for (pstar = p - 1; inverse[pstar] == -1; --pstar)
+    // The exits of the pivot region that enter region D of the target are no exits anymore
+    uint to = Stack[Pivot].exits;
+    const uint xend = Exits.size();
+    for (uint i = to; i < xend; ++i)
     {
+        if (stamp[Exits[i]] != Top + 1) Exits[to++] = Exits[i];
     }
-    for (p = pstar, pos = inverse[p]; supgame[pos]; p = priority(--pos))
+    Exits.resize(to);
+
+    // The regions between the target and the pivot are dropped
+    const uint first = Stack[Top + 1].region;
+    const uint last = Stack[Pivot].region;
+    for (uint i = first; i < last; ++i)
     {
+        stamp[Regions[i]] = FREE;
     }
-    alpha = p & 1;
-    R.reset();
+
+    // The pivot region is merged with region D of the target
+    to = first;
+    for (uint i = last; i < Rend; ++i)
+    {
+        uint v = Regions[i];
+        stamp[v] = Top + 1;
+        Regions[to++] = v;
+    }
+    Rend = to;
 }
 
-_INLINE_ void NPPSolver::godwdw()
+_INLINE_ void NPPSolver::mergestackslot()
 {
-    Phase[Top] = false;
-    if (Top >= End) // A new stack slot needs to be allocated
+    // Exits of the target are the union of its exits and the exits of the pivot
+    auto & slot = Stack[Top];
+    uint tag = newexitstag();
+    uint to = slot.exits;
+    const uint tend = Stack[Top + 1].exits;
+    for (uint i = slot.exits; i < tend; ++i)
+    {
+        uint v = Exits[i];
+        if (exitmark[v] != tag)
+        {
+            exitmark[v] = tag;
+            Exits[to++] = v;
+        }
+    }
+    const uint xend = Exits.size();
+    for (uint i = Stack[Pivot].exits; i < xend; ++i)
     {
-        newstackslot();
+        uint v = Exits[i];
+        if (exitmark[v] != tag)
+        {
+            exitmark[v] = tag;
+            Exits[to++] = v;
+        }
     }
-    else // It can reuse some previous stack slot
+    Exits.resize(to);
+    slot.exitsid = tag;
+
+    // Potential entries of the pivot are appended to those of the target
+    auto eto = Entries.begin() + Stack[Top + 1].entries;
+    eto = std::copy(Entries.begin() + Stack[Pivot].entries, Entries.end(), eto);
+    Entries.erase(eto, Entries.end());
+
+    Pivot = Top;
+}
+
+_INLINE_ void NPPSolver::dropstack()
+{
+    // Only keep the current region, which becomes the region of slot 0
+    const uint first = Stack[Top].region;
+    for (uint i = 0; i < first; ++i)
     {
-        clearstackslot();
+        stamp[Regions[i]] = FREE;
     }
-    nextpriopos();
+    for (uint i = first; i < Rend; ++i)
+    {
+        stamp[Regions[i]] = 1;
+    }
+    std::copy(Regions + first, Regions + Rend, Regions);
+    Rend -= first;
+    Entries.erase(Entries.begin(), Entries.begin() + Stack[Top].entries);
+    Top = Pivot = 0;
 }
 
-_INLINE_ void NPPSolver::godwup()
+_INLINE_ void NPPSolver::goup()
+{
+    if (Top == Pivot)
+    {
+        findtarget();
+    }
+    p = Stack[--Top].prio;
+}
+
+_INLINE_ void NPPSolver::nextpriopos()
 {
-    Phase[Top] = false;
-    clearstackslot();
+    int pstar;
+    for (pstar = p - 1; inverse[pstar] == -1; --pstar)
+    {
+    }
+    for (p = pstar, pos = inverse[p]; isinsupgame(pos); p = priority(--pos))
+    {
+    }
+    alpha = p & 1;
+    Stack[Top].prio = p;
+}
+
+_INLINE_ void NPPSolver::godw()
+{
+    Stack[Top].phase = false;
+    newstackslot();
     nextpriopos();
 }
 
@@ -427,7 +544,7 @@ _INLINE_ void NPPSolver::search()
 
     while (true)
     {
-        if (Phase[Top])
+        if (Stack[Top].phase)
         {
 
             /* vv Update of the statistic on the number of queries vvvvvvvvvvvvvvvv */
@@ -435,17 +552,17 @@ _INLINE_ void NPPSolver::search()
             /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
             /* vv Search of region heads vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
-            auto & supgame = *(Supgame[Top]);
-            auto & heads = *(Heads[Top]);
+            auto & slot = Stack[Top];
             for (; pos >= 0 && (uint) priority(pos) == p; --pos) // Collect heads of the region
             {
-                if (!supgame[pos])
+                if (!isinsupgame(pos))
                 {
-                    R[pos] = true;
-                    heads.push_front(pos);
+                    addtoregion(pos);
+                    O[pos] = true; // Mark the heads of the new region as open heads
+                    Heads[slot.headsend++] = pos;
                 }
             }
-            O = R; // Mark the heads of the new region as open heads
+            std::reverse(Heads + slot.heads, Heads + slot.headsend); // Lowest head first
             /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
             /* vv Region construction via attractor vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
@@ -453,9 +570,18 @@ _INLINE_ void NPPSolver::search()
             /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
             /* vv Determine the successor state vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
-            if (O.none()) // No heads of the region are open
+            bool open = false;
+            for (uint i = slot.heads; i < slot.headsend; ++i) // Clear the open heads
+            {
+                if (O[Heads[i]])
+                {
+                    O[Heads[i]] = false;
+                    open = true;
+                }
+            }
+            if (!open) // No heads of the region are open
             {
-                if (Exits[Top]->none())
+                if (Exits.size() == slot.exits)
                 {
                     break; // Region closed in the whole game (i.e. it is dominion)
                 }
@@ -466,17 +592,16 @@ _INLINE_ void NPPSolver::search()
             }
             else
             {
-                godwdw(); // Region open, descend further
+                godw(); // Region open, descend further
             }
             /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
         }
         else
         {
-            auto & pivotexits = *(Exits[Pivot]);
-            if (alpha != beta || (D & pivotexits).none())
+            if ((int) Top != Target)
             {
-                goup(); // Target D is of the opponent or R cannot enter D (i.e., BEP not found yet), go further up
+                goup(); // Target is of the opponent or R cannot enter it (i.e., BEP not found yet), go further up
             }
             else // Target of the promotion found (BEP)
             {
@@ -487,19 +612,19 @@ _INLINE_ void NPPSolver::search()
                 /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
                 /* vv Region merging and maximization via attractor vvvvvvvvvvvvvvvvv */
-                R |= D;
+                promote();
                 atronsubgameup();
                 /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
                 /* vv Closure check vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
                 bool closed = true;
-                auto & heads = *(Heads[Top]);
-                while (!heads.empty())
+                auto & slot = Stack[Top];
+                while (slot.heads != slot.headsend)
                 {
-                    pos = heads.front();
+                    pos = Heads[slot.heads];
                     if (isclosedonsubgamepromo(pos))
                     {
-                        heads.pop_front();
+                        ++slot.heads;
                     }
                     else
                     {
@@ -509,22 +634,14 @@ _INLINE_ void NPPSolver::search()
                 }
                 /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
-                /* vv Update of promotion exists vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
-                pivotexits -= D;
-                *(Exits[Top]) |= pivotexits;
-                /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
-
-                /* vv Update of potential region entries vvvvvvvvvvvvvvvvvvvvvvvvvvvv */
-                auto & topentries = *(Entries[Top]);
-                auto & pivotentries = *(Entries[Pivot]);
-                topentries.splice(topentries.end(), pivotentries);
+                /* vv Update of promotion exits and potential region entries vvvvvvvv */
+                mergestackslot();
                 /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
                 /* vv Determine the successor state vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
-                Pivot = Top;
                 if (closed)
                 {
-                    if (Exits[Top]->none())
+                    if (Exits.size() == slot.exits)
                     {
                         break; // Region closed in the game (i.e. it is dominion)
                     }
@@ -535,7 +652,7 @@ _INLINE_ void NPPSolver::search()
                 }
                 else
                 {
-                    godwup(); // Region open, start new descent
+                    godw(); // Region open, start new descent
                 }
                 /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
@@ -557,6 +674,7 @@ _INLINE_ void NPPSolver::search()
     /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
     /* vv Dominion extension via attractor vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
+    dropstack();
     atrongame();
     /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
@@ -565,21 +683,12 @@ _INLINE_ void NPPSolver::search()
 void NPPSolver::run()
 {
 
-    /* vv Stack initialization vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
-    Phase.push_back(true);
-    Supgame.push_back(&outgame);
-    Heads.push_back(new uideque());
-    Exits.push_back(new bitset(nodecount()));
-    Entries.push_back(new uidlist());
-    Entries[0]->push_front(std::move(uideque()));
-    /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
-
     /* vv Initialization of pos and maxprio vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
     for (pos = nodecount() - 1;; --pos)
     {
         if (disabled[pos])
         {
-            outgame[pos] = true;
+            stamp[pos] = 0;
         }
         else
         {
@@ -589,7 +698,7 @@ void NPPSolver::run()
     }
     /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
-    /* vv Initialization of inverse, outgame, and strategy vvvvvvvvvvvvvvvvvvvv */
+    /* vv Initialization of inverse, stamps, and strategy vvvvvvvvvvvvvvvvvvvvv */
     for (uint prt = 0; prt <= maxprio; ++prt)
     {
         inverse[prt] = -1;
@@ -598,10 +707,11 @@ void NPPSolver::run()
     {
         if (disabled[sop])
         {
-            outgame[sop] = true;
+            stamp[sop] = 0;
         }
         else
         {
+            stamp[sop] = FREE;
             inverse[priority(sop)] = sop;
             strategy[sop] = -1;
         }
@@ -621,32 +731,29 @@ void NPPSolver::run()
         alpha = p & 1;
         /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
+        /* vv Stack and current region initialization vvvvvvvvvvvvvvvvvvvvvvvvvvv */
+        initstack();
+        /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
+
         /* vv Call to the search routine and update of the zero winning region vv */
         search();
-        outgame |= R;
-        if (alpha == 0)
+        for (uint i = 0; i < Rend; ++i)
         {
-            winzero |= R;
+            stamp[Regions[i]] = 0;
+            if (alpha == 0)
+            {
+                winzero[Regions[i]] = true;
+            }
         }
         /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
         /* vv Search for the new pos and maxprio vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
-        for (pos = inverse[maxprio]; pos >= 0 && outgame[pos]; --pos)
+        for (pos = inverse[maxprio]; pos >= 0 && isoutgame(pos); --pos)
         {
         }
         if (pos >= 0) maxprio = priority(pos);
         /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
-        /* vv Stack and current region cleaning vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv */
-        Top = Pivot = 0;
-        Phase[0] = true;
-        Heads[0]->clear();
-        Exits[0]->reset();
-        Entries[0]->clear();
-        Entries[0]->push_front(std::move(uideque()));
-        R.reset();
-        // /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
-
     }
     /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 
@@ -662,6 +769,9 @@ void NPPSolver::run()
     logger << "solved with " << totqueries << " total queries and " << totpromos << " total promotions;" << std::endl;
     logger << "            " << maxqueries << " max queries and " << maxpromos << " max promotions;" << std::endl;
     logger << "            " << doms << " dominions." << std::endl;
+    stats.count("queries", totqueries);
+    stats.count("promotions", totpromos);
+    stats.count("dominions", doms);
     /* ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ */
 }
 
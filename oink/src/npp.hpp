@@ -17,8 +17,6 @@
 #ifndef NPP_HPP
 #define NPP_HPP
 
-#include <list>
-#include <deque>
 #include <vector>
 
 #include "oink.hpp"
@@ -60,17 +58,22 @@ protected:
 
     typedef unsigned int uint;
 
-    typedef std::deque<uint> uideque;
+    typedef std::vector<uint> uivector;
 
-    typedef std::list<uideque> uidlist;
+    // Stack slot: the region at a level and the offsets of its data in the arenas
+    struct slot
+    {
+        bool phase;   // Phase of the slot
+        uint prio;    // Priority of the region
+        uint region;  // First position of the region in Regions
+        uint heads;   // First (remaining) head of the region in Heads
+        uint headsend; // End of the heads of the region in Heads
+        uint entries; // First potential entry of the region in Entries
+        uint exits;   // First promotion exit of the region in Exits
+        uint exitsid; // Tag of the promotion exits of the region (see exitmark)
+    };
 
-    typedef std::vector<bool> bvector;
-
-    typedef std::vector<uideque *> uidvector;
-
-    typedef std::vector<bitset *> bsvector;
-
-    typedef std::vector<uidlist *> uidlvector;
+    typedef std::vector<slot> slvector;
 
     /******************************************************************************/
 
@@ -101,8 +104,6 @@ protected:
 
     int * inverse;  // Maximal positions associated with the priorities
 
-    bitset outgame; // Positions whose winner has been already determined
-
     bitset winzero; // Positions already won by player zero
 
     /******************************************************************************/
@@ -111,19 +112,35 @@ protected:
     /* Stack fields                                                               */
     /******************************************************************************/
 
-    uint Top;           // Index of the current element within the vectors
-    uint End;           // Index of the last element within the vectors
-    uint Pivot;         // Index of the element associated with the region variables
+    /*
+     * The supgame of a slot is not stored as a bitset, but encoded by a depth
+     * stamp per position: a position in the region of slot i has stamp i+1,
+     * positions outside the game have stamp 0 and all other positions FREE.
+     * The supgame of slot i thus contains the positions with stamp <= i.
+     * The regions, heads, entries and exits of all slots are stored
+     * consecutively (slot by slot) in four arenas.
+     */
+
+    static const uint FREE = ~0U;
 
-    bvector Phase;      // Stack of phases
+    uint Top;           // Index of the current slot
+    uint Pivot;         // Index of the slot associated with the region variables
 
-    bsvector Supgame;   // Stack of supgames
+    slvector Stack;     // Stack of slots
 
-    uidvector Heads;    // Stack of region heads
+    uint * stamp;       // Depth stamp of each position
 
-    bsvector Exits;     // Stack of region promotion exits
+    uint * Regions;     // Arena of region positions
+    uint Rend;          // End of the used part of Regions
 
-    uidlvector Entries; // Stack of region potential entriers
+    uint * Heads;       // Arena of region heads
+
+    uivector Entries;   // Arena of region potential entries
+
+    uivector Exits;     // Arena of region promotion exits
+
+    uint * exitmark;    // Tag of the last promotion exits set each position was added to
+    uint exitstag;      // Last used promotion exits tag
 
     /******************************************************************************/
 
@@ -131,19 +148,15 @@ protected:
     /* Current region fields                                                      */
     /******************************************************************************/
 
-    bitset R;   // Positions in the current region
-
-    uint alpha; // Player of the current region R
+    uint alpha; // Player of the current region (positions with stamp Top+1)
 
     /******************************************************************************/
 
     /******************************************************************************/
-    /* Previous region fields                                                     */
+    /* Promotion fields                                                           */
     /******************************************************************************/
 
-    bitset D;   // Positions in the previous region upward along the stack
-
-    uint beta;  // Previous region player (player of region D)
+    int Target; // Index of the slot the pivot region is promoted to
 
     /******************************************************************************/
 
@@ -155,7 +168,7 @@ protected:
 
     uint p;       // Working priority
 
-    bitset O;     // Bitset of open heads of the current region R
+    bitset O;     // Bitset of open heads of the current region
 
     uintqueue T;  // Tail queue for positions waiting for attraction
 
@@ -191,12 +204,23 @@ private:
 
     // Go up/down functions
     inline void goup();
-    inline void godwdw();
-    inline void godwup();
+    inline void godw();
 
     // Top stack handler functions
+    inline void initstack();
     inline void newstackslot();
-    inline void clearstackslot();
+    inline void findtarget();
+    inline void promote();
+    inline void mergestackslot();
+    inline void dropstack();
+
+    // Stamp functions
+    inline bool isoutgame(uint pos);
+    inline bool isinsupgame(uint pos);
+    inline bool isinregion(uint pos);
+    inline void addtoregion(uint pos);
+    inline void addtoexits(uint pos);
+    inline uint newexitstag();
 
     // Next priority and position function
     inline void nextpriopos();
@@ -73,16 +73,18 @@ namespace pg
         // ___________________________________    
         
         // compute extended attractor, that may be empty
-        for (; n >= 0; n--){
-          if (priority(n) != pr) break;             // no more nodes in target
-          if (disabled[n] || !crnt.G[n]) continue;  // not in subgame
-          if (am[n]) continue;                      // already attracted
-
-          winning[n]  = pl;
-          strategy[n] = -1;
-
-          Q.push(n);
-          queued[n] = true;
+        // the target is the run of vertices of priority pr that ends at n
+        int lo = n+1;
+        while (lo > 0 && priority(lo-1) == pr) lo--;
+        crnt.G.for_each_reverse([&](size_t v){
+          if (disabled[v]) return;                  // not in subgame
+          if (am[v]) return;                        // already attracted
+
+          winning[v]  = pl;
+          strategy[v] = -1;
+
+          Q.push(v);
+          queued[v] = true;
           while (!Q.empty()){
             int cur = Q.pop();
             if (priority(cur) == pr) D.push_back(cur);
@@ -128,7 +130,8 @@ namespace pg
               }
             }
           }
-        }
+        }, lo, n+1);
+        n = lo-1;                                   // no more nodes in target
         
         crnt.G -= am;
         // increment stage counter
@@ -148,19 +151,18 @@ namespace pg
       else if (crnt.stage == 1)
       {
         // 3. compute opponent attractor
-        for (int i = nodecount()-1; i >= 0; i--){
-          if (disabled[i] || !crnt.G[i]) continue;  // not in subgame
-          if (!crnt.ao[i]) continue;                // not attracted
+        crnt.ao.for_each_reverse([&](size_t i){
+          if (disabled[i] || !crnt.G[i]) return;    // not in subgame
 
           u[i] = true;
 
           winning[i] = 1-pl;
           Q.push(i);
-        }
+        });
         while (!Q.empty()){
           int cur = Q.pop();
 
-          crnt.ao[cur] = true;
+          crnt.ao.set(cur);
 
           for (auto *from = ins(cur); *from != -1; from++){
             bool can_escape;
@@ -191,7 +193,7 @@ namespace pg
         }
 
         // 4. set opponent side attractor
-        agent->map(1-pl, 2, crnt.ao-u);
+        agent->map(1-pl, 2, crnt.ao.to_bitset()-u);
 
         // compute next child if needed.
         if (crnt.ao.any())
@@ -352,9 +354,9 @@ namespace pg
     // call the recursive algorithm
     struct stack_elem first;
     if (max_prio % 2 == 0) 
-    { first.v = nodecount()-1; first.d = max_prio, first.G = game; first.even = even; first.odd = agent->step_down(1); first.r = 0; first.stage = 0; }
+    { first.v = nodecount()-1; first.d = max_prio, first.G = pg::vertexset(game); first.even = even; first.odd = agent->step_down(1); first.r = 0; first.stage = 0; }
     else                   
-    { first.v = nodecount()-1; first.d = max_prio, first.G = game; first.even = agent->step_down(1); first.odd = odd; first.r = 0;  first.stage = 0; }
+    { first.v = nodecount()-1; first.d = max_prio, first.G = pg::vertexset(game); first.even = agent->step_down(1); first.odd = odd; first.r = 0;  first.stage = 0; }
 
     stack.push(first);
     // all the McNaughton-Zielonka method
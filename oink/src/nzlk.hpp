@@ -23,6 +23,7 @@
 #include "solver.hpp"
 #include "tools/ut/universal_tree.hpp"
 #include "uintqueue.hpp"
+#include "vertexset.hpp"
 
 namespace pg
 {
@@ -30,12 +31,12 @@ namespace pg
   struct stack_elem {
     int v;
     int d;
-    pg::bitset G;
+    pg::vertexset G;
     int even;
     int odd;
     int r;
     int stage;     // goes from 0 to 2
-    pg::bitset ao; // return value of the recursive step
+    pg::vertexset ao; // return value of the recursive step
   };
 
   class NZLKSolver : public Solver
@@ -23,8 +23,10 @@
 #include <chrono>
 
 #include "oink.hpp"
+#include "phases.hpp"
 #include "solvers.hpp"
 #include "solver.hpp"
+#include "subgame.hpp"
 #include "lace.h"
 
 namespace pg
@@ -38,7 +40,9 @@ namespace pg
         game.build_in_array(false);
 
         // initialize outcount (for flush)
-        outcount = new int[game.vertexcount()];
+        outcount = (int *)mem_alloc(sizeof(int[game.vertexcount()]));
+        if (outcount == NULL)
+            abort();
         for (int i = 0; i < game.vertexcount(); i++)
         {
             outcount[i] = 0;
@@ -53,290 +57,398 @@ namespace pg
 
     Oink::~Oink()
     {
-        delete[] outcount;
+        mem_free(outcount, sizeof(int[game->vertexcount()]));
     }
 
     /**
-     * Find all SCCs at priority p, game limited to nodes with priority <= p
-     * Then for every SCC that contains edges and a node with priority p, can win
-     * with priority p and is therefore a counterexample to the strategy.
+     * The state of solveTrivialCycles. Every vertex is in at most one region at a time,
+     * so the decompositions of different regions write to different vertices.
      */
-    int
-    Oink::solveTrivialCycles()
+    struct Oink::wcwc_state
     {
-        // Record number of trivial cycles
-        int count = 0;
-
-        // Allocate and initialize datastructures
-        const int n_nodes = game->vertexcount();
-        int *done = new int[n_nodes];
-        int64_t *low = new int64_t[n_nodes];
-        for (int i = 0; i < n_nodes; i++)
-            done[i] = disabled[i] ? -2 : -1;
-        for (int i = 0; i < n_nodes; i++)
-            low[i] = 0;
-
-        std::vector<int> res;
-        std::vector<int> scc;
-        std::stack<int> st;
-        std::queue<int> q;
+        wcwc_state(int n_vertices) : next_id(0), count(0)
+        {
+            nodes = new node[n_vertices];
+        }
 
-        int64_t pre = 0;
+        ~wcwc_state()
+        {
+            delete[] nodes;
+        }
 
-        for (int i = n_nodes - 1; i >= 0; i--)
+        // together, as the Tarjan search reads them for every edge
+        struct node
         {
-            if (disabled[i])
-                continue;
-            if (done[i] == -2)
-                continue; // already know to skip this
+            int region; // the region of the vertex, or -1
+            int index;  // Tarjan search, local to the region
+            int low;
+            int cycle;  // the strategy of a vertex in a winner-controlled winning cycle, or -1
+        };
 
-            /**
-             * We're going to search all winner-controlled SCCs reachable from node <i>
-             */
-            const int pr = game->priority(i);
-            const int pl = pr & 1;
+        node *nodes;
+        int next_id;  // the next region id
+        int count;    // the number of winning SCCs
+        std::vector<std::vector<int>> *large; // per worker, the large regions for the next round
+    };
 
-            /**
-             * Only start at unsolved winner-controlled and not yet seen for this priority
-             */
-            if (game->owner(i) != pl)
-            {
-                done[i] = -2; // highest priority but not winner-controlled, never check again
-                continue;
-            }
+    static const size_t REGION_SEQ = 4096; // regions up to this size are decomposed by the same worker
 
-            if (done[i] == pr)
-                continue; // already visited in this search
+    void
+    Oink::decomposeRegion(std::vector<int> &region, std::vector<std::vector<int>> *large)
+    {
+        OINK_PHASE("decomposeRegion");
+        wcwc_state &w = *wcwc;
 
-            /**
-             * Set bot to pre...
-             */
-            int64_t bot = pre;
+        std::vector<std::vector<int>> work;
+        work.push_back(std::move(region));
+
+        std::vector<int> res, scc;
+        std::vector<std::pair<int, const int *>> st; // vertex and next edge
+        std::queue<int> q;
+
+        while (!work.empty())
+        {
+            std::vector<int> vertices = std::move(work.back());
+            work.pop_back();
+
+            const int id = w.nodes[vertices[0]].region;
+            const int pl = game->owner(vertices[0]);
+            const int last = vertices.back();
+            for (int v : vertices)
+                w.nodes[v].index = 0;
+            int pre = 0;
 
             /**
-             * Start forward DFS at <i>
+             * Tarjan search in the region; a finished SCC leaves the region.
+             * Only SCCs with a priority of <pl> matter, so only start at those.
              */
-            st.push(i);
-            while (!st.empty())
+            for (int i : vertices)
             {
-                int idx = st.top();
+                if ((game->priority(i) & 1) != pl)
+                    continue;
+                if (w.nodes[i].region != id or w.nodes[i].index != 0)
+                    continue;
 
-                /**
-                 * When we see it for the first time, we assign the next number to it and add it to <res>.
-                 */
-                if (low[idx] <= bot)
+                w.nodes[i].index = w.nodes[i].low = ++pre;
+                res.push_back(i);
+                st.push_back(std::make_pair(i, game->outs(i)));
+
+                while (!st.empty())
                 {
-                    low[idx] = ++pre;
-                    if (pre < 0)
-                        LOGIC_ERROR; // overflow on a 64-bit integer...
-                    res.push_back(idx);
-                }
+                    const int v = st.back().first;
+                    const int *&curedge = st.back().second;
+                    bool pushed = false;
+                    for (; *curedge != -1; curedge++)
+                    {
+                        const int to = *curedge;
+                        // the owner and the bound are cheaper to check than the region
+                        if (to > last or game->owner(to) != pl or w.nodes[to].region != id)
+                            continue;
+                        if (w.nodes[to].index == 0)
+                        {
+                            // not visited, 'recurse' and return to this edge
+                            w.nodes[to].index = w.nodes[to].low = ++pre;
+                            res.push_back(to);
+                            st.push_back(std::make_pair(to, game->outs(to)));
+                            pushed = true;
+                            break;
+                        }
+                        if (w.nodes[to].low < w.nodes[v].low)
+                            w.nodes[v].low = w.nodes[to].low;
+                    }
+                    if (pushed)
+                        continue;
 
-                /**
-                 * Now we check all outgoing (allowed) edges.
-                 * If seen earlier, then update "min"
-                 * If new, then 'recurse'
-                 */
-                int min = low[idx];
-                bool pushed = false;
+                    st.pop_back();
+                    if (w.nodes[v].low != w.nodes[v].index)
+                    {
+                        // not the root, pass <low> to the parent
+                        const int parent = st.back().first;
+                        if (w.nodes[v].low < w.nodes[parent].low)
+                            w.nodes[parent].low = w.nodes[v].low;
+                        continue;
+                    }
 
-                auto ptr = game->outedges() + game->firstout(idx);
-                for (int to = *ptr; to != -1; to = *++ptr)
-                {
                     /**
-                     * Only go to lower priority nodes, controlled by <pl>, that are not excluded or seen this round.
+                     * We're the root of an scc. Move the scc from <res> to <scc>.
+                     * Record highest node, highest node of good parity.
                      */
-                    if (disabled[i])
-                        continue;
-                    if (to > i or done[to] == -2 or done[to] == pr or game->owner(to) != pl)
-                        continue;
-                    if (low[to] <= bot)
+                    int max_n = -1, max_n_pl = -1;
+                    for (;;)
                     {
-                        // not visited, add to <st> and break!
-                        st.push(to);
-                        pushed = true;
-                        break;
+                        const int n = res.back();
+                        res.pop_back();
+                        scc.push_back(n);
+                        if (max_n == -1 or game->priority(n) > game->priority(max_n))
+                            max_n = n;
+                        if ((game->priority(n) & 1) == pl and (max_n_pl == -1 or game->priority(n) > game->priority(max_n_pl)))
+                            max_n_pl = n;
+                        if (n == v)
+                            break;
                     }
-                    else
+
+                    const bool cycles = scc.size() > 1 or game->has_edge(v, v);
+                    if (!cycles or max_n_pl == -1)
                     {
-                        // visited, update min
-                        if (low[to] < min)
-                            min = low[to];
+                        // no cycle, or no cycle won by <pl>
+                        for (int n : scc)
+                            w.nodes[n].region = -1;
                     }
-                }
-                if (pushed)
-                    continue; // we pushed...
-
-                /**
-                 * If we're here, then there was no new edge and we check if we're the root of an SCC
-                 */
-                if (min < low[idx])
-                {
-                    // not the root
-                    low[idx] = min;
-                    st.pop();
-                    continue;
-                }
-
-                /**
-                 * We're the root of an scc. Move the scc from <res> to <scc>.
-                 * Record highest prio, highest prio of good parity, highest node of good parity.
-                 */
-                int max_pr = -1, max_pr_pl = -1, max_pr_n = -1;
-                for (;;)
-                {
-                    if (res.empty())
-                        LOGIC_ERROR;
-                    int n = res.back();
-                    res.pop_back();
-                    scc.push_back(n);
-                    done[n] = pr; // dont check again this round
-                    if (low[n] != min)
-                        low[n] = min; // set it [for strategy]
-                    int d = game->priority(n);
-                    if (d > max_pr)
-                        max_pr = d;
-                    if ((d & 1) == pl and d > max_pr_pl)
+                    else if (max_n == max_n_pl)
                     {
-                        max_pr_pl = d;
-                        max_pr_n = n;
+                        /**
+                         * OK, got a winner! Set strategies for all nodes in the SCC via backward search.
+                         */
+                        if (trace)
+                        {
+                            logger << "winner-controlled scc with win priority \033[1;34m" << game->priority(max_n) << "\033[m" << std::endl;
+                        }
+                        const int mark = __atomic_fetch_add(&w.next_id, 1, __ATOMIC_RELAXED);
+                        for (int n : scc)
+                            w.nodes[n].region = mark;
+                        q.push(max_n);
+                        while (!q.empty())
+                        {
+                            const int cur = q.front();
+                            q.pop();
+                            for (auto ptr = game->ins(cur); *ptr != -1; ptr++)
+                            {
+                                const int from = *ptr;
+                                if (w.nodes[from].region != mark or w.nodes[from].cycle != -1)
+                                    continue;
+                                w.nodes[from].cycle = cur;
+                                q.push(from);
+                            }
+                        }
+                        for (int n : scc)
+                            w.nodes[n].region = -1;
+                        __atomic_fetch_add(&w.count, 1, __ATOMIC_RELAXED);
                     }
-                    if (n == idx)
-                        break; // end when done
-                }
-
-                /**
-                 * Check if a single-node SCC without a self-loop
-                 */
-                if (scc.size() == 1)
-                {
-                    if (!game->has_edge(idx, idx))
+                    else
                     {
-                        // no self-loop
-                        done[idx] = -2; // never check again
-                        scc.clear();
-                        st.pop();
-                        continue;
+                        /**
+                         * The highest priority is not won by <pl>; the cycles won by <pl> are in the
+                         * new region of the nodes up to the highest priority of <pl>.
+                         */
+                        const int mark = __atomic_fetch_add(&w.next_id, 1, __ATOMIC_RELAXED);
+                        const int top = game->priority(max_n_pl);
+                        std::vector<int> sub;
+                        for (int n : scc)
+                        {
+                            if (game->priority(n) <= top)
+                            {
+                                w.nodes[n].region = mark;
+                                sub.push_back(n);
+                            }
+                            else
+                            {
+                                w.nodes[n].region = -1;
+                            }
+                        }
+                        // in increasing order, as the vertices of the game
+                        std::reverse(sub.begin(), sub.end());
+                        if (large != NULL and sub.size() > REGION_SEQ)
+                            large->push_back(std::move(sub));
+                        else
+                            work.push_back(std::move(sub));
                     }
+                    scc.clear();
                 }
+            }
 
-                /**
-                 * Check if the highest priority in the SCC is actually won by <pl>.
-                 */
+            // the vertices that were not reached leave the region
+            for (int v : vertices)
+            {
+                if (w.nodes[v].region == id)
+                    w.nodes[v].region = -1;
+            }
+        }
+    }
 
-                if ((max_pr & 1) != pl)
-                {
-                    for (auto n : scc)
-                        if (game->priority(n) > max_pr_pl)
-                            done[n] = -2; // never check again
-                    scc.clear();
-                    st.pop();
-                    continue;
-                    // Note that this SCC will be found again in lower runs, but without offending nodes.
-                }
+    void _decompose_region(Oink *s, std::vector<int> *region, int worker)
+    {
+        s->decomposeRegion(*region, s->wcwc->large + worker);
+    }
 
-                /**
-                 * OK, got a winner!
-                 */
+    VOID_TASK_3(decompose_regions, Oink *, s, std::vector<int> *, regions, int, count)
+    {
+        if (count > 1)
+        {
+            SPAWN(decompose_regions, s, regions, count / 2);
+            CALL(decompose_regions, s, regions + count / 2, count - count / 2);
+            SYNC(decompose_regions);
+        }
+        else
+        {
+            _decompose_region(s, regions, LACE_WORKER_ID);
+        }
+    }
 
-                if (trace)
-                {
-                    logger << "winner-controlled scc with win priority \033[1;34m" << max_pr << "\033[m" << std::endl;
-                }
+    /**
+     * Find all SCCs of winner-controlled nodes where the highest priority is won by the controller.
+     * Every vertex in such an SCC is in a winning cycle, and every winning cycle is in such an SCC
+     * of the nodes up to the priority of the cycle. So: decompose the nodes of each player into SCCs,
+     * solve the SCCs where the player wins the highest priority, and decompose the others again
+     * without their nodes with a priority above the highest priority of the player.
+     * The regions are independent, so with Lace they are decomposed in parallel, in rounds.
+     */
+    int
+    Oink::solveTrivialCycles()
+    {
+        OINK_PHASE("solveTrivialCycles");
+        const int n_nodes = game->vertexcount();
+        wcwc_state w(n_nodes);
+        wcwc = &w;
+
+        // the first regions are the enabled vertices of each player, up to its highest priority
+        int top[2] = {-1, -1};
+        for (int v = 0; v < n_nodes; v++)
+        {
+            if (!disabled[v] and game->owner(v) == (game->priority(v) & 1))
+                top[game->owner(v)] = v;
+        }
+        std::vector<std::vector<int>> regions(2);
+        for (int v = 0; v < n_nodes; v++)
+        {
+            w.nodes[v].cycle = -1;
+            if (disabled[v] or v > top[game->owner(v)])
+            {
+                w.nodes[v].region = -1;
+            }
+            else
+            {
+                w.nodes[v].region = game->owner(v);
+                regions[game->owner(v)].push_back(v);
+            }
+        }
+        w.next_id = 2;
+        regions.erase(std::remove_if(regions.begin(), regions.end(), [](const std::vector<int> &r) { return r.empty(); }), regions.end());
 
-                // Set strategies for all nodes in the SCC via backward search
-                q.push(max_pr_n);
-                while (!q.empty())
+        // the trace is written sequentially
+        const int n_workers = trace ? 0 : lace_workers();
+        if (workers >= 0 and n_workers > 0)
+        {
+            w.large = new std::vector<std::vector<int>>[n_workers];
+            while (!regions.empty())
+            {
+                RUN(decompose_regions, this, regions.data(), (int)regions.size());
+                regions.clear();
+                for (int i = 0; i < n_workers; i++)
                 {
-                    int cur = q.front();
-                    q.pop();
-                    auto ptr = game->inedges() + game->firstin(cur);
-                    for (int from = *ptr; from != -1; from = *++ptr)
-                    {
-                        if (low[from] != min or disabled[from])
-                            continue;
-                        solve(from, pl, cur); // also sets "disabled"
-                        q.push(from);
-                    }
+                    for (auto &r : w.large[i])
+                        regions.push_back(std::move(r));
+                    w.large[i].clear();
                 }
-                flush(); // this triggers attraction of every winner-controlled node in the stack...
-
-                /**
-                 * For obvious reasons, all nodes on the stack are now solved.
-                 */
-                while (!st.empty())
-                    st.pop();
-                res.clear();
-                scc.clear();
-                count++;
             }
+            delete[] w.large;
         }
+        else
+        {
+            for (auto &r : regions)
+                decomposeRegion(r, NULL);
+        }
+        wcwc = NULL;
+
+        for (int v = 0; v < n_nodes; v++)
+        {
+            if (w.nodes[v].cycle != -1)
+                solve(v, game->owner(v), w.nodes[v].cycle);
+        }
+        if (w.count != 0)
+            flush();
 
-        delete[] done;
-        delete[] low;
-        return count;
+        return w.count;
     }
 
-    int
-    Oink::solveSelfloops()
+    void
+    Oink::sweepVertices(int first, int count)
     {
-        int res = 0;
-        for (int v = 0; v < game->vertexcount(); v++)
+        int found = 0;
+        for (int v = first; v < first + count; v++)
         {
             if (disabled[v])
                 continue; // skip vertices that are hidden
 
+            found |= 1 << (game->priority(v) & 1);
+
             if (game->has_edge(v, v))
             {
                 if (game->owner(v) == (game->priority(v) & 1))
-                {
-                    // a winning selfloop
-                    if (trace)
-                        logger << "winning self-loop with priority \033[1;34m" << game->priority(v) << "\033[m" << std::endl;
-                    solve(v, game->owner(v), v);
-                    res++;
-                }
-                else
-                {
-                    // a losing selfloop
-                    if (game->outcount(v) == 1)
-                    {
-                        // it is a losing dominion
-                        solve(v, 1 - game->owner(v), -1);
-                        res++;
-                    }
-                }
+                    loops[v] = 1; // a winning selfloop
+                else if (game->outcount(v) == 1)
+                    loops[v] = 2; // a losing selfloop, it is a losing dominion
             }
         }
+        if ((__atomic_load_n(&parities, __ATOMIC_RELAXED) & found) != found)
+            __atomic_fetch_or(&parities, found, __ATOMIC_RELAXED);
+    }
 
-        if (res != 0)
-            flush();
-        return res;
+    void _sweep_vertices(Oink *s, int first, int count)
+    {
+        s->sweepVertices(first, count);
     }
 
-    bool
-    Oink::solveSingleParity()
+    VOID_TASK_3(sweep_vertices, Oink *, s, int, first, int, count)
     {
-        int parity = -1;
+        if (count > 4096)
+        {
+            SPAWN(sweep_vertices, s, first + count / 2, count - count / 2);
+            CALL(sweep_vertices, s, first, count / 2);
+            SYNC(sweep_vertices);
+        }
+        else
+        {
+            _sweep_vertices(s, first, count);
+        }
+    }
+
+    void
+    Oink::sweepVertices()
+    {
+        OINK_PHASE("sweepVertices");
+        const int n_vertices = game->vertexcount();
+        parities = 0;
+        loops.assign(n_vertices, 0);
+        if (workers >= 0 and lace_workers() != 0)
+            RUN(sweep_vertices, this, 0, n_vertices);
+        else
+            sweepVertices(0, n_vertices);
+    }
+
+    int
+    Oink::solveSelfloops()
+    {
+        int res = 0;
         for (int v = 0; v < game->vertexcount(); v++)
         {
-            if (disabled[v])
-                continue;
-            if (parity == -1)
+            if (loops[v] == 1)
             {
-                parity = game->priority(v) & 1;
+                // a winning selfloop
+                if (trace)
+                    logger << "winning self-loop with priority \033[1;34m" << game->priority(v) << "\033[m" << std::endl;
+                solve(v, game->owner(v), v);
+                res++;
             }
-            else if (parity == (game->priority(v) & 1))
+            else if (loops[v] == 2)
             {
-                continue;
-            }
-            else
-            {
-                return false;
+                // a losing dominion
+                solve(v, 1 - game->owner(v), -1);
+                res++;
             }
         }
-        if (parity == 0 or parity == 1)
+        std::vector<char>().swap(loops);
+
+        if (res != 0)
+            flush();
+        return res;
+    }
+
+    bool
+    Oink::solveSingleParity()
+    {
+        if (parities == 1 or parities == 2)
         {
+            const int parity = parities >> 1;
             // solved with random strategy
             logger << "parity game only has parity " << (parity ? "odd" : "even") << std::endl;
             for (int v = 0; v < game->vertexcount(); v++)
@@ -366,7 +478,7 @@ namespace pg
         }
         else
         {
-            // all disabled
+            // both parities, or all disabled
             return false;
         }
     }
@@ -398,11 +510,19 @@ namespace pg
     Oink::flush()
     {
         // the <todo> queue contains vertex that are marked as solved
+        OINK_PHASE("flush");
+
+        if (workers >= 0 and todo.nonempty() and lace_workers() != 0)
+        {
+            flushPar();
+            return;
+        }
 
         while (todo.nonempty())
         {
             int v = todo.pop();
             bool winner = game->winner[v];
+            OINK_COUNT("flush attracted", 1);
 
             for (auto curedge = game->ins(v); *curedge != -1; curedge++)
             {
@@ -424,6 +544,95 @@ namespace pg
         }
     }
 
+    static const size_t FLUSH_LOCAL = 4096; // newly solved vertices a worker keeps for itself per round
+
+    void
+    Oink::flushVertices(const int *vertices, int count, std::vector<int> &next)
+    {
+        OINK_PHASE("flushVertices");
+        std::vector<int> local(vertices, vertices + count);
+
+        while (!local.empty())
+        {
+            const int v = local.back();
+            local.pop_back();
+            OINK_COUNT("flush attracted", 1);
+            const int winner = game->winner.atomic_test(v);
+
+            for (auto curedge = game->ins(v); *curedge != -1; curedge++)
+            {
+                const int from = *curedge;
+                if (disabled.atomic_test(from))
+                    continue;
+                // claim <from> by disabling it, as solve() would; only one worker succeeds
+                if (game->owner(from) == winner)
+                {
+                    // node of winner, <v> was solved before <from>, so the strategies stay acyclic
+                    if (!disabled.atomic_set(from))
+                        continue;
+                    game->strategy[from] = v;
+                }
+                else
+                {
+                    // node of loser, the worker that removes the last edge claims it
+                    if (__atomic_sub_fetch(&outcount[from], 1, __ATOMIC_RELAXED) != 0 or !disabled.atomic_set(from))
+                        continue;
+                    game->strategy[from] = -1;
+                }
+                game->solved.atomic_set(from);
+                if (winner)
+                    game->winner.atomic_set(from);
+                else
+                    game->winner.atomic_reset(from);
+                if (local.size() < FLUSH_LOCAL)
+                    local.push_back(from);
+                else
+                    next.push_back(from);
+            }
+        }
+    }
+
+    void _flush_vertices(Oink *s, const int *vertices, int count, std::vector<int> *next)
+    {
+        s->flushVertices(vertices, count, *next);
+    }
+
+    VOID_TASK_4(flush_vertices, Oink *, s, const int *, vertices, int, count, std::vector<int> *, next)
+    {
+        if (count > 64)
+        {
+            SPAWN(flush_vertices, s, vertices + count / 2, count - count / 2, next);
+            CALL(flush_vertices, s, vertices, count / 2, next);
+            SYNC(flush_vertices);
+        }
+        else
+        {
+            _flush_vertices(s, vertices, count, next + LACE_WORKER_ID);
+        }
+    }
+
+    void
+    Oink::flushPar()
+    {
+        std::vector<int> frontier(&todo[0], &todo[0] + todo.size());
+        todo.clear();
+
+        // every worker attracts to its part of the frontier, and passes the vertices it
+        // cannot keep to the next round; this also works from a Lace worker
+        const int n_workers = lace_workers();
+        std::vector<std::vector<int>> next(n_workers);
+        while (!frontier.empty())
+        {
+            RUN(flush_vertices, this, frontier.data(), (int)frontier.size(), next.data());
+            frontier.clear();
+            for (auto &n : next)
+            {
+                frontier.insert(frontier.end(), n.begin(), n.end());
+                n.clear();
+            }
+        }
+    }
+
     void
     Oink::setSolver(int solverid)
     {
@@ -469,16 +678,32 @@ namespace pg
                 for (int i : sel)
                     disabled[i] = false;
 
+                // a small SCC is solved on a copy, so the solver only sees its own edges
+                SubgameView view(*game, sel);
                 logger << "solving bottom SCC of " << sel.size() << " nodes (";
-                logger << game->count_unsolved() << " nodes left)" << std::endl;
+                logger << game->count_unsolved() << " nodes left)";
+                logger << (view.compact() ? " as a subgame" : "") << std::endl;
 
-                // solve current subgame
-                Solver *s = solvers.construct(solver, this, game);
-                s->run();
-                delete s;
+                if (view.compact())
+                {
+                    solveSubgame(view);
+                }
+                else
+                {
+                    // solve current subgame
+                    Solver *s = solvers.construct(solver, this, game);
+                    {
+                        OINK_PHASE("solver");
+                        s->run();
+                    }
+                    stats.add(s->stats);
+                    stats.count("solver_runs");
+                    delete s;
+                }
 
-                // flush the todo buffer
+                // flush the todo buffer, then attract the rest of the game
                 flush();
+                flushSubgame(view);
             } while (!game->game_solved());
         }
         else
@@ -491,10 +716,15 @@ namespace pg
                 // solve current subgame
                 Solver *s = solvers.construct(solver, this, game);
                 bool full_solver = s->full_solver();
-                s->run();
+                {
+                    OINK_PHASE("solver");
+                    s->run();
+                }
+                stats.add(s->stats);
+                stats.count("solver_runs");
                 delete s;
 
-                if (full_solver)
+                if (full_solver and !compactionDue())
                 {
                     // trash the todo buffer
                     todo.clear();
@@ -508,16 +738,177 @@ namespace pg
                     logger << c << " nodes left." << std::endl;
                     if (c == 0)
                         return;
+
+                    if (compactionDue())
+                    {
+                        // most edges lead to solved vertices now, continue on a compacted copy
+                        bitset mask(game->solved);
+                        mask.flip();
+                        SubgameView view(*game, mask);
+                        logger << "compacting the game to " << c << " nodes." << std::endl;
+                        solveSubgame(view);
+                        flush();
+                        return;
+                    }
                 }
             } while (true);
         }
     }
 
+    bool
+    Oink::compactionDue() const
+    {
+        // in bottom SCC mode, small SCCs are already solved on a copy
+        if (!compaction or bottomSCC)
+            return false;
+        const long c = game->count_unsolved();
+        return c != 0 and c * SubgameView::COMPACT_RATIO <= game->vertexcount();
+    }
+
+    void
+    Oink::solveSubgame(const SubgameView &view)
+    {
+        Game *sub = view.materialize();
+        {
+            Oink en(*sub, logger);
+            en.solver = solver;
+            en.workers = workers;
+            en.trace = trace;
+            en.compaction = compaction;
+            en.solveLoop();
+            stats.add(en.stats);
+        }
+        stats.count("subgames");
+
+        for (auto w = sub->solved.find_first(); w != bitset::npos; w = sub->solved.find_next(w))
+        {
+            const int str = sub->strategy[w];
+            solve(view.to_parent(w), sub->winner[w], str == -1 ? -1 : view.to_parent(str));
+        }
+        delete sub;
+    }
+
+    void
+    Oink::flushSubgame(const SubgameView &view)
+    {
+        disabled = game->solved;
+
+        // the rest of the game was disabled while the subgame was solved and flushed
+        for (int v : view.vertices())
+        {
+            if (!game->solved[v])
+                continue;
+            const bool winner = game->winner[v];
+            for (auto curedge = game->ins(v); *curedge != -1; curedge++)
+            {
+                const int from = *curedge;
+                if (disabled[from] or view.contains(from))
+                    continue;
+                if (game->owner(from) == winner)
+                    solve(from, winner, v);
+                else if (--outcount[from] == 0)
+                    solve(from, winner, -1);
+            }
+        }
+
+        flush();
+    }
+
+    void
+    Oink::reportLace()
+    {
+        if (!laceStats or lace_workers() == 0)
+            return;
+        if (!lace_count_enabled())
+        {
+            logger << "Lace counters are not compiled in, configure with -DOINK_LACE_STATS=ON" << std::endl;
+            return;
+        }
+
+        const auto precision = logger.precision();
+        lace_count_t total = {};
+        for (unsigned int w = 0; w < lace_workers(); w++)
+        {
+            lace_count_t c;
+            lace_count_worker(w, &c);
+            logger << "lace worker " << w << ": " << c.tasks << " tasks, ";
+            logger << c.steals << "/" << c.steal_tries << " steals, " << c.leaps << "/" << c.leap_tries << " leaps, ";
+            logger << std::fixed << std::setprecision(2) << c.work_ms << " ms work, " << c.idle_ms << " ms idle" << std::endl;
+            stats.time("lace_idle_" + std::to_string(w), c.idle_ms / 1000);
+            total.tasks += c.tasks;
+            total.steals += c.steals;
+            total.steal_tries += c.steal_tries;
+            total.leaps += c.leaps;
+            total.leap_tries += c.leap_tries;
+            total.work_ms += c.work_ms;
+            total.idle_ms += c.idle_ms;
+        }
+        logger << "lace total: " << total.tasks << " tasks, ";
+        logger << total.steals << "/" << total.steal_tries << " steals, " << total.leaps << "/" << total.leap_tries << " leaps, ";
+        logger << std::fixed << std::setprecision(2) << total.work_ms << " ms work, " << total.idle_ms << " ms idle" << std::endl;
+        logger.precision(precision);
+
+        stats.count("lace_tasks", total.tasks);
+        stats.count("lace_steals", total.steals);
+        stats.count("lace_failed_steals", total.steal_tries - total.steals);
+        stats.count("lace_leaps", total.leaps);
+        stats.count("lace_failed_leaps", total.leap_tries - total.leaps);
+        stats.time("lace_work", total.work_ms / 1000);
+        stats.time("lace_idle", total.idle_ms / 1000);
+    }
+
+    /**
+     * With work stealing, any worker can visit any vertex, so the default policy interleaves
+     * the pages over the nodes instead of placing them by the first touch of the workers.
+     */
+    void
+    Oink::placeArrays(void)
+    {
+        mem_policy policy = memPolicy;
+        if (memAuto)
+        {
+            policy.pages = mem_policy::PAGES_THP;
+            policy.place = numa_nodes() > 1 ? mem_policy::PLACE_INTERLEAVE : mem_policy::PLACE_DEFAULT;
+        }
+        if (policy.is_default())
+            return;
+
+        auto time_before = std::chrono::high_resolution_clock::now();
+        set_mem_policy(policy);
+        game->place_arrays();
+        const size_t bytes = sizeof(int[game->vertexcount()]);
+        outcount = (int *)mem_move(outcount, bytes, bytes);
+        {
+            bitset b(disabled);
+            disabled.swap(b);
+        }
+        double diff = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - time_before).count();
+        logger << "memory policy " << policy.str() << " (" << numa_nodes() << " NUMA nodes), moving arrays took "
+               << std::fixed << std::setprecision(6) << diff << " sec." << std::endl;
+        stats.time("place_arrays", diff);
+    }
+
     void
     Oink::run()
     {
         using namespace std::chrono;
         auto time_before = high_resolution_clock::now();
+        stats.clear();
+
+        /**
+         * Start Lace if we are parallel, for the preprocessing and for parallel solvers
+         * - if -w [0..N] and Lace is not running, start Lace
+         * - if -w -1, run sequential
+         */
+        bool started = false;
+        if (workers >= 0 and lace_workers() == 0)
+        {
+            lace_start(workers, 0);
+            started = true;
+            logger << "initialized Lace with " << lace_workers() << " workers" << std::endl;
+        }
+        if (laceStats and lace_workers() != 0)
+            lace_count_reset();
 
         /**
          * Now inflate / compress / renumber...
@@ -550,36 +941,57 @@ namespace pg
             flush();
         }
 
-        if (solveSingle and solveSingleParity())
+        /**
+         * Solve single parity games and self-loops, with one sweep over the vertices
+         */
+        if (solveSingle or removeLoops)
         {
-            // already reported in solveSingleParity
-            auto time_after = high_resolution_clock::now();
-            double diff = duration_cast<duration<double>>(time_after - time_before).count();
-            logger << "preprocessing took " << std::fixed << std::setprecision(6) << diff << " sec." << std::endl;
-            logger << "solved by preprocessor." << std::endl;
-            return;
-        }
+            auto time_sweep = high_resolution_clock::now();
+            sweepVertices();
 
-        if (removeLoops)
-        {
-            int count = solveSelfloops();
-            if (count == 0)
-                logger << "no self-loops removed." << std::endl;
-            else if (count == 1)
-                logger << "1 self-loops removed." << std::endl;
-            else
-                logger << count << " self-loops removed." << std::endl;
+            if (solveSingle and solveSingleParity())
+            {
+                // already reported in solveSingleParity
+                auto time_after = high_resolution_clock::now();
+                double diff = duration_cast<duration<double>>(time_after - time_before).count();
+                logger << "preprocessing took " << std::fixed << std::setprecision(6) << diff << " sec." << std::endl;
+                logger << "solved by preprocessor." << std::endl;
+                stats.time("preprocessing", diff);
+                reportLace();
+                if (started)
+                    lace_stop();
+                return;
+            }
+
+            if (removeLoops)
+            {
+                int count = solveSelfloops();
+                stats.count("self_loops", count);
+                if (count == 0)
+                    logger << "no self-loops removed." << std::endl;
+                else if (count == 1)
+                    logger << "1 self-loops removed." << std::endl;
+                else
+                    logger << count << " self-loops removed." << std::endl;
+            }
+
+            double diff = duration_cast<duration<double>>(high_resolution_clock::now() - time_sweep).count();
+            logger << "single parity and self-loop check took " << std::fixed << std::setprecision(6) << diff << " sec." << std::endl;
         }
 
         if (removeWCWC)
         {
+            auto time_wcwc = high_resolution_clock::now();
             int count = solveTrivialCycles();
+            stats.count("trivial_cycles", count);
             if (count == 0)
                 logger << "no trivial cycles removed." << std::endl;
             else if (count == 1)
                 logger << "1 trivial cycle removed." << std::endl;
             else
                 logger << count << " trivial cycles removed." << std::endl;
+            double diff = duration_cast<duration<double>>(high_resolution_clock::now() - time_wcwc).count();
+            logger << "trivial cycle check took " << std::fixed << std::setprecision(6) << diff << " sec." << std::endl;
         }
 
         auto time_mid = high_resolution_clock::now();
@@ -589,12 +1001,19 @@ namespace pg
             double preprocess_time = duration_cast<duration<double>>(time_mid - time_before).count();
             logger << "preprocessing took " << std::fixed << std::setprecision(6) << preprocess_time << " sec." << std::endl;
             logger << "solved by preprocessor." << std::endl;
+            stats.time("preprocessing", preprocess_time);
+            reportLace();
+            if (started)
+                lace_stop();
             return;
         }
 
         if (solver == -1)
         {
             logger << "no solver selected!" << std::endl;
+            reportLace();
+            if (started)
+                lace_stop();
             return;
         }
 
@@ -602,10 +1021,7 @@ namespace pg
         time_mid = high_resolution_clock::now();
 
         /**
-         * Start Lace if we are parallel
-         * - if parallel solver, -w [0..N] and Lace is not running, start Lace
-         * - if parallel solver, -w -1, run sequential anyway
-         * - if sequential solver, run sequantial
+         * Run the solver, in Lace if it is parallel and we are parallel
          */
 
         Solvers solvers;
@@ -613,20 +1029,16 @@ namespace pg
 
         if (solvers.isParallel(solver))
         {
-            if (workers >= 0)
+            if (lace_workers() > 1)
+                placeArrays();
+            if (started)
             {
-                if (lace_workers() == 0)
-                {
-                    lace_start(workers, 0);
-                    logger << "initialized Lace with " << lace_workers() << " workers" << std::endl;
-                    RUN(solve_loop, this);
-                    lace_stop();
-                }
-                else
-                {
-                    logger << "running parallel (Lace already initialized)" << std::endl;
-                    solveLoop();
-                }
+                RUN(solve_loop, this);
+            }
+            else if (workers >= 0)
+            {
+                logger << "running parallel (Lace already initialized)" << std::endl;
+                solveLoop();
             }
             else
             {
@@ -636,14 +1048,27 @@ namespace pg
         }
         else
         {
+            // do not keep idle workers next to a sequential solver
+            if (started)
+            {
+                reportLace();
+                lace_stop();
+            }
+            started = false;
             solveLoop();
         }
 
+        reportLace();
+        if (started)
+            lace_stop();
+
         auto time_after = high_resolution_clock::now();
         double preprocess_time = duration_cast<duration<double>>(time_mid - time_before).count();
         logger << "preprocessing took " << std::fixed << std::setprecision(6) << preprocess_time << " sec." << std::endl;
         double solving_time = duration_cast<duration<double>>(time_after - time_mid).count();
         logger << "solving took " << std::fixed << std::setprecision(6) << solving_time << " sec." << std::endl;
+        stats.time("preprocessing", preprocess_time);
+        stats.time("solving", solving_time);
     }
 
 }
\ No newline at end of file
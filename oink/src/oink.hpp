@@ -22,12 +22,15 @@
 
 #include "error.hpp"
 #include "game.hpp"
+#include "mempolicy.hpp"
+#include "stats.hpp"
 #include "uintqueue.hpp"
 
 namespace pg
 {
 
     class Solver;
+    class SubgameView;
 
     class Oink
     {
@@ -100,12 +103,39 @@ namespace pg
          */
         void setBottomSCC(bool val) { bottomSCC = val; }
 
+        /**
+         * Instruct Oink whether to continue on a compacted copy of the unsolved subgame, when
+         * at most 1/4 of the vertices is unsolved after a solver stops or flushes a dominion
+         * (see compactionDue). The solver then no longer skips the edges of solved vertices.
+         * (Default true)
+         */
+        void setCompaction(bool val) { compaction = val; }
+
         /**
          * Set the number of workers for parallel solvers (psi and zielonka).
          * -1 for sequential code, 0 for autodetect.
          */
         void setWorkers(int count) { workers = count; }
 
+        /**
+         * Instruct Oink whether to report the tasks, steals, leaps and idle time of the Lace
+         * workers after run(), if Lace is built with counters (cmake -DOINK_LACE_STATS=ON).
+         * (Default false)
+         */
+        void setLaceStats(bool val) { laceStats = val; }
+
+        /**
+         * Set the memory policy for the arrays of the game and the solver, when a parallel
+         * solver runs with more than one worker. By default, Oink uses transparent huge pages,
+         * interleaved over the NUMA nodes if there is more than one.
+         * The policy stays in effect for later allocations in the process.
+         */
+        void setMemPolicy(const mem_policy &policy)
+        {
+            memPolicy = policy;
+            memAuto = false;
+        }
+
         /**
          * Set verbosity level (0 = normal, 1 = trace, 2 = debug)
          */
@@ -123,7 +153,34 @@ namespace pg
          */
         void flush(void);
 
+        /**
+         * Returns true if Oink would continue on a compacted copy of the unsolved subgame
+         * (see setCompaction). Solvers that flush dominions while they run may then return
+         * from run() early; Oink runs them again on the copy.
+         */
+        bool compactionDue(void) const;
+
+        /**
+         * Returns the statistics of the last run(): the counters and timers of the solver,
+         * summed over its runs, and those of Oink, such as the preprocessing and solving time.
+         */
+        const Stats &getStats() const { return stats; }
+
     protected:
+        /**
+         * Parallel flush, in rounds of Lace tasks. Workers claim vertices by disabling them
+         * atomically and count down <outcount> atomically. The attracted vertices are the same
+         * as with the sequential flush, the strategies can differ, but are valid.
+         */
+        void flushPar(void);
+
+        /**
+         * Attract to the <count> solved vertices at <vertices>, for flushPar.
+         * Newly solved vertices that the worker does not attract to itself are added to <next>.
+         */
+        void flushVertices(const int *vertices, int count, std::vector<int> &next);
+        friend void _flush_vertices(Oink *, const int *, int, std::vector<int> *); // access point from a Lace worker
+
         /**
          * Solve winner-controlled winning cycles.
          * Returns number of cycles solved.
@@ -131,13 +188,29 @@ namespace pg
         int solveTrivialCycles(void);
 
         /**
-         * Resolve self-loops.
+         * Decompose <region>, a set of vertices of one player, into SCCs, for solveTrivialCycles.
+         * SCCs won by the player are recorded; of the others, the vertices up to the highest
+         * priority of the player are a new region, which is decomposed here, or added to <large>
+         * if it has many vertices and <large> is not NULL.
+         */
+        void decomposeRegion(std::vector<int> &region, std::vector<std::vector<int>> *large);
+        friend void _decompose_region(Oink *, std::vector<int> *, int); // access point from a Lace worker
+
+        /**
+         * Sweep over the vertices for solveSingleParity and solveSelfloops, in parallel if Lace runs.
+         */
+        void sweepVertices(void);
+        void sweepVertices(int first, int count);
+        friend void _sweep_vertices(Oink *, int, int); // access point from a Lace worker
+
+        /**
+         * Resolve self-loops, after sweepVertices.
          * Returns number of resolved self-loops.
          */
         int solveSelfloops(void);
 
         /**
-         * Solve single parity games.
+         * Solve single parity games, after sweepVertices.
          * Returns true if the game was solved as a single parity game.
          */
         bool solveSingleParity(void);
@@ -167,6 +240,30 @@ namespace pg
         void solveLoop(void);
         friend void _solve_loop(Oink *); // access point from a Lace worker
 
+        /**
+         * Solve the subgame <view> on a materialized copy, with the solver of this Oink,
+         * and mark its vertices as solved. Call flush() afterwards.
+         */
+        void solveSubgame(const SubgameView &view);
+
+        /**
+         * After solving and flushing the subgame <view> with the rest of the game disabled,
+         * enable the unsolved vertices again and attract them to the solved vertices of <view>.
+         */
+        void flushSubgame(const SubgameView &view);
+
+        /**
+         * Apply the memory policy (see setMemPolicy) and move the arrays of the game and of
+         * Oink to it, before a parallel solver runs.
+         */
+        void placeArrays(void);
+
+        /**
+         * Report the Lace counters since the start of run() to the logger and the statistics,
+         * if requested and Lace is running.
+         */
+        void reportLace(void);
+
         Game *game;              // game being solved
         std::ostream &logger;    // logger for trace/debug messages
         int solver = -1;         // which solver to use
@@ -179,6 +276,18 @@ namespace pg
         bool removeWCWC = true;  // solve winner-controlled winning cycles before solving
         bool solveSingle = true; // solve games with only 1 parity
         bool bottomSCC = false;  // solve per bottom SCC
+        bool compaction = true;  // solve the rest on a compacted copy when most vertices are solved
+        bool laceStats = false;  // report the Lace counters of run()
+        mem_policy memPolicy;    // memory policy for parallel solvers
+        bool memAuto = true;     // choose the memory policy for parallel solvers
+
+        struct wcwc_state;
+        wcwc_state *wcwc = NULL; // state of solveTrivialCycles
+
+        int parities = 0;        // sweepVertices: bit 0 (1) if an enabled vertex has an even (odd) priority
+        std::vector<char> loops; // sweepVertices: 1 for a winning self-loop, 2 for a losing dominion
+
+        Stats stats;     // statistics of run()
 
         uintqueue todo;  // internal queue for solved nodes for flushing
         int *outcount;   // number of unsolved outgoing edges per node (for fast attraction)
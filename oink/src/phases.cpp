@@ -0,0 +1,193 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "phases.hpp"
+#include "lace.h"
+
+namespace pg
+{
+
+    namespace phases
+    {
+
+        static const size_t MAX_EVENTS = 1 << 22; // per thread, later phases are dropped
+
+        struct event
+        {
+            const char *name;
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        /**
+         * The recordings of one thread. The buffers outlive their threads, as Lace
+         * workers are stopped before the trace is written.
+         */
+        struct buffer
+        {
+            int tid;     // 0 for other threads, 1+N for Lace worker N
+            std::vector<event> events;
+            std::vector<std::pair<const char *, long>> counters;
+            long dropped = 0;
+        };
+
+        static std::mutex registry_lock;
+        static std::vector<buffer *> registry;
+        static thread_local buffer *local = NULL;
+
+        static buffer *
+        get_buffer()
+        {
+            if (local == NULL)
+            {
+                local = new buffer();
+                WorkerP *w = lace_get_worker();
+                local->tid = w == NULL ? 0 : 1 + w->worker;
+                std::lock_guard<std::mutex> guard(registry_lock);
+                registry.push_back(local);
+            }
+            return local;
+        }
+
+        bool
+        enabled()
+        {
+            return OINK_PHASES;
+        }
+
+        uint64_t
+        now()
+        {
+            using namespace std::chrono;
+            return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        void
+        record(const char *name, uint64_t begin, uint64_t end)
+        {
+            buffer *b = get_buffer();
+            if (b->events.size() < MAX_EVENTS)
+                b->events.push_back({name, begin, end});
+            else
+                b->dropped++;
+        }
+
+        void
+        count(const char *name, long value)
+        {
+            buffer *b = get_buffer();
+            for (auto &c : b->counters)
+            {
+                if (c.first == name)
+                {
+                    c.second += value;
+                    return;
+                }
+            }
+            b->counters.emplace_back(name, value);
+        }
+
+        void
+        clear()
+        {
+            std::lock_guard<std::mutex> guard(registry_lock);
+            for (buffer *b : registry)
+            {
+                b->events.clear();
+                b->counters.clear();
+                b->dropped = 0;
+            }
+        }
+
+        static void
+        write_us(std::ostream &out, uint64_t ns)
+        {
+            out << ns / 1000 << "." << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+        }
+
+        void
+        write_chrome_trace(std::ostream &out)
+        {
+            std::lock_guard<std::mutex> guard(registry_lock);
+
+            // timestamps are relative to the first recorded phase
+            uint64_t first = UINT64_MAX, last = 0;
+            std::map<int, bool> tids;
+            std::map<std::string, long> counters;
+            long dropped = 0;
+            for (buffer *b : registry)
+            {
+                for (auto &e : b->events)
+                {
+                    first = std::min(first, e.begin);
+                    last = std::max(last, e.end);
+                }
+                for (auto &c : b->counters)
+                    counters[c.first] += c.second;
+                if (!b->events.empty())
+                    tids[b->tid] = true;
+                dropped += b->dropped;
+            }
+            if (first > last)
+                first = last = 0;
+
+            out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+            bool comma = false;
+            for (auto &t : tids)
+            {
+                out << (comma ? ",\n" : "") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << t.first;
+                if (t.first == 0)
+                    out << ", \"args\": {\"name\": \"main\"}}";
+                else
+                    out << ", \"args\": {\"name\": \"lace worker " << t.first - 1 << "\"}}";
+                comma = true;
+            }
+            for (buffer *b : registry)
+            {
+                for (auto &e : b->events)
+                {
+                    out << (comma ? ",\n" : "") << "{\"name\": \"" << e.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << b->tid << ", \"ts\": ";
+                    write_us(out, e.begin - first);
+                    out << ", \"dur\": ";
+                    write_us(out, e.end - e.begin);
+                    out << "}";
+                    comma = true;
+                }
+            }
+            // the counters are totals, reported at the end of the trace
+            if (dropped != 0)
+                counters["dropped phases"] += dropped;
+            for (auto &c : counters)
+            {
+                out << (comma ? ",\n" : "") << "{\"name\": \"" << c.first << "\", \"ph\": \"C\", \"pid\": 0, \"ts\": ";
+                write_us(out, last - first);
+                out << ", \"args\": {\"value\": " << c.second << "}}";
+                comma = true;
+            }
+            out << std::endl << "]}" << std::endl;
+        }
+
+    }
+
+}
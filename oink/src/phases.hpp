@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PHASES_HPP
+#define PHASES_HPP
+
+#include <cstdint>
+#include <ostream>
+
+#ifndef OINK_PHASES
+#define OINK_PHASES 0
+#endif
+
+namespace pg
+{
+
+    /**
+     * Phase timers and event counters for the hot spots of Oink and the solvers.
+     *
+     * OINK_PHASE("name") times the rest of the enclosing scope, OINK_COUNT("name", n) adds
+     * <n> to a counter. Both are only compiled in with OINK_PHASES (cmake -DOINK_PHASES=ON),
+     * otherwise they cost nothing. Names must be string literals.
+     * Every thread records to its own buffer; Lace workers each get their own timeline.
+     */
+    namespace phases
+    {
+
+        /**
+         * Returns true if phase timers are compiled in.
+         */
+        bool enabled();
+
+        /**
+         * Write all recorded phases and counters in the Chrome trace event format,
+         * for chrome://tracing, Perfetto or speedscope (as a flame chart per thread).
+         */
+        void write_chrome_trace(std::ostream &out);
+
+        /**
+         * Discard all recorded phases and counters. Not thread safe, so only call this
+         * when no solver runs.
+         */
+        void clear();
+
+        uint64_t now();
+        void record(const char *name, uint64_t begin, uint64_t end);
+        void count(const char *name, long value);
+
+        class scope
+        {
+        public:
+            scope(const char *name) : name(name), begin(now()) {}
+            ~scope() { record(name, begin, now()); }
+
+        private:
+            const char *name;
+            uint64_t begin;
+        };
+
+    }
+
+}
+
+#if OINK_PHASES
+#define OINK_PHASE_CAT2(a, b) a##b
+#define OINK_PHASE_CAT(a, b) OINK_PHASE_CAT2(a, b)
+#define OINK_PHASE(name) pg::phases::scope OINK_PHASE_CAT(_oink_phase_, __LINE__)(name)
+#define OINK_COUNT(name, value) pg::phases::count(name, value)
+#else
+#define OINK_PHASE(name) do {} while (0)
+#define OINK_COUNT(name, value) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2017-2018 Tom van Dijk, Johannes Kepler University Linz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <sched.h>
+
+#include "pmlift.hpp"
+#include "lace.h"
+#include "phases.hpp"
+
+namespace pg {
+
+PMLifter::PMLifter(Game *game, const bitset &disabled, Client *client) :
+        game(game), disabled(disabled), client(client)
+{
+    n = game->nodecount();
+    nworkers = lace_workers();
+    if (nworkers == 0) nworkers = 1;
+
+    frontier.resize(nworkers);
+    stats = new counters[nworkers];
+    for (int w=0; w<nworkers; w++) {
+        stats[w].lift_count = 0;
+        stats[w].lift_attempt = 0;
+    }
+
+    dirty = new uint64_t[(n+63)/64];
+    memset(dirty, 0, sizeof(uint64_t[(n+63)/64]));
+    seq = new unsigned[n];
+    memset(seq, 0, sizeof(unsigned[n]));
+}
+
+PMLifter::~PMLifter()
+{
+    delete[] stats;
+    delete[] dirty;
+    delete[] seq;
+}
+
+/**
+ * Set the dirty bit of <node>, return true if it was not yet set.
+ */
+bool
+PMLifter::mark(int node)
+{
+    const uint64_t bit = 1ULL << (node & 63);
+    return (__atomic_fetch_or(dirty + (node >> 6), bit, __ATOMIC_ACQ_REL) & bit) == 0;
+}
+
+void
+PMLifter::unmark(int node)
+{
+    const uint64_t bit = 1ULL << (node & 63);
+    __atomic_fetch_and(dirty + (node >> 6), ~bit, __ATOMIC_ACQ_REL);
+}
+
+void
+PMLifter::push(int node)
+{
+    if (!mark(node)) return;
+    pending++;
+    // not round-robin: when run() lifts on one worker, it must see all vertices in FIFO order
+    frontier.push(0, node);
+}
+
+void
+PMLifter::work(int worker)
+{
+    OINK_PHASE("pmlift");
+    counters &wl = stats[worker];
+    while (!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+        unsigned int node;
+        if (!frontier.pop(worker, node)) {
+            if (__atomic_load_n(&pending, __ATOMIC_ACQUIRE) == 0) break;
+            // let the workers that still have vertices run, in case we share a core
+            sched_yield();
+            continue;
+        }
+
+        // clear the dirty bit first, so a concurrent increase of <node> queues it again
+        unmark(node);
+        const int *curedge = game->inedges() + game->firstin(node);
+        for (; *curedge != -1; curedge++) {
+            int from = *curedge;
+            if (disabled[from]) continue;
+            wl.lift_attempt++;
+            if (client->parlift(worker, from, node)) {
+                wl.lift_count++;
+                if (mark(from)) {
+                    __atomic_add_fetch(&pending, 1, __ATOMIC_ACQ_REL);
+                    frontier.push(worker, from);
+                }
+            }
+        }
+        __atomic_sub_fetch(&pending, 1, __ATOMIC_ACQ_REL);
+
+        // stop all workers when our share of the budget is used up
+        if (budget != -1 and wl.lift_count * nworkers >= budget) __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+    }
+    OINK_COUNT("lifts", wl.lift_count);
+}
+
+VOID_TASK_1(pmlift_work, PMLifter*, engine)
+{
+    engine->work(LACE_WORKER_ID);
+}
+
+void
+PMLifter::run(int64_t budget)
+{
+    lift_count = lift_attempt = 0;
+    if (pending == 0) return;
+
+    this->budget = budget;
+    stop = 0;
+
+    // the vertices pushed from outside are in the tail chunk of the first worker, share them
+    frontier.flush();
+
+    // waking all workers costs more than lifting a handful of vertices on one
+    if (lace_workers() <= 1 or pending < 64*nworkers) work(0);
+    else TOGETHER(pmlift_work, this);
+
+    for (int w=0; w<nworkers; w++) {
+        lift_count += stats[w].lift_count;
+        lift_attempt += stats[w].lift_attempt;
+        stats[w].lift_count = stats[w].lift_attempt = 0;
+    }
+    steals = frontier.steals();
+}
+
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2017-2018 Tom van Dijk, Johannes Kepler University Linz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PMLIFT_HPP
+#define PMLIFT_HPP
+
+#include <cstdint>
+#include <sched.h>
+
+#include "game.hpp"
+#include "uintfrontier.hpp"
+
+namespace pg {
+
+/**
+ * Parallel lifting engine for the progress measure solvers.
+ *
+ * Lifting is monotone, so the fixed point does not depend on the order in which vertices
+ * are lifted, and all Lace workers can lift at the same time (chaotic iteration).
+ * The vertices whose measure increased are in a uintfrontier; every worker pops a vertex and
+ * lifts all its predecessors, pushing those that increased. Idle workers steal chunks of the
+ * frontier of other workers. A vertex is queued at most once, guarded by an atomic dirty bit,
+ * and the engine stops when no vertex is queued or being processed.
+ *
+ * The measures themselves belong to the solver. Every vertex has a sequence lock:
+ * read() takes a consistent snapshot of the measure of a vertex, and a solver performs
+ * a max-update by comparing and writing between lock() and unlock().
+ *
+ * Strategies need care: a solver that skips recomputing the best successor when <target>
+ * is not the current strategy must only write a strategy after checking, while holding the
+ * lock, that the chosen successor is unchanged() since it was read. Otherwise a stale
+ * strategy can hide a later increase of the chosen successor. The solver must read the
+ * strategy of <node> after the snapshot of <node>, so it sees a strategy written under lock.
+ */
+class PMLifter
+{
+public:
+    /**
+     * Implemented by the solver.
+     * Lift <node> after the measure of its successor <target> increased, on <worker>.
+     * Must be thread safe and return true iff the measure of <node> increased.
+     */
+    class Client
+    {
+    public:
+        virtual ~Client() { }
+        virtual bool parlift(int worker, int node, int target) = 0;
+    };
+
+    PMLifter(Game *game, const bitset &disabled, Client *client);
+    ~PMLifter();
+
+    /**
+     * Number of workers, i.e., the number of scratch areas the client needs.
+     */
+    int workers() { return nworkers; }
+
+    /**
+     * Queue <node> for the next run(). Only call this outside run().
+     * The vertices are queued on the first worker, in order; the others steal them.
+     */
+    void push(int node);
+
+    /**
+     * Lift until no more vertices are queued, using all Lace workers.
+     * With a <budget>, stop after about that many lifts; the next run() continues.
+     */
+    void run(int64_t budget = -1);
+
+    /**
+     * Returns true if no vertices are queued.
+     */
+    bool empty() { return pending == 0; }
+
+    /**
+     * Wait for and take the sequence lock of <node> before updating its measure.
+     */
+    inline void lock(int node)
+    {
+        unsigned *s = seq + node;
+        while (true) {
+            unsigned cur = __atomic_load_n(s, __ATOMIC_RELAXED);
+            if ((cur & 1) == 0 and __atomic_compare_exchange_n(s, &cur, cur+1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) return;
+            sched_yield(); // the owner of the lock may be waiting for our core
+        }
+    }
+
+    /**
+     * Release the sequence lock of <node>, publishing the new measure.
+     */
+    inline void unlock(int node)
+    {
+        __atomic_store_n(seq + node, seq[node]+1, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Copy the <len> values at <src>, the measure of <node>, consistently to <dst>.
+     * Returns the version of the copy, for unchanged().
+     */
+    template <typename T>
+    inline unsigned read(int node, T *dst, const T *src, int len)
+    {
+        const unsigned *s = seq + node;
+        while (true) {
+            unsigned before = __atomic_load_n(s, __ATOMIC_ACQUIRE);
+            if (before & 1) {
+                sched_yield(); // being written
+                continue;
+            }
+            for (int i=0; i<len; i++) dst[i] = __atomic_load_n(src + i, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(s, __ATOMIC_ACQUIRE) == before) return before;
+        }
+    }
+
+    /**
+     * Returns true if the measure of <node> was not written since read() returned <version>.
+     * Call this while holding the lock of <locked>, which may be <node> itself.
+     */
+    inline bool unchanged(int node, unsigned version, int locked)
+    {
+        if (node == locked) version++;
+        return __atomic_load_n(seq + node, __ATOMIC_ACQUIRE) == version;
+    }
+
+    int64_t lift_count = 0;   // successful parlift calls in the last run()
+    int64_t lift_attempt = 0; // parlift calls in the last run()
+    int64_t steals = 0;       // successful steals, over all runs
+
+    void work(int worker); // the loop of each worker, called from a Lace task
+
+protected:
+    /**
+     * Statistics of a worker, aligned to cache lines as every worker updates its own.
+     */
+    struct alignas(64) counters {
+        int64_t lift_count;
+        int64_t lift_attempt;
+    };
+
+    Game *game;
+    const bitset &disabled;
+    Client *client;
+
+    int n;
+    int nworkers;
+
+    uintfrontier frontier;
+    counters *stats;
+    uint64_t *dirty;          // one bit per vertex, set while the vertex is queued
+    unsigned *seq;            // sequence lock per vertex
+    int64_t pending = 0;      // queued vertices plus vertices being processed
+    int64_t budget = -1;      // lifts allowed in the current run(), or -1
+    int stop = 0;             // set when the budget is used up
+
+    bool mark(int node);
+    void unmark(int node);
+};
+
+}
+
+#endif
@@ -0,0 +1,226 @@
+/*
+ * Copyright 2017-2018 Tom van Dijk, Johannes Kepler University Linz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PMSIMD_HPP
+#define PMSIMD_HPP
+
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PM_SIMD_X86
+#endif
+
+namespace pg {
+
+/**
+ * Kernels for packed progress measures: <k> unsigned components of type T per measure,
+ * the components of player <pl> at indices pl, pl+2, pl+4, ... as in SPM.
+ *
+ * pm_diff returns the highest index i >= d of player <pl> where a and b differ, or -1.
+ * pm_prog sets the components i >= d of player <pl> of dst to those of src and the
+ * components i < d to 0, leaving the components of the other player alone.
+ *
+ * The vector kernels work on bytes, so they serve every T. The AVX2 kernels load and store
+ * whole 32-byte blocks, so measures must be followed by at least 32 readable bytes, and
+ * the destination of pm_prog by 32 writable bytes.
+ */
+
+enum pm_isa { PM_SCALAR = 0, PM_AVX2 = 1, PM_AVX512 = 2 };
+
+static inline int
+pm_isa_detect()
+{
+#ifdef PM_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) return PM_AVX512;
+    if (__builtin_cpu_supports("avx2")) return PM_AVX2;
+#endif
+    return PM_SCALAR;
+}
+
+static inline const char *
+pm_isa_name(int isa)
+{
+    return isa == PM_AVX512 ? "avx512" : isa == PM_AVX2 ? "avx2" : "scalar";
+}
+
+template <typename T>
+static inline int
+pm_diff_scalar(const T *a, const T *b, int k, int d, int pl)
+{
+    const int start = ((k&1) == pl) ? k-2 : k-1;
+    for (int i=start; i>=d; i-=2) {
+        if (a[i] != b[i]) return i;
+    }
+    return -1;
+}
+
+template <typename T>
+static inline void
+pm_prog_scalar(T *dst, const T *src, int k, int d, int pl)
+{
+    int i = pl;
+    for (; i<d; i+=2) dst[i] = 0;
+    for (; i<k; i+=2) dst[i] = src[i];
+}
+
+#ifdef PM_SIMD_X86
+
+/**
+ * Bit mask of the bytes of player <pl> in a block, for components of <size> bytes.
+ */
+static inline uint64_t
+pm_parity_bytes(int size, int pl)
+{
+    const uint64_t even = size == 1 ? 0x5555555555555555ULL : size == 2 ? 0x3333333333333333ULL : 0x0F0F0F0F0F0F0F0FULL;
+    return pl ? even << size : even;
+}
+
+/**
+ * Bit mask of bytes <lo> (inclusive) to <hi> (exclusive) of a block of <width> bytes.
+ */
+static inline uint64_t
+pm_range_bytes(int lo, int hi, int width)
+{
+    if (lo < 0) lo = 0;
+    if (hi > width) hi = width;
+    if (lo >= hi) return 0;
+    const uint64_t upto = hi == 64 ? ~0ULL : (1ULL << hi) - 1;
+    return upto & (~0ULL << lo);
+}
+
+template <typename T>
+__attribute__ ((target ("avx512bw")))
+static inline int
+pm_diff_avx512(const T *a, const T *b, int k, int d, int pl)
+{
+    const int s = sizeof(T);
+    const int lo = d*s, n = k*s;
+    const uint64_t par = pm_parity_bytes(s, pl);
+    // start with the block of the highest components
+    for (int base = (n-1) & ~63; base >= 0 and base + 64 > lo; base -= 64) {
+        const __mmask64 m = pm_range_bytes(lo-base, n-base, 64) & par;
+        const __m512i va = _mm512_maskz_loadu_epi8(m, (const char*)a + base);
+        const __m512i vb = _mm512_maskz_loadu_epi8(m, (const char*)b + base);
+        const uint64_t ne = _mm512_mask_cmpneq_epu8_mask(m, va, vb);
+        if (ne) return (base + 63 - __builtin_clzll(ne)) / s;
+    }
+    return -1;
+}
+
+template <typename T>
+__attribute__ ((target ("avx512bw")))
+static inline void
+pm_prog_avx512(T *dst, const T *src, int k, int d, int pl)
+{
+    const int s = sizeof(T);
+    const int lo = d*s, n = k*s;
+    const uint64_t par = pm_parity_bytes(s, pl);
+    for (int base = 0; base < n; base += 64) {
+        const uint64_t copy = pm_range_bytes(lo-base, n-base, 64) & par;
+        const uint64_t zero = pm_range_bytes(-base, (lo < n ? lo : n)-base, 64) & par;
+        // masked-off bytes load as 0, so one masked store writes both the copies and the zeroes
+        const __m512i v = _mm512_maskz_loadu_epi8(copy, (const char*)src + base);
+        _mm512_mask_storeu_epi8((char*)dst + base, copy | zero, v);
+    }
+}
+
+/**
+ * Expand a 32-bit mask to a vector with 0xFF in the selected bytes.
+ */
+__attribute__ ((target ("avx2")))
+static inline __m256i
+pm_expand_avx2(uint32_t m)
+{
+    const __m256i select = _mm256_setr_epi64x(0x0000000000000000LL, 0x0101010101010101LL, 0x0202020202020202LL, 0x0303030303030303LL);
+    const __m256i bits = _mm256_set1_epi64x(0x8040201008040201LL);
+    const __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32(m), select);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(v, bits), bits);
+}
+
+template <typename T>
+__attribute__ ((target ("avx2")))
+static inline int
+pm_diff_avx2(const T *a, const T *b, int k, int d, int pl)
+{
+    const int s = sizeof(T);
+    const int lo = d*s, n = k*s;
+    const uint32_t par = (uint32_t)pm_parity_bytes(s, pl);
+    // start with the block of the highest components
+    for (int base = (n-1) & ~31; base >= 0 and base + 32 > lo; base -= 32) {
+        const uint32_t m = (uint32_t)pm_range_bytes(lo-base, n-base, 32) & par;
+        const __m256i va = _mm256_loadu_si256((const __m256i*)((const char*)a + base));
+        const __m256i vb = _mm256_loadu_si256((const __m256i*)((const char*)b + base));
+        const uint32_t ne = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)) & m;
+        if (ne) return (base + 31 - __builtin_clz(ne)) / s;
+    }
+    return -1;
+}
+
+template <typename T>
+__attribute__ ((target ("avx2")))
+static inline void
+pm_prog_avx2(T *dst, const T *src, int k, int d, int pl)
+{
+    const int s = sizeof(T);
+    const int lo = d*s, n = k*s;
+    const uint32_t par = (uint32_t)pm_parity_bytes(s, pl);
+    for (int base = 0; base < n; base += 32) {
+        const uint32_t copy = (uint32_t)pm_range_bytes(lo-base, n-base, 32) & par;
+        const uint32_t zero = (uint32_t)pm_range_bytes(-base, (lo < n ? lo : n)-base, 32) & par;
+        const __m256i vs = _mm256_loadu_si256((const __m256i*)((const char*)src + base));
+        const __m256i vd = _mm256_loadu_si256((const __m256i*)((char*)dst + base));
+        __m256i v = _mm256_blendv_epi8(vd, vs, pm_expand_avx2(copy));
+        v = _mm256_andnot_si256(pm_expand_avx2(zero), v);
+        _mm256_storeu_si256((__m256i*)((char*)dst + base), v);
+    }
+}
+
+#endif
+
+/**
+ * Dispatch to the kernel for <isa>, see pm_isa_detect().
+ */
+template <typename T>
+static inline int
+pm_diff(int isa, const T *a, const T *b, int k, int d, int pl)
+{
+#ifdef PM_SIMD_X86
+    if (isa == PM_AVX512) return pm_diff_avx512(a, b, k, d, pl);
+    if (isa == PM_AVX2) return pm_diff_avx2(a, b, k, d, pl);
+#else
+    (void)isa;
+#endif
+    return pm_diff_scalar(a, b, k, d, pl);
+}
+
+template <typename T>
+static inline void
+pm_prog(int isa, T *dst, const T *src, int k, int d, int pl)
+{
+#ifdef PM_SIMD_X86
+    if (isa == PM_AVX512) return pm_prog_avx512(dst, src, k, d, pl);
+    if (isa == PM_AVX2) return pm_prog_avx2(dst, src, k, d, pl);
+#else
+    (void)isa;
+#endif
+    pm_prog_scalar(dst, src, k, d, pl);
+}
+
+}
+
+#endif
@@ -22,6 +22,7 @@
 #include <cassert>
 
 #include "pp.hpp"
+#include "phases.hpp"
 
 namespace pg {
 
@@ -36,6 +37,8 @@ PPSolver::~PPSolver()
 void
 PPSolver::attract(int prio)
 {
+    OINK_PHASE("attract");
+
     const int pl = prio & 1;
     auto &rv = regions[prio];
 
@@ -358,6 +361,11 @@ PPSolver::run()
                 } else if (res == -1) {
                     // found dominion
                     setDominion(p);
+                    // continue on a compacted copy if most vertices are solved
+                    if (oink->compactionDue()) {
+                        i = -1;
+                        break;
+                    }
                     // restart algorithm and break inner loop
                     i = nodecount() - 1;
                     break;
@@ -381,6 +389,7 @@ PPSolver::run()
     delete[] inverse;
 
     logger << "solved with " << promotions << " promotions." << std::endl;
+    stats.count("promotions", promotions);
 }
 
 void
@@ -99,6 +99,11 @@ PPPSolver::run()
                 } else if (res == -1) {
                     // found dominion, return
                     setDominion(p);
+                    // continue on a compacted copy if most vertices are solved
+                    if (oink->compactionDue()) {
+                        i = -1;
+                        break;
+                    }
                     // restart algorithm and break inner loop
                     i = nodecount() - 1;
                     reset0 = priority(nodecount()-1);
@@ -132,6 +137,7 @@ PPPSolver::run()
     delete[] inverse;
 
     logger << "solved with " << promotions << " promotions." << std::endl;
+    stats.count("promotions", promotions);
 }
 
 }
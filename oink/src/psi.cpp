@@ -29,12 +29,101 @@ namespace pg {
 static int k;
 static int *str;
 static int *halt;
-static int *val;
 static int *done;
 static int *won;
 static int *first_in;
 static int *next_in;
 
+/**
+ * Valuations are stored sparsely, as persistent segment trees over the priorities 0..2^depth-1.
+ * The valuation of a vertex is that of its successor plus its own priority, so it shares all
+ * of the tree of its successor except the depth+1 nodes on the path to its priority.
+ * Every vertex owns the nodes at 1+v*(depth+1), so valuations are computed in parallel
+ * without allocation, and memory is O(n log d) instead of O(n d).
+ * Node 0 is the empty (all zero) tree; leaves store the count in child[0].
+ */
+struct valnode
+{
+    int child[2];
+};
+
+static int depth;
+static int *val;           // root node of the valuation of each vertex
+static valnode *nodes;
+
+/**
+ * Set the valuation of <v> to the valuation with root <src> plus priority <pr>.
+ */
+static inline void
+val_inc(int v, int src, int pr)
+{
+    int node = 1+v*(depth+1);
+    val[v] = node;
+    for (int level=depth-1; level>=0; level--) {
+        const int bit = (pr >> level) & 1;
+        valnode &n = nodes[node];
+        if (src == 0) n.child[0] = n.child[1] = 0;
+        else n = nodes[src];
+        n.child[bit] = node+1;
+        src = nodes[src].child[bit];
+        node++;
+    }
+    nodes[node].child[0] = nodes[src].child[0] + 1; // nodes[0] stays all zero
+}
+
+/**
+ * Compare valuations <a> and <b> (root nodes) for the Even player, starting at the highest priority.
+ * Shared subtrees are skipped, as they are equal.
+ */
+static int
+val_cmp(int a, int b)
+{
+    // the lower halves still to compare, with their priority and level
+    int stack_a[32], stack_b[32], stack_pr[32], stack_level[32];
+    int count = 0;
+    int pr = 0, level = depth;
+    while (true) {
+        if (a != b) {
+            if (level == 0) {
+                const int a_i = nodes[a].child[0];
+                const int b_i = nodes[b].child[0];
+                if (a_i != b_i) {
+                    if (pr&1) return a_i > b_i ? -1 : 1; // for odd priorities
+                    else return a_i < b_i ? -1 : 1;      // for even priorities
+                }
+            } else {
+                // first the upper half, then the lower half
+                level--;
+                stack_a[count] = nodes[a].child[0];
+                stack_b[count] = nodes[b].child[0];
+                stack_pr[count] = pr;
+                stack_level[count] = level;
+                count++;
+                a = nodes[a].child[1];
+                b = nodes[b].child[1];
+                pr |= 1 << level;
+                continue;
+            }
+        }
+        if (count == 0) return 0;
+        count--;
+        a = stack_a[count];
+        b = stack_b[count];
+        pr = stack_pr[count];
+        level = stack_level[count];
+    }
+}
+
+/**
+ * Returns the count of priority <pr> in the valuation with root <a>.
+ */
+static int
+val_get(int a, int pr)
+{
+    for (int level=depth-1; level>=0 and a != 0; level--) a = nodes[a].child[(pr >> level) & 1];
+    return nodes[a].child[0];
+}
+
 PSISolver::PSISolver(Oink *oink, Game *game) : Solver(oink, game)
 {
 }
@@ -57,28 +146,22 @@ PSISolver::si_val_less(int a, int b)
     // if b is won or on even cycle and a is not, then "a < b"
     if (b != -1 && (won[b] || done[b] == 2)) return true;
     // neither a/b are won/on even cycle
-    int *a_val = a == -1 ? NULL : val + k*a;
-    int *b_val = b == -1 ? NULL : val + k*b;
     // find highest priority where they differ
-    for (int i=k-1; i>=0; i--) {
-        const int a_i = a == -1 ? 0 : a_val[i];
-        const int b_i = b == -1 ? 0 : b_val[i];
-        if (a_i == b_i) continue;
-        if (i&1) return a_i > b_i; // for odd priorities
-        else return a_i < b_i;     // for even priorities
-    }
-    // equal
-    return false;
+    return val_cmp(a == -1 ? 0 : val[a], b == -1 ? 0 : val[b]) < 0;
 }
 
 int
 PSISolver::si_top_val(int a)
 {
-    // find highest priority
-    for (int i=k-1; i>=0; i--) {
-        if (val[k*a+i] != 0) return i;
+    // find highest priority, following the highest nonempty subtrees
+    int node = val[a], pr = 0;
+    if (node == 0) return -1;
+    for (int level=depth-1; level>=0; level--) {
+        const int bit = nodes[node].child[1] != 0;
+        node = nodes[node].child[bit];
+        pr |= bit << level;
     }
-    return -1;
+    return pr;
 }
 
 /**
@@ -90,12 +173,9 @@ VOID_TASK_2(compute_val, int, v, PSISolver *, s)
     // mark node as visited
     done[v] = 1;
 
-    // compute valuation of current node
+    // compute valuation of current node, sharing the valuation of the successor
     int st = str[v];
-    int *dst = val + k*v;
-    if (st == -1 or halt[st]) memset(dst, 0, sizeof(int[k]));
-    else memcpy(dst, val + k*st, sizeof(int[k])); // copy from successor
-    dst[s->priority(v)]++;
+    val_inc(v, (st == -1 or halt[st]) ? 0 : val[st], s->priority(v));
 
     // recursively update predecessor positions
     int count = 0;
@@ -211,11 +291,8 @@ PSISolver::compute_vals_seq(void)
         q.pop_back();
 
         // set valuation
-        int *val_v = val + k*v;
         int s = str[v];
-        if (s == -1 or halt[s]) memset(val_v, 0, sizeof(int[k]));
-        else memcpy(val_v, val+k*s, sizeof(int[k]));
-        val_v[priority(v)]++;
+        val_inc(v, (s == -1 or halt[s]) ? 0 : val[s], priority(v));
         done[v] = 1; // mark "1" as processed and not on a cycle
 
         // add predecessors
@@ -407,7 +484,7 @@ PSISolver::print_debug()
         if (done[i] == 3) continue; // disabled or won
         if (disabled[i]) LOGIC_ERROR;
         logger << "vertex " << label_vertex(i) << ": [";
-        for (int j=0; j<k; j++) logger << (j?" ":"") << val[k*i+j];
+        for (int j=0; j<k; j++) logger << (j?" ":"") << val_get(val[i], j);
         logger << "] ";
         if (done[i] == 2) logger << "c ";
         if (halt[i]) logger << "h ";
@@ -466,8 +543,13 @@ PSISolver::run()
     for (int i=0; i<nodecount(); i++) if (!disabled[i] && priority(i)>k) k = priority(i);
     k++;
 
-    // now create the data structure
-    val = new int[k*nodecount()];
+    // now create the data structure, with room for the path to every priority < k
+    depth = 0;
+    while ((1 << depth) < k) depth++;
+    val = new int[nodecount()];
+    memset(val, 0, sizeof(int[nodecount()])); // disabled vertices keep the empty valuation
+    nodes = new valnode[1+(size_t)nodecount()*(depth+1)];
+    nodes[0].child[0] = nodes[0].child[1] = 0;
     str = new int[nodecount()];
     halt = new int[nodecount()];
     done = new int[nodecount()];
@@ -542,6 +624,7 @@ PSISolver::run()
     }
 
     delete[] val;
+    delete[] nodes;
     delete[] str;
     delete[] halt;
     delete[] done;
@@ -550,6 +633,8 @@ PSISolver::run()
     delete[] next_in;
 
     logger << "solved with " << major << " major iterations, " << minor << " minor iterations." << std::endl;
+    stats.count("major_iterations", major);
+    stats.count("minor_iterations", minor);
 }
 
 }
@@ -19,6 +19,7 @@
 #include <cstring> // for memset
 
 #include "ptl.hpp"
+#include "phases.hpp"
 
 #define CHECK_UNIQUE !NDEBUG // we should not see duplicate tangles anymore
 
@@ -190,6 +191,7 @@ PTLSolver::attractTangles(const int pl, int v, bitset &R, bitset &Z, bitset &G)
 bool
 PTLSolver::extractTangles(int startvertex, bitset &R, int *str)
 {
+    OINK_PHASE("extractTangles");
     bool good = false;
 
     const int pr = priority(startvertex);
@@ -846,6 +848,9 @@ PTLSolver::run()
 
     logger << "found " << dominions << " dominions." << std::endl;
     logger << "solved with " << tangles << " tangles and " << iterations << " iterations." << std::endl;
+    stats.count("dominions", dominions);
+    stats.count("tangles", tangles);
+    stats.count("iterations", iterations);
 
     // check if actually all solved
 #ifndef NDEBUG
@@ -17,8 +17,11 @@
 #include <iomanip>
 
 #include "qpt.hpp"
+#include "lace.h"
+#include "phases.hpp"
 
 #define ODDFIRST 0
+#define INCREMENTAL 1
 
 namespace pg {
 
@@ -292,6 +295,14 @@ QPTSolver::lift(int v, int target)
             if (strategy[v] != -1 and target != strategy[v]) {
                 return false; // no need to do anything... strategy is still same
             }
+            if (INCREMENTAL and strategy[v] != -1) {
+                // the measure of <v> caches the measure via its best successor <target>, and
+                // the other successors were not smaller; if <target> still does not exceed the
+                // cached measure, then neither does the minimum, and the strategy remains valid
+                au(tmp, pm_nodes + k*target, pr, k, max, maxo, pl);
+                if (pm_val(tmp, k, pl) > goal) tmp[0] = max;
+                if (!pm_less(pm, tmp, k, pl)) return false;
+            }
         }
     }
 
@@ -300,9 +311,11 @@ QPTSolver::lift(int v, int target)
     bool first = true;
     int s_cur = strategy[v];
     if (s_cur != -1) {
-        // first set to current...
-        au(tmp, pm_nodes + k*s_cur, pr, k, max, maxo, pl);
-        if (pm_val(tmp, k, pl) > goal) tmp[0] = max; // goal reached, lift to Top
+        // first set to current... (already computed above if it is the target)
+        if (!INCREMENTAL or target != s_cur) {
+            au(tmp, pm_nodes + k*s_cur, pr, k, max, maxo, pl);
+            if (pm_val(tmp, k, pl) > goal) tmp[0] = max; // goal reached, lift to Top
+        }
 #ifndef NDEBUG
         if (trace >= 2) {
             logger << "to successor " << label_vertex(s_cur) << ":";
@@ -387,9 +400,92 @@ QPTSolver::lift(int v, int target)
 }
 
 
+/**
+ * Thread-safe variant of lift() for the parallel engine.
+ * Computes the new measure on snapshots, then writes it with a max-update.
+ */
+bool
+QPTSolver::parlift(int worker, int v, int target)
+{
+    int *cur = scratch + 4*k*worker;
+    int *succ = cur + k, *tmp = cur + 2*k, *res = cur + 3*k;
+
+    const int pr = priority(v);
+
+retry:
+    // check if already Top
+    engine->read(v, cur, pm_nodes + k*v, k);
+    if (cur[0] != -1 and (cur[0]&1) == pl) return false;
+
+    const int s_cur = __atomic_load_n(strategy + v, __ATOMIC_ACQUIRE);
+    int best_to = -1;
+    unsigned best_version = 0;
+
+    if (target != -1) {
+        if (owner(v) == pl) {
+            // if owned by <pl>, just check if target is better.
+            engine->read(target, succ, pm_nodes + k*target, k);
+            au(res, succ, pr, k, max, maxo, pl);
+            if (pm_val(res, k, pl) > goal) res[0] = max;
+            if (!pm_less(cur, res, k, pl)) return false;
+        } else if (s_cur != -1 and target != s_cur) {
+            return false; // strategy is still same
+        } else if (INCREMENTAL and s_cur != -1) {
+            // only recompute if the best successor now exceeds the cached measure, see lift()
+            engine->read(target, succ, pm_nodes + k*target, k);
+            au(res, succ, pr, k, max, maxo, pl);
+            if (pm_val(res, k, pl) > goal) res[0] = max;
+            if (!pm_less(cur, res, k, pl)) return false;
+        }
+    }
+
+    if (target == -1 or owner(v) != pl) {
+        // compute best measure by going over all successors, the current strategy first
+        if (s_cur != -1) {
+            best_version = engine->read(s_cur, succ, pm_nodes + k*s_cur, k);
+            au(res, succ, pr, k, max, maxo, pl);
+            if (pm_val(res, k, pl) > goal) res[0] = max; // goal reached, lift to Top
+            best_to = s_cur;
+        }
+        for (auto curedge = outs(v); *curedge != -1; curedge++) {
+            int to = *curedge;
+            if (disabled[to]) continue;
+            if (to == s_cur) continue;
+            unsigned version = engine->read(to, succ, pm_nodes + k*to, k);
+            au(tmp, succ, pr, k, max, maxo, pl);
+            if (pm_val(tmp, k, pl) > goal) tmp[0] = max; // goal reached, lift to Top
+            if (best_to == -1 or (owner(v) == pl ? pm_less(res, tmp, k, pl) : pm_less(tmp, res, k, pl))) {
+                for (int i=0; i<k; i++) res[i] = tmp[i];
+                best_to = to;
+                best_version = version;
+            }
+        }
+        if (best_to == -1) return false;
+    }
+
+    // another worker may have lifted <v> in the meantime, so only write increases
+    int * const pm = pm_nodes + k*v;
+    bool changed = false;
+    engine->lock(v);
+    if (best_to != -1 and !engine->unchanged(best_to, best_version, v)) {
+        // the best successor increased meanwhile, so the strategy may be stale
+        engine->unlock(v);
+        goto retry;
+    }
+    if (pm_less(pm, res, k, pl)) {
+        for (int i=0; i<k; i++) pm[i] = res[i];
+        changed = true;
+    }
+    if (best_to != -1) strategy[v] = best_to;
+    engine->unlock(v);
+    return changed;
+}
+
 void
 QPTSolver::liftloop()
 {
+    OINK_PHASE("liftloop");
+
     /**
      * Initialize/reset progress measures / strategy
      */
@@ -404,12 +500,14 @@ QPTSolver::liftloop()
         lift_attempt++;
         if (lift(n, -1)) {
             lift_count++;
+            OINK_COUNT("lifts", 1);
 #if 0
             for (int from : in[n]) {
                 if (disabled[from]) continue;
                 lift_attempt++;
                 if (lift(from, n)) {
                     lift_count++;
+                    OINK_COUNT("lifts", 1);
                     todo_push(from);
                 }
             }
@@ -420,16 +518,31 @@ QPTSolver::liftloop()
     }
 
     /**
-     * Lift until fixed point
+     * Lift until fixed point, with the parallel engine if we have one.
      */
+    if (engine != NULL) {
+        while (!todo.empty()) engine->push(todo_pop());
+        engine->run();
+        lift_count += engine->lift_count;
+        lift_attempt += engine->lift_attempt;
+    }
+
     while (!todo.empty()) {
         int n = todo_pop();
         for (auto curedge = ins(n); *curedge != -1; curedge++) {
             int from = *curedge;
             if (disabled[from]) continue;
+            if (INCREMENTAL) {
+                // only propagate along edges that can matter: not to Top, and for vertices
+                // of the opponent only along the edge to their cached best successor
+                const int *pm = pm_nodes + k*from;
+                if (pm[0] != -1 and (pm[0]&1) == pl) continue;
+                if (owner(from) != pl and strategy[from] != -1 and strategy[from] != n) continue;
+            }
             lift_attempt++;
             if (lift(from, n)) {
                 lift_count++;
+                OINK_COUNT("lifts", 1);
                 todo_push(from);
             }
         }
@@ -557,6 +670,12 @@ QPTSolver::run()
     lift_count = 0;
     lift_attempt = 0;
 
+    // with Lace, lift with all workers
+    if (lace_workers() != 0) {
+        engine = new PMLifter(game, disabled, this);
+        scratch = new int[4*big_k*engine->workers()];
+    }
+
     if (bounded) {
         int i;
         for (i=1; i<=big_k; i++) {
@@ -598,6 +717,8 @@ QPTSolver::run()
         } 
 
         logger << "solved with " << lift_count << " lifts, " << lift_attempt << " lift attempts, max k " << i << "." << std::endl;
+        stats.count("lifts", lift_count);
+        stats.count("lift_attempts", lift_attempt);
     } else if (ODDFIRST) {
         pl = 1;
         k = k1;
@@ -621,6 +742,8 @@ QPTSolver::run()
         }
 
         logger << "solved with " << lift_count << " lifts, " << lift_attempt << " lift attempts." << std::endl;
+        stats.count("lifts", lift_count);
+        stats.count("lift_attempts", lift_attempt);
     } else {
         pl = 0;
         k = k0;
@@ -646,10 +769,19 @@ QPTSolver::run()
         }
 
         logger << "solved with " << lift_count << " lifts, " << lift_attempt << " lift attempts." << std::endl;
+        stats.count("lifts", lift_count);
+        stats.count("lift_attempts", lift_attempt);
     }
 
     delete[] pm_nodes;
     delete[] strategy;
+
+    if (engine != NULL) {
+        logger << "parallel lifting with " << engine->workers() << " workers, " << engine->steals << " steals." << std::endl;
+        delete[] scratch;
+        delete engine;
+        engine = NULL;
+    }
 }
 
 }
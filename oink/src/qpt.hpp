@@ -19,10 +19,11 @@
 
 #include "solver.hpp"
 #include "uintqueue.hpp"
+#include "pmlift.hpp"
 
 namespace pg {
 
-class QPTSolver : public Solver
+class QPTSolver : public Solver, public PMLifter::Client
 {
 public:
     QPTSolver(Oink *oink, Game *game);
@@ -47,7 +48,11 @@ protected:
 
     bool bounded = false;
 
+    PMLifter *engine = NULL; // parallel lifting, only with Lace
+    int *scratch;            // per worker: current, successor, tmp, best
+
     bool lift(int v, int target);
+    virtual bool parlift(int worker, int v, int target);
     void liftloop();
     void updateState(unsigned long &_n0, unsigned long &_n1, int &_max0, int &_max1, int &_k0, int &_k1);
 
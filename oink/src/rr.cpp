@@ -131,6 +131,11 @@ RRSolver::run()
                 } else if (res == -1) {
                     // found dominion, return
                     setDominion(p);
+                    // continue on a compacted copy if most vertices are solved
+                    if (oink->compactionDue()) {
+                        i = -1;
+                        break;
+                    }
                     // restart algorithm and break inner loop
                     i = nodecount() - 1;
                     break;
@@ -156,6 +161,7 @@ RRSolver::run()
     delete[] inverse;
 
     logger << "solved with " << promotions << " promotions." << std::endl;
+    stats.count("promotions", promotions);
 }
 
 }
@@ -159,6 +159,11 @@ RRDPSolver::run()
                 } else if (res == -1) {
                     // found dominion
                     setDominion(p);
+                    // continue on a compacted copy if most vertices are solved
+                    if (oink->compactionDue()) {
+                        i = -1;
+                        break;
+                    }
                     // restart algorithm and break inner loop
                     i = nodecount() - 1;
                     // reset everything... (sadly)
@@ -233,6 +238,9 @@ RRDPSolver::run()
     delete[] inverse;
 
     logger << "solved with " << promotions << " promotions, " << performances << "x performing delayed promotions (delayed " << delayed << ", discarded " << discarded << ", total " << promotions+discarded << ")" << std::endl;
+    stats.count("promotions", promotions);
+    stats.count("delayed", delayed);
+    stats.count("discarded", discarded);
 }
 
 }
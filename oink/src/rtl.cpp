@@ -15,6 +15,7 @@
  */
 
 #include "rtl.hpp"
+#include "phases.hpp"
 
 
 namespace pg {
@@ -187,6 +188,7 @@ RTLSolver::attractTangles(const int pl, int v, bitset &R, bitset &Z, int maxpr)
 bool
 RTLSolver::extractTangles(int startvertex, bitset &R)
 {
+    OINK_PHASE("extractTangles");
     bool new_tangles = false;
     const int pr = priority(startvertex);
     const int pl = pr&1;
@@ -610,6 +612,9 @@ RTLSolver::run()
 
     logger << "found " << dominions << " dominions and "<< tangles << " tangles." << std::endl;
     logger << "solved in " << iterations << " iterations." << std::endl;
+    stats.count("dominions", dominions);
+    stats.count("tangles", tangles);
+    stats.count("iterations", iterations);
 
 #ifndef NDEBUG
     // Check if the whole game is now solved
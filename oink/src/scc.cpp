@@ -20,6 +20,7 @@
 #include <stack>
 #include <cstring> // for memset
 #include "oink.hpp"
+#include "phases.hpp"
 
 namespace pg {
 
@@ -29,6 +30,8 @@ namespace pg {
 void
 Oink::tarjan(int n, std::vector<int> &res, bool nonempty)
 {
+    OINK_PHASE("tarjan");
+
     // initialize
     unsigned n_nodes = game->nodecount();
     int *low = new int[n_nodes];
@@ -20,6 +20,7 @@
 #include "game.hpp"
 #include "oink.hpp"
 #include "error.hpp"
+#include "stats.hpp"
 
 namespace pg
 {
@@ -46,7 +47,7 @@ namespace pg
 
         /**
          * Returns true if the solver always solves all enabled vertices
-         * before leaving run().
+         * before leaving run(), unless it stops early when oink->compactionDue().
          */
         virtual bool full_solver() { return true; }
 
@@ -55,6 +56,8 @@ namespace pg
         std::ostream &logger;
         int trace = 0;
 
+        Stats stats; // counters and timers of the solver, collected by Oink after run()
+
         const bitset &disabled; // TODO make function...
 
         inline long nodecount() { return game->nodecount(); }
@@ -72,15 +72,15 @@ namespace pg
             { return new RRDPSolver(oink, game); });
         add("fpi", "fixpoint iteration", 1, [](Oink *oink, Game *game)
             { return new FPISolver(oink, game); });
-        add("fpj", "fixpoint iteration with justifications", 0, [](Oink *oink, Game *game)
+        add("fpj", "fixpoint iteration with justifications", 1, [](Oink *oink, Game *game)
             { return new FPJSolver(oink, game); });
         add("fpjg", "greedy fixpoint iteration with justifications", 1, [](Oink *oink, Game *game)
             { return new FPJGSolver(oink, game); });
         add("psi", "parallel strategy improvement", 1, [](Oink *oink, Game *game)
             { return new PSISolver(oink, game); });
-        add("spm", "accelerated small progress measures", 0, [](Oink *oink, Game *game)
+        add("spm", "accelerated small progress measures", 1, [](Oink *oink, Game *game)
             { return new SPMSolver(oink, game); });
-        add("tspm", "traditional small progress measures", 0, [](Oink *oink, Game *game)
+        add("tspm", "traditional small progress measures", 1, [](Oink *oink, Game *game)
             { return new TSPMSolver(oink, game); });
         add("mspm", "Maciej' modified small progress measures", 0, [](Oink *oink, Game *game)
             { return new MSPMSolver(oink, game); });
@@ -88,9 +88,9 @@ namespace pg
             { return new SSPMSolver(oink, game); });
         add("bsspm", "bounded succinct small progress measures", 0, [](Oink *oink, Game *game)
             { return new BoundedSSPMSolver(oink, game); });
-        add("qpt", "quasi-polynomial time progress measures", 0, [](Oink *oink, Game *game)
+        add("qpt", "quasi-polynomial time progress measures", 1, [](Oink *oink, Game *game)
             { return new QPTSolver(oink, game); });
-        add("bqpt", "bounded quasi-polynomial time progress measures", 0, [](Oink *oink, Game *game)
+        add("bqpt", "bounded quasi-polynomial time progress measures", 1, [](Oink *oink, Game *game)
             { return new BoundedQPTSolver(oink, game); });
         add("ptl", "progressive tangle learning", 0, [](Oink *oink, Game *game)
             { return new PTLSolver(oink, game); });
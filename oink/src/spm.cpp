@@ -17,6 +17,8 @@
 #include <algorithm>
 #include <iomanip>
 #include "spm.hpp"
+#include "lace.h"
+#include "phases.hpp"
 
 /**
  * For easy debugging, remove the comment from one of below defines to
@@ -40,31 +42,41 @@ SPMSolver::~SPMSolver()
 {
 }
 
+template <typename T>
+PackedSPMSolver<T>::PackedSPMSolver(Oink *oink, Game *game) : Solver(oink, game)
+{
+    isa = pm_isa_detect();
+}
+
+template <typename T>
+PackedSPMSolver<T>::~PackedSPMSolver()
+{
+}
+
 /**
  * Returns true if a progress measure "a" is less than "b"
  * up to and including priority <d>, for player <pl>.
  */
+template <typename T>
 bool
-SPMSolver::pm_less(int* a, int* b, int d, int pl)
+PackedSPMSolver<T>::pm_less(const T *a, const T *b, int d, int pl)
 {
     // cases where a or b is Top
-    if (a[pl] == -1) return false;
-    if (b[pl] == -1) return true;
-    // normal comparison, start with highest priority
-    const int start = ((k&1) == pl) ? k-2 : k-1;
-    for (int i=start; i>=d; i-=2) {
-        if (a[i] == b[i]) continue;
-        if (a[i] > counts[i] and b[i] > counts[i]) return false;
-        return a[i] < b[i];
-    }
-    return false;
+    if (a[pl] == TOP) return false;
+    if (b[pl] == TOP) return true;
+    // normal comparison, decided by the highest priority where they differ
+    const int i = pm_diff(isa, a, b, k, d, pl);
+    if (i == -1) return false;
+    if (a[i] > (T)counts[i] and b[i] > (T)counts[i]) return false;
+    return a[i] < b[i];
 }
 
 /**
  * Copy for player <pl>.
  */
+template <typename T>
 void
-SPMSolver::pm_copy(int *dst, int *src, int pl)
+PackedSPMSolver<T>::pm_copy(T *dst, const T *src, int pl)
 {
     for (int i=pl; i<k; i+=2) dst[i] = src[i];
 }
@@ -72,13 +84,14 @@ SPMSolver::pm_copy(int *dst, int *src, int pl)
 /**
  * Obtain the highest priority for player <pl> for which this measure is cyclic, or -1 if none.
  */
+template <typename T>
 int
-SPMSolver::pm_cycles(int *a, int pl)
+PackedSPMSolver<T>::pm_cycles(const T *a, int pl)
 {
     int m = k-1;
     if ((k&1)==pl) m--;
     for (int i=m; i>=0; i-=2) {
-        if (a[i] > counts[i]) return i;
+        if (a[i] > (T)counts[i]) return i;
     }
     return -1;
 }
@@ -86,19 +99,20 @@ SPMSolver::pm_cycles(int *a, int pl)
 /**
  * Write pm to ostream.
  */
+template <typename T>
 void
-SPMSolver::pm_stream(std::ostream &out, int *pm)
+PackedSPMSolver<T>::pm_stream(std::ostream &out, const T *pm)
 {
-    bool top_e = pm[0] == -1;
-    bool top_o = pm[1] == -1;
+    bool top_e = pm[0] == TOP;
+    bool top_o = pm[1] == TOP;
     out << " {";
     if (top_e) out << " \033[1;33mTe\033[m";
-    else out << " " << pm[0];
+    else out << " " << (unsigned)pm[0];
     if (top_o) out << " \033[1;33mTo\033[m";
-    else out << " " << pm[1];
+    else out << " " << (unsigned)pm[1];
     for (int i=2; i<k; i++) {
-        if (i&1) out << " " << (top_o ? 0 : pm[i]);
-        else     out << " " << (top_e ? 0 : pm[i]);
+        if (i&1) out << " " << (top_o ? 0 : (unsigned)pm[i]);
+        else     out << " " << (top_e ? 0 : (unsigned)pm[i]);
     }
     out << " } ";
 }
@@ -106,33 +120,38 @@ SPMSolver::pm_stream(std::ostream &out, int *pm)
 /**
  * Perform update for player <pl>, node with priority <d>. Does not carry-over.
  */
+template <typename T>
 void
-SPMSolver::Prog(int *dst, int *src, int d, int pl)
+PackedSPMSolver<T>::Prog(T *dst, const T *src, int d, int pl)
 {
     // check if top
-    if (src[pl] == -1) {
-        dst[pl] = -1;
+    if (src[pl] == TOP) {
+        dst[pl] = TOP;
         return;
     }
 
-    // set every value lower than <d> to 0.
-    int i = pl;
-    for (; i<d; i+=2) dst[i] = 0;
-    if (d == i) {
-        dst[i] = src[i] + 1;
-        i+=2;
+    // set every value lower than <d> to 0, copy the others
+    pm_prog(isa, dst, src, k, d, pl);
+    if ((d&1) == pl) {
+        if (src[d] == TOP-1) {
+            // the increment would read as Top; keep the measure and restart with a wider type
+            __atomic_store_n(&overflow, true, __ATOMIC_RELAXED);
+            dst[d] = src[d];
+        } else {
+            dst[d] = src[d] + 1;
+        }
     }
-    for (; i<k; i+=2) dst[i] = src[i];
 }
 
+template <typename T>
 bool
-SPMSolver::canlift(int node, int pl)
+PackedSPMSolver<T>::canlift(int node, int pl)
 {
     // obtain ptr to current progress measure
-    int *pm = pms + k*node;
+    T *pm = pms + k*node;
 
     // check if already Top
-    if (pm[pl] == -1) return false;
+    if (pm[pl] == TOP) return false;
 
     const int d = priority(node);
 
@@ -162,14 +181,15 @@ SPMSolver::canlift(int node, int pl)
     }
 }
 
+template <typename T>
 bool
-SPMSolver::lift(int node, int target)
+PackedSPMSolver<T>::lift(int node, int target)
 {
     // obtain ptr to current progress measure
-    int *pm = pms + k*node;
+    T *pm = pms + k*node;
 
     // check if already Top for both players
-    if (pm[0] == -1 and pm[1] == -1) return false;
+    if (pm[0] == TOP and pm[1] == TOP) return false;
 
     lift_attempt++;
 
@@ -189,7 +209,7 @@ SPMSolver::lift(int node, int target)
     int best_ch0 = -1, best_ch1 = -1;
 
     // do max for player <pl_max>
-    if (SINGLE(pl_max) and pm[pl_max] != -1) {
+    if (SINGLE(pl_max) and pm[pl_max] != TOP) {
 #ifndef NDEBUG
         if (trace >= 2) {
             logger << "computing max" << std::endl;
@@ -233,7 +253,7 @@ SPMSolver::lift(int node, int target)
     }
 
     // do min for player <pl_min>
-    if (SINGLE(pl_min) and pm[pl_min] != -1 and (target == -1 or target == strategy[node])) {
+    if (SINGLE(pl_min) and pm[pl_min] != TOP and (target == -1 or target == strategy[node])) {
 #ifndef NDEBUG
         if (trace >= 2) logger << "computing min" << std::endl;
         if (trace >= 2) pm_copy(tmp, pm, 1-pl_min);
@@ -274,14 +294,107 @@ SPMSolver::lift(int node, int target)
         }
         // increase count and return true
         lift_count++;
+        OINK_COUNT("lifts", 1);
         return true;
     } else {
         return false;
     }
 }
 
+/**
+ * Thread-safe variant of lift() for the parallel engine.
+ * Computes the new measure on snapshots, then writes it with a max-update.
+ */
+template <typename T>
+bool
+PackedSPMSolver<T>::parlift(int worker, int node, int target)
+{
+    T *cur = scratch + 4*kpad*worker;
+    T *ptmp = cur + kpad, *pbest = cur + 2*kpad, *succ = cur + 3*kpad;
+
+    const int pl_max = owner(node);
+    const int pl_min = 1 - pl_max;
+    const int d = priority(node);
+
+retry:
+    engine->read(node, cur, pms + k*node, k);
+
+    // check if already Top for both players
+    if (cur[0] == TOP and cur[1] == TOP) return false;
+
+    bool ch_max = false, ch_min = false;
+    int best_to = -1;
+    unsigned best_version = 0;
+
+    // do max for player <pl_max>
+    if (SINGLE(pl_max) and cur[pl_max] != TOP) {
+        if (target != -1) {
+            engine->read(target, succ, pms + k*target, k);
+            Prog(ptmp, succ, d, pl_max);
+            if (pm_less(cur, ptmp, d, pl_max)) {
+                pm_copy(cur, ptmp, pl_max);
+                ch_max = true;
+            }
+        } else {
+            for (auto curedge = outs(node); *curedge != -1; curedge++) {
+                int to = *curedge;
+                if (disabled[to]) continue;
+                engine->read(to, succ, pms + k*to, k);
+                Prog(ptmp, succ, d, pl_max);
+                if (pm_less(cur, ptmp, d, pl_max)) {
+                    pm_copy(cur, ptmp, pl_max);
+                    ch_max = true;
+                }
+            }
+        }
+    }
+
+    // do min for player <pl_min>
+    if (SINGLE(pl_min) and cur[pl_min] != TOP and (target == -1 or target == __atomic_load_n(strategy + node, __ATOMIC_ACQUIRE))) {
+        for (auto curedge = outs(node); *curedge != -1; curedge++) {
+            int to = *curedge;
+            if (disabled[to]) continue;
+            unsigned version = engine->read(to, succ, pms + k*to, k);
+            Prog(ptmp, succ, d, pl_min);
+            if (best_to == -1 or pm_less(ptmp, pbest, d, pl_min)) {
+                for (int i=0; i<k; i++) pbest[i] = ptmp[i];
+                best_to = to;
+                best_version = version;
+            }
+        }
+        if (best_to != -1 and pm_less(cur, pbest, d, pl_min)) {
+            pm_copy(cur, pbest, pl_min);
+            ch_min = true;
+        }
+    }
+
+    if (!ch_max and !ch_min and best_to == -1) return false;
+
+    // another worker may have lifted <node> in the meantime, so only write increases
+    T *pm = pms + k*node;
+    bool res = false;
+    engine->lock(node);
+    if (best_to != -1 and !engine->unchanged(best_to, best_version, node)) {
+        // the best successor increased meanwhile, so the strategy may be stale
+        engine->unlock(node);
+        goto retry;
+    }
+    if (ch_max and pm_less(pm, cur, d, pl_max)) {
+        pm_copy(pm, cur, pl_max);
+        res = true;
+    }
+    if (ch_min and pm_less(pm, cur, d, pl_min)) {
+        pm_copy(pm, cur, pl_min);
+        res = true;
+    }
+    if (best_to != -1) strategy[node] = best_to;
+    engine->unlock(node);
+    return res;
+}
+
+template <typename T>
 void
-SPMSolver::update(int pl)
+PackedSPMSolver<T>::update(int pl)
 {
     std::queue<int> q;
 
@@ -289,7 +402,7 @@ SPMSolver::update(int pl)
     for (int i=0; i<nodecount(); i++) {
         if (disabled[i]) continue;
         unstable[i] = 0; // first mark as stable
-        if (pms[k*i + pl] == -1 or canlift(i, pl) or pm_cycles(pms+k*i, pl) != -1) {
+        if (pms[k*i + pl] == TOP or canlift(i, pl) or pm_cycles(pms+k*i, pl) != -1) {
             unstable[i] = 1;
             q.push(i);
         }
@@ -323,9 +436,9 @@ SPMSolver::update(int pl)
 
     for (int i=0; i<nodecount(); i++) {
         if (disabled[i]) continue;
-        if (unstable[i] == 0 and pms[k*i + 1-pl] != -1) {
+        if (unstable[i] == 0 and pms[k*i + 1-pl] != TOP) {
             if ((priority(i)&1) != pl) counts[priority(i)]--;
-            pms[k*i + 1-pl] = -1;
+            pms[k*i + 1-pl] = TOP;
             todo_push(i);
 
             if (trace) {
@@ -337,26 +450,57 @@ SPMSolver::update(int pl)
     }
 }
 
+/**
+ * Lift until fixed point with the parallel engine, instead of the todo loop in run().
+ */
+template <typename T>
 void
-SPMSolver::run()
+PackedSPMSolver<T>::liftpar(int64_t &last_update)
+{
+    OINK_PHASE("liftpar");
+    while (!todo.empty() or !engine->empty()) {
+        while (!todo.empty()) engine->push(todo_pop());
+        // stop lifting when it is time for the next update, like the todo loop in run()
+        engine->run(std::max<int64_t>(0, last_update + 10*nodecount() - lift_count));
+        lift_count += engine->lift_count;
+        lift_attempt += engine->lift_attempt;
+
+        if (last_update + 10*nodecount() < lift_count) {
+            last_update = lift_count;
+            update(0);
+            update(1);
+        }
+    }
+}
+
+template <typename T>
+void
+PackedSPMSolver<T>::run()
 {
     // determine k = highest priority + 1
     k = priority(nodecount()-1)+1;
     if (k < 2) k = 2;
 
+    // the vector kernels read and write up to 64 bytes past a measure
+    kpad = k + 64/sizeof(T);
+
+    // measures that fit in one 256-bit register are compared faster without AVX-512 masks
+    if (isa == PM_AVX512 and k*sizeof(T) <= 32) isa = PM_AVX2;
+
     // now create the data structure, for each node
-    pms = new int[(size_t)k*nodecount()];
+    pms = new T[(size_t)k*nodecount() + kpad - k];
     strategy = new int[nodecount()];
     counts = new int[k];
-    tmp = new int[k];
-    best = new int[k];
+    tmp = new T[kpad];
+    best = new T[kpad];
     dirty = new int[nodecount()];
     unstable = new int[nodecount()];
 
     int max0 = -1, max1 = -1;
 
     // initialize all measures to 0
-    for (int i=0; i<k*nodecount(); i++) pms[i] = 0;
+    for (int64_t i=0; i<k*nodecount() + kpad - k; i++) pms[i] = 0;
+    for (int i=0; i<kpad; i++) tmp[i] = best[i] = 0;
 
     // initialize strategy to -1
     for (int i=0; i<nodecount(); i++) strategy[i] = -1;
@@ -385,6 +529,14 @@ SPMSolver::run()
     // set number of lifts and lift attempts to 0
     lift_count = lift_attempt = 0;
 
+    if (trace) logger << "comparing measures with " << pm_isa_name(isa) << " kernels." << std::endl;
+
+    // with Lace, lift with all workers
+    if (lace_workers() != 0) {
+        engine = new PMLifter(game, disabled, this);
+        scratch = new T[4*kpad*engine->workers()];
+    }
+
     /**
      * Strategy that updates predecessors then marks updated predecessors for processing.
      * Uses a queue to store the dirty vertices.
@@ -410,16 +562,21 @@ SPMSolver::run()
     int64_t last_update = 0;
 
     while (true) {
-        while (!todo.empty()) {
-            int n = todo_pop();
-            for (auto curedge = ins(n); *curedge != -1; curedge++) {
-                int from = *curedge;
-                if (!disabled[from] and lift(from, n)) todo_push(from);
-            }
-            if (last_update + 10*nodecount() < lift_count) {
-                last_update = lift_count;
-                update(0);
-                update(1);
+        if (engine != NULL) liftpar(last_update);
+
+        {
+            OINK_PHASE("liftloop");
+            while (!todo.empty()) {
+                int n = todo_pop();
+                for (auto curedge = ins(n); *curedge != -1; curedge++) {
+                    int from = *curedge;
+                    if (!disabled[from] and lift(from, n)) todo_push(from);
+                }
+                if (last_update + 10*nodecount() < lift_count) {
+                    last_update = lift_count;
+                    update(0);
+                    update(1);
+                }
             }
         }
 
@@ -452,8 +609,8 @@ SPMSolver::run()
 
             for (int n=0; n<nodecount(); n++) {
                 if (disabled[n]) continue;
-                int *pm = pms + k*n;
-                if (pm[pl] == -1) continue; // already won
+                T *pm = pms + k*n;
+                if (pm[pl] == TOP) continue; // already won
                 int c = pm_cycles(pm, pl);
                 if (c == -1) continue; // not a cycle measure
 #ifndef NDEBUG
@@ -465,7 +622,7 @@ SPMSolver::run()
                 }
 #endif
                 if (c == max) {
-                    pms[n*k + pl] = -1;
+                    pms[n*k + pl] = TOP;
                     todo_push(n);
 
                     const int d = priority(n);
@@ -486,8 +643,8 @@ SPMSolver::run()
                     for (auto curedge = outs(n); *curedge != -1; curedge++) {
                         int to = *curedge;
                         if (disabled[to]) continue;
-                        int *pm_to = pms + k*to;
-                        if (pm_to[pl] == -1) continue; // already won
+                        T *pm_to = pms + k*to;
+                        if (pm_to[pl] == TOP) continue; // already won
                         Prog(tmp, pm_to, d, pl);
                         if (!pm_less(pms + k*n, tmp, d, pl)) continue; // candidate must increase measure
                         if (best_to == -1 or pm_less(tmp, best, 0, pl))  {
@@ -537,7 +694,7 @@ SPMSolver::run()
                         escapes = false;
                         for (auto curedge = outs(n); *curedge != -1; curedge++) {
                             int m = *curedge;
-                            if (disabled[m] == 0 and pms[k*m+pl] != -1 and cm[m] == 0) {
+                            if (disabled[m] == 0 and pms[k*m+pl] != TOP and cm[m] == 0) {
                                 escapes = true;
                                 break;
                             }
@@ -582,7 +739,7 @@ SPMSolver::run()
                 for (int n : cycles) {
                     if (cm[n]) {
                         cm[n] = 0;
-                        pms[n*k + pl] = -1;
+                        pms[n*k + pl] = TOP;
                         todo_push(n);
 
                         const int d = priority(n);
@@ -606,7 +763,7 @@ SPMSolver::run()
             }
         }
 
-        if (todo.empty()) break;
+        if (todo.empty() or overflow) break;
     }
 
 #ifndef NDEBUG
@@ -620,12 +777,12 @@ SPMSolver::run()
     }
 #endif
 
-    // Now set dominions and derive strategy for even.
-    for (int n=0; n<nodecount(); n++) {
+    // Now set dominions and derive strategy for even, unless the measures overflowed.
+    for (int n=0; n<nodecount() and !overflow; n++) {
         if (disabled[n]) continue;
-        int *pm = pms + k*n;
-        if ((pm[0] == -1) == (pm[1] == -1)) LOGIC_ERROR;
-        const int winner = pm[0] == -1 ? 0 : 1;
+        T *pm = pms + k*n;
+        if ((pm[0] == TOP) == (pm[1] == TOP)) LOGIC_ERROR;
+        const int winner = pm[0] == TOP ? 0 : 1;
         oink->solve(n, winner, game->owner(n) == winner ? strategy[n] : -1);
     }
 
@@ -638,7 +795,51 @@ SPMSolver::run()
     delete[] cm;
     delete[] unstable;
 
-    logger << "solved with " << lift_count << " lifts, " << lift_attempt << " lift attempts." << std::endl;
+    if (engine != NULL) {
+        logger << "parallel lifting with " << engine->workers() << " workers, " << engine->steals << " steals." << std::endl;
+        delete[] scratch;
+        delete engine;
+        engine = NULL;
+    }
+
+    if (!overflow) logger << "solved with " << lift_count << " lifts, " << lift_attempt << " lift attempts." << std::endl;
+    stats.count("lifts", lift_count);
+    stats.count("lift_attempts", lift_attempt);
+}
+
+template <typename T>
+bool
+SPMSolver::solve()
+{
+    PackedSPMSolver<T> spm(oink, game);
+    spm.run();
+    lift_count += spm.lift_count;
+    lift_attempt += spm.lift_attempt;
+    return !spm.overflow;
+}
+
+void
+SPMSolver::run()
+{
+    // measures count vertices of a priority, so their components stay close to the counts;
+    // leave as much room again, as a measure that overflows means solving again
+    int *counts = new int[priority(nodecount()-1)+1]();
+    for (int i=0; i<nodecount(); i++) if (disabled[i] == 0) counts[priority(i)]++;
+    int maxcount = 0;
+    for (int i=0; i<=priority(nodecount()-1); i++) maxcount = std::max(maxcount, counts[i]);
+    delete[] counts;
+
+    int bits = maxcount < 126 ? 8 : maxcount < 32766 ? 16 : 32;
+    logger << "using " << bits << "-bit measures." << std::endl;
+
+    while (true) {
+        if (bits == 8 and solve<uint8_t>()) break;
+        if (bits == 16 and solve<uint16_t>()) break;
+        if (bits == 32 and solve<uint32_t>()) break;
+        if (bits == 32) LOGIC_ERROR;
+        bits *= 2;
+        logger << "measures overflow, restarting with " << bits << "-bit measures." << std::endl;
+    }
 }
 
 }
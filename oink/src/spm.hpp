@@ -21,9 +21,16 @@
 
 #include "oink.hpp"
 #include "solver.hpp"
+#include "pmlift.hpp"
+#include "pmsimd.hpp"
 
 namespace pg {
 
+/**
+ * Small progress measures. Measures are stored with the narrowest unsigned type that fits the
+ * counts of the game, see PackedSPMSolver; run() picks the type and restarts with a wider type
+ * if the measures overflow.
+ */
 class SPMSolver : public Solver
 {
 public:
@@ -36,23 +43,55 @@ public:
     int64_t lift_count = 0;
 
 protected:
-    int *pms;
-    int *tmp, *best;
+    template <typename T> bool solve();
+};
+
+/**
+ * SPM with measures of unsigned type <T>, where Top is the largest value of <T>.
+ * Narrow measures put more vertices in a cache line and more components in a vector register;
+ * comparing and Prog use the vector kernels of pmsimd.hpp, chosen at runtime.
+ */
+template <typename T>
+class PackedSPMSolver : public Solver, public PMLifter::Client
+{
+public:
+    PackedSPMSolver(Oink *oink, Game *game);
+    virtual ~PackedSPMSolver();
+
+    virtual void run();
+
+    int64_t lift_attempt = 0;
+    int64_t lift_count = 0;
+    bool overflow = false; // set when a measure does not fit in <T>; then nothing is solved
+
+protected:
+    static const T TOP = (T)~(T)0;
+
+    T *pms;
+    T *tmp, *best;
     int *strategy;
-    int *counts;
+    int *counts;             // fit in <T>, see SPMSolver::run()
     int64_t k;
+    int64_t kpad;            // k plus the padding the vector kernels read past a measure
+    int isa;                 // kernels to use, see pm_isa_detect()
 
     std::deque<int> todo;
     int *dirty;
     int *unstable;
 
+    PMLifter *engine = NULL; // parallel lifting, only with Lace
+    T *scratch;              // per worker: current, tmp, best, successor
+
+    virtual bool parlift(int worker, int node, int target);
+    void liftpar(int64_t &last_update);
+
     bool canlift(int node, int pl);
     bool lift(int node, int target);
-    bool pm_less(int *a, int *b, int d, int pl);
-    void pm_copy(int *dst, int *src, int pl);
-    int pm_cycles(int *a, int pl);
-    void pm_stream(std::ostream &out, int *pm);
-    void Prog(int *dst, int *src, int d, int pl);
+    bool pm_less(const T *a, const T *b, int d, int pl);
+    void pm_copy(T *dst, const T *src, int pl);
+    int pm_cycles(const T *a, int pl);
+    void pm_stream(std::ostream &out, const T *pm);
+    void Prog(T *dst, const T *src, int d, int pl);
     void update(int pl);
 
     void todo_push(int node) {
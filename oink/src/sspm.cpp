@@ -18,6 +18,7 @@
 #include <iomanip>
 
 #include "sspm.hpp"
+#include "phases.hpp"
 
 #define ODDFIRST 1
 
@@ -34,47 +35,37 @@ SSPMSolver::~SSPMSolver()
 void
 SSPMSolver::to_tmp(int idx)
 {
-    int base = idx*l;
-    for (int i=0; i<l; i++) tmp_b[i] = pm_b[base+i];
-    for (int i=0; i<l; i++) tmp_d[i] = pm_d[base+i];
+    memcpy(tmp, pm + (size_t)ls*idx, sizeof(uint16_t[ls]));
 }
 
 void
 SSPMSolver::from_tmp(int idx)
 {
-    int base = idx*l;
-    for (int i=0; i<l; i++) pm_b[base+i] = tmp_b[i];
-    for (int i=0; i<l; i++) pm_d[base+i] = tmp_d[i];
+    memcpy(pm + (size_t)ls*idx, tmp, sizeof(uint16_t[ls]));
 }
 
 void
 SSPMSolver::to_best(int idx)
 {
-    int base = idx*l;
-    for (int i=0; i<l; i++) best_b[i] = pm_b[base+i];
-    for (int i=0; i<l; i++) best_d[i] = pm_d[base+i];
+    memcpy(best, pm + (size_t)ls*idx, sizeof(uint16_t[ls]));
 }
 
 void
 SSPMSolver::from_best(int idx)
 {
-    int base = idx*l;
-    for (int i=0; i<l; i++) pm_b[base+i] = best_b[i];
-    for (int i=0; i<l; i++) pm_d[base+i] = best_d[i];
+    memcpy(pm + (size_t)ls*idx, best, sizeof(uint16_t[ls]));
 }
 
 void
 SSPMSolver::tmp_to_best()
 {
-    best_b = tmp_b;
-    memcpy(best_d, tmp_d, sizeof(int[l]));
+    memcpy(best, tmp, sizeof(uint16_t[ls]));
 }
 
 void
 SSPMSolver::tmp_to_test()
 {
-    test_b = tmp_b;
-    memcpy(test_d, tmp_d, sizeof(int[l]));
+    memcpy(test, tmp, sizeof(uint16_t[ls]));
 }
 
 /**
@@ -83,56 +74,8 @@ SSPMSolver::tmp_to_test()
 void
 SSPMSolver::trunc_tmp(int pindex)
 {
-    if (tmp_d[0] == -1) return; // already Top
-    // compute the lowest pindex >= p
-    // [pindex],.,...,.. => [pindex],000
-    // if pindex is the bottom, then this simply "buries" the remainder
-    for (int i=l-1; i>=0 and tmp_d[i] > pindex; i--) {
-        tmp_b[i] = 0;
-        tmp_d[i] = pindex+1;
-    }
-}
-
-/*
-void
-SSPMSolver::prog_cap_tmp(int pindex)
-{
-    // Start at the bottom, keep checking caps while going up
-    if (tmp_d[0] == -1) return; // nothing to do
-
-    // compute value
-    int i=0;
-    for (int d=0; d<=pindex and i<l; d++) {
-        int val = 0, _i = i;
-
-        for (; i<l; i++) {
-            if (tmp_d[i] != d) {
-                // e found
-                val |= ((1 << (l-i)) - 1);
-                break;
-            }
-
-            if (tmp_b[i]) val |= (1 << (l-i));
-        }
-
-        if (val > cap[d]) {
-            if (d == 0) {
-                // go to Top
-                tmp_d[0] = -1;
-                tmp_b.reset();
-            } else {
-                for (int j=_i; j<l; j++) {
-                    tmp_d[j] = d-1;
-                    tmp_b[j] = 0;
-                }
-                tmp_b[_i] = 1;
-                prog_cap_tmp(pindex); // again
-            }
-            return;
-        }
-    }
+    sspm_trunc(tmp, l, h, pindex);
 }
-*/
 
 /**
  * Set tmp := min { m | m >_p tmp }
@@ -140,87 +83,16 @@ SSPMSolver::prog_cap_tmp(int pindex)
 void
 SSPMSolver::prog_tmp(int pindex, int h)
 {
-    // Simple case 1: Top >_p Top
-    if (tmp_d[0] == -1) return; // already Top
-
-    // Simple case 2: Some bits below [pindex], ergo [pindex] can go from ..e to ..10*
-    if (tmp_d[l-1] > pindex) {
-        int i;
-        for (i=l-1; i>=0 and tmp_d[i] > pindex; i--) {
-            tmp_b[i] = 0;
-            tmp_d[i] = pindex;
-        }
-        tmp_b[i+1] = 1;
-        return;
-    }
-
-    // Case 3: no bits below [pindex], so analyze lowest nonempty level
-    // * If lowest contains 0: 3a or 3b
-    // * Else if lowest level is root: 3c
-    // * Else append 100000000... to next higher level (3d, 3e, 3f)
-    //
-    // 3a: ,..011*  => ,..100*  (if lowest nonempty is the bottom)
-    // 3b: ,..011*, => ,..,000* (if lowest nonempty is not the bottom)
-    // 3c: 1111111  => Top      (if root contains only 1s)
-    // 3d: ,1111111 => 100*     (if non-root contains only 1s)
-    // 3e: ..,111*  => ..100*
-    // 3f: ,e,111*  => ,100*
-
-    // no bits below pindex, so just find smallest increase
-    for (int i=l-1; i>=0; i--) {
-        if (tmp_b[i] == 0) {
-            if (tmp_d[i] == h) {
-                // 3a: we found a 0 on the bottom, increase to 100...
-                // ..011 => 00100
-                tmp_b[i] = 1;
-                break;
-            } else {
-                // 3b: we found a 0 (not bottom), increase to [eps] and 0s on leaf
-                // ..011 => ..,000
-                tmp_b[i] = 0;
-                int new_d = tmp_d[i]+1;
-                for (int k=i; k<l; k++) tmp_d[k] = new_d;
-                break;
-            }
-        } else if (i == 0) {
-            // we have only seen 1s and only 1 element
-            if (tmp_d[0] == 0) {
-                // 3c: we are already the highest, so go to top
-                tmp_b[0] = 0;
-                tmp_d[0] = -1;
-                break;
-            } else {
-                // 3d: increase 1 higher...
-                // ,e,111   => ,100
-                int new_d = tmp_d[0]-1;
-                tmp_b[0] = 1;
-                for (int k=0; k<l; k++) tmp_d[k] = new_d;
-                break;
-            }
-        } else if (tmp_d[i-1] != tmp_d[i]) {
-            // 3e, 3f: next is different
-            // two cases
-            //  .,111   => .100
-            // ,e,111   => ,100
-            int new_d = tmp_d[i]-1;
-            tmp_b[i] = 1;
-            for (int k=i; k<l; k++) tmp_d[k] = new_d;
-            break;
-        } else {
-            // next is same
-            tmp_b[i] = 0;
-        }
-    }
+    sspm_prog(tmp, l, h, pindex);
 }
 
 /**
- * Write pm to ostream.
+ * Write measure <m> to ostream.
  */
-void
-SSPMSolver::stream_pm(std::ostream &out, int idx)
+static void
+stream_measure(std::ostream &out, const uint16_t *m, int l, int h)
 {
-    int base = idx*l;
-    if (pm_d[base] == -1) {
+    if (m[0] == SSPM_TOP) {
         out << " \033[1;33mTop\033[m";
     } else {
         out << " { ";
@@ -228,9 +100,9 @@ SSPMSolver::stream_pm(std::ostream &out, int idx)
         for (int i=0; i<h; i++) {
             if (i>0) out << ",";
             int c=0;
-            while (j<l and pm_d[base+j] == i) {
+            while (j<l and sspm_depth(m[j], h) == i) {
                 c++;
-                out << pm_b[base+j];
+                out << sspm_bit(m[j], h);
                 j++;
             }
             if (c == 0) out << "ε";
@@ -239,29 +111,23 @@ SSPMSolver::stream_pm(std::ostream &out, int idx)
     }
 }
 
+/**
+ * Write pm to ostream.
+ */
+void
+SSPMSolver::stream_pm(std::ostream &out, int idx)
+{
+    stream_measure(out, pm + (size_t)ls*idx, l, h);
+}
+
 /**
  * Write tmp to ostream.
  */
 void
 SSPMSolver::stream_tmp(std::ostream &out, int h)
 {
-    if (tmp_d[0] == -1) {
-        out << " \033[1;33mTop\033[m";
-    } else {
-        out << " { ";
-        int j=0;
-        for (int i=0; i<h; i++) {
-            if (i>0) out << ",";
-            int c=0;
-            while (j<l and tmp_d[j] == i) {
-                c++;
-                out << tmp_b[j];
-                j++;
-            }
-            if (c == 0) out << "ε";
-        }
-        out << " }";
-
+    stream_measure(out, tmp, l, h);
+    if (tmp[0] != SSPM_TOP) {
         out << " {";
 
         // compute value
@@ -270,13 +136,13 @@ SSPMSolver::stream_tmp(std::ostream &out, int h)
             int val = 0;
 
             for (; i<l; i++) {
-                if (tmp_d[i] != d) {
+                if (sspm_depth(tmp[i], h) != d) {
                     // e found
                     val |= ((1 << (l-i)) - 1);
                     break;
                 }
 
-                if (tmp_b[i]) val |= (1 << (l-i));
+                if (sspm_bit(tmp[i], h)) val |= (1 << (l-i));
             }
 
             logger << " " << val;
@@ -292,23 +158,7 @@ SSPMSolver::stream_tmp(std::ostream &out, int h)
 void
 SSPMSolver::stream_best(std::ostream &out, int h)
 {
-    if (best_d[0] == -1) {
-        out << " \033[1;33mTop\033[m";
-    } else {
-        out << " { ";
-        int j=0;
-        for (int i=0; i<h; i++) {
-            if (i>0) out << ",";
-            int c=0;
-            while (j<l and best_d[j] == i) {
-                c++;
-                out << best_b[j];
-                j++;
-            }
-            if (c == 0) out << "ε";
-        }
-        out << " }";
-    }
+    stream_measure(out, best, l, h);
 }
 
 /**
@@ -320,31 +170,7 @@ SSPMSolver::stream_best(std::ostream &out, int h)
 int
 SSPMSolver::compare(int pindex)
 {
-    // cases involving Top
-    if (tmp_d[0] == -1 and best_d[0] == -1) return 0;
-    if (tmp_d[0] == -1) return 1;
-    if (best_d[0] == -1) return -1;
-    for (int i=0; i<l; i++) {
-        if (tmp_d[i] > pindex and best_d[i] > pindex) {
-            // equal until pindex, return 0
-            return 0;
-        } else if (tmp_d[i] < best_d[i]) {
-            // equal until best has [eps]
-            if (tmp_b[i] == 0) return -1;
-            else return 1;
-        } else if (tmp_d[i] > best_d[i]) {
-            // equal until tmp has [eps]
-            if (best_b[i] == 0) return 1;
-            else return -1;
-        } else if (tmp_b[i] < best_b[i]) {
-            // equal until tmp<best
-            return -1;
-        } else if (tmp_b[i] > best_b[i]) {
-            // equal until tmp>best
-            return 1;
-        }
-    }
-    return 0;
+    return sspm_compare(tmp, best, ls, h, pindex);
 }
 
 /**
@@ -356,38 +182,14 @@ SSPMSolver::compare(int pindex)
 int
 SSPMSolver::compare_test(int pindex)
 {
-    // cases involving Top
-    if (tmp_d[0] == -1 and test_d[0] == -1) return 0;
-    if (tmp_d[0] == -1) return 1;
-    if (test_d[0] == -1) return -1;
-    for (int i=0; i<l; i++) {
-        if (tmp_d[i] > pindex and test_d[i] > pindex) {
-            // equal until pindex, return 0
-            return 0;
-        } else if (tmp_d[i] < test_d[i]) {
-            // equal until test has [eps]
-            if (tmp_b[i] == 0) return -1;
-            else return 1;
-        } else if (tmp_d[i] > test_d[i]) {
-            // equal until tmp has [eps]
-            if (test_b[i] == 0) return 1;
-            else return -1;
-        } else if (tmp_b[i] < test_b[i]) {
-            // equal until tmp<test
-            return -1;
-        } else if (tmp_b[i] > test_b[i]) {
-            // equal until tmp>test
-            return 1;
-        }
-    }
-    return 0;
+    return sspm_compare(tmp, test, ls, h, pindex);
 }
 
 bool
 SSPMSolver::lift(int v, int target, int &str, int pl)
 {
     // check if already Top
-    if (pm_d[l*v] == -1) return false; // already Top
+    if (pm[(size_t)ls*v] == SSPM_TOP) return false; // already Top
 
     const int pr = priority(v);
     const int pindex = pl == 0 ? h-(pr+1)/2-1 : h-pr/2-1;
@@ -525,31 +327,31 @@ SSPMSolver::run(int n_bits, int depth, int player)
     l = n_bits;
     h = depth;
 
-    pm_b.resize(l*nodecount());
-    pm_d = new int[l*nodecount()];
+    ls = l == 0 ? 4 : (l+3) & ~3; // whole words, and at least one for the Top marker
 
-    tmp_b.resize(l);
-    tmp_d = new int[l];
-
-    best_b.resize(l);
-    best_d = new int[l];
-
-    test_b.resize(l);
-    test_d = new int[l];
+    pm = new uint16_t[(size_t)ls*nodecount()];
+    tmp = new uint16_t[ls];
+    best = new uint16_t[ls];
+    test = new uint16_t[ls];
 
     // initialize progress measures
-    // pm_b.reset(); // standard set to 0 already
-    memset(pm_d, 0, sizeof(int[l*nodecount()])); // every bit in the top ( = min )
+    memset(pm, 0, sizeof(uint16_t)*ls*nodecount()); // every bit 0 in the top ( = min )
+    memset(tmp, 0, sizeof(uint16_t[ls]));
+    memset(best, 0, sizeof(uint16_t[ls]));
+    memset(test, 0, sizeof(uint16_t[ls]));
 
     // lift_counters = new uint64_t[nodecount()];
     // memset(lift_counters, 0, sizeof(uint64_t[nodecount()]));
 
+    OINK_PHASE("liftloop");
+
     for (int n=nodecount()-1; n>=0; n--) {
         if (disabled[n]) continue;
         lift_attempt++;
         int s;
         if (lift(n, -1, s, player)) {
             lift_count++;
+            OINK_COUNT("lifts", 1);
             // lift_counters[n]++;
             for (auto curedge = ins(n); *curedge != -1; curedge++) {
                 int from = *curedge;
@@ -558,6 +360,7 @@ SSPMSolver::run(int n_bits, int depth, int player)
                 int s;
                 if (lift(from, n, s, player)) {
                     lift_count++;
+                    OINK_COUNT("lifts", 1);
                     // lift_counters[from]++;
                     todo_push(from);
                 }
@@ -574,6 +377,7 @@ SSPMSolver::run(int n_bits, int depth, int player)
             int s;
             if (lift(from, n, s, player)) {
                 lift_count++;
+                OINK_COUNT("lifts", 1);
                 // lift_counters[from]++;
                 todo_push(from);
             }
@@ -586,7 +390,7 @@ SSPMSolver::run(int n_bits, int depth, int player)
 
     for (int v=0; v<nodecount(); v++) {
         if (disabled[v]) continue;
-        if (pm_d[l*v] != -1) {
+        if (pm[(size_t)ls*v] != SSPM_TOP) {
             if (owner(v) != player) {
                 if (lift(v, -1, game->strategy[v], player)) logger << "error: " << v << " is not progressive!" << std::endl;
             }
@@ -600,7 +404,7 @@ SSPMSolver::run(int n_bits, int depth, int player)
             logger << "\033[1m" << label_vertex(v) << (owner(v)?" (odd)":" (even)") << "\033[m:";
             stream_pm(logger, v);
 
-            if (pm_d[l*v] != -1) {
+            if (pm[(size_t)ls*v] != SSPM_TOP) {
                 if (owner(v) != player) {
                     logger << " => " << label_vertex(game->strategy[v]);
                 }
@@ -616,7 +420,7 @@ SSPMSolver::run(int n_bits, int depth, int player)
 
     for (int v=0; v<nodecount(); v++) {
         if (disabled[v]) continue;
-        if (pm_d[l*v] != -1) oink->solve(v, 1-player, game->strategy[v]);
+        if (pm[(size_t)ls*v] != SSPM_TOP) oink->solve(v, 1-player, game->strategy[v]);
     }
 
     oink->flush();
@@ -635,10 +439,10 @@ SSPMSolver::run(int n_bits, int depth, int player)
     }
     */
 
-    delete[] pm_d;
-    delete[] tmp_d;
-    delete[] best_d;
-    delete[] test_d;
+    delete[] pm;
+    delete[] tmp;
+    delete[] best;
+    delete[] test;
 }
 
 void
@@ -651,6 +455,9 @@ SSPMSolver::run()
     int h0 = (max_prio/2)+1;
     int h1 = (max_prio+1)/2;
 
+    // slot keys go up to 2h+1, below SSPM_TOP
+    if (h0 > 32766) THROW_ERROR("too many priorities for succinct measures");
+
     // create datastructures
     Q.resize(nodecount());
     dirty.resize(nodecount());
@@ -705,6 +512,8 @@ SSPMSolver::run()
     }
 
     logger << "solved with " << lift_count << " lifts, " << lift_attempt << " lift attempts, max l " << i << "." << std::endl;
+    stats.count("lifts", lift_count);
+    stats.count("lift_attempts", lift_attempt);
 }
 
 }
@@ -17,12 +17,161 @@
 #ifndef SSPM_HPP
 #define SSPM_HPP
 
+#include <cstring>
+
 #include "oink.hpp"
 #include "solver.hpp"
 #include "uintqueue.hpp"
 
 namespace pg {
 
+/**
+ * Succinct measures as used by SSPMSolver. A measure with l bits is a sequence of l slots,
+ * each with a depth (the counter the bit belongs to, nondecreasing along the slots) and a bit.
+ *
+ * Every slot is stored as a 16-bit key that orders like the slots: (d,0) is key d and (d,1) is
+ * key 2h+1-d, so (d,0) < (e,*) < (d,1) for every d < e. Then two measures compare like their key
+ * strings, and compare() handles four slots per 64-bit word: XOR the words, and count the zeros
+ * up to the first differing key. Top is SSPM_TOP in the first slot; the other slots are ignored.
+ */
+
+static const uint16_t SSPM_TOP = 0xFFFF;
+
+static inline uint16_t
+sspm_key(int d, int b, int h)
+{
+    return b ? 2*h+1-d : d;
+}
+
+static inline int
+sspm_depth(uint16_t key, int h)
+{
+    return key <= h ? key : 2*h+1-key;
+}
+
+static inline int
+sspm_bit(uint16_t key, int h)
+{
+    return key > h;
+}
+
+/**
+ * Returns true if the slot of <key> is below counter <pindex>, i.e., has depth > pindex.
+ */
+static inline bool
+sspm_below(uint16_t key, int h, int pindex)
+{
+    return key > pindex and key < 2*h+1-pindex;
+}
+
+/**
+ * Compare measures <a> and <b> of <slots> slots (a multiple of 4) up to counter <pindex>.
+ * res := -1 :: a < b
+ * res := 0  :: a = b
+ * res := 1  :: a > b
+ */
+static inline int
+sspm_compare(const uint16_t *a, const uint16_t *b, int slots, int h, int pindex)
+{
+    // cases involving Top
+    if (a[0] == SSPM_TOP and b[0] == SSPM_TOP) return 0;
+    if (a[0] == SSPM_TOP) return 1;
+    if (b[0] == SSPM_TOP) return -1;
+    for (int i=0; i<slots; i+=4) {
+        uint64_t x, y;
+        memcpy(&x, a+i, sizeof(uint64_t));
+        memcpy(&y, b+i, sizeof(uint64_t));
+        if (x == y) continue;
+        // the first differing slot decides, unless both slots are below <pindex>
+        // (depths only increase, so then all slots up to <pindex> were equal)
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        const int j = i + (__builtin_clzll(x ^ y) >> 4);
+#else
+        const int j = i + (__builtin_ctzll(x ^ y) >> 4);
+#endif
+        if (sspm_below(a[j], h, pindex) and sspm_below(b[j], h, pindex)) return 0;
+        return a[j] < b[j] ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Set m := min { m' | m' ==_p m }
+ */
+static inline void
+sspm_trunc(uint16_t *m, int l, int h, int pindex)
+{
+    if (m[0] == SSPM_TOP) return; // already Top
+    // [pindex],.,...,.. => [pindex],000
+    // if pindex is the bottom, then this simply "buries" the remainder
+    for (int i=l-1; i>=0 and sspm_below(m[i], h, pindex); i--) m[i] = pindex+1;
+}
+
+/**
+ * Set m := min { m' | m' >_p m }
+ */
+static inline void
+sspm_prog(uint16_t *m, int l, int h, int pindex)
+{
+    // Simple case 1: Top >_p Top
+    if (m[0] == SSPM_TOP) return; // already Top
+
+    // Simple case 2: Some bits below [pindex], ergo [pindex] can go from ..e to ..10*
+    if (sspm_below(m[l-1], h, pindex)) {
+        int i;
+        for (i=l-1; i>=0 and sspm_below(m[i], h, pindex); i--) m[i] = pindex;
+        m[i+1] = sspm_key(pindex, 1, h);
+        return;
+    }
+
+    // Case 3: no bits below [pindex], so analyze lowest nonempty level
+    // * If lowest contains 0: 3a or 3b
+    // * Else if lowest level is root: 3c
+    // * Else append 100000000... to next higher level (3d, 3e, 3f)
+    //
+    // 3a: ,..011*  => ,..100*  (if lowest nonempty is the bottom)
+    // 3b: ,..011*, => ,..,000* (if lowest nonempty is not the bottom)
+    // 3c: 1111111  => Top      (if root contains only 1s)
+    // 3d: ,1111111 => 100*     (if non-root contains only 1s)
+    // 3e: ..,111*  => ..100*
+    // 3f: ,e,111*  => ,100*
+    //
+    // the trailing 1s seen so far are turned into 0s, so slots after i hold keys of bit 0
+
+    for (int i=l-1; i>=0; i--) {
+        const int d = sspm_depth(m[i], h);
+        if (sspm_bit(m[i], h) == 0) {
+            if (d == h) {
+                // 3a: we found a 0 on the bottom, increase to 100...
+                m[i] = sspm_key(d, 1, h);
+            } else {
+                // 3b: we found a 0 (not bottom), increase to [eps] and 0s on leaf
+                for (int k=i; k<l; k++) m[k] = d+1;
+            }
+            return;
+        } else if (i == 0) {
+            // we have only seen 1s and only 1 element
+            if (d == 0) {
+                // 3c: we are already the highest, so go to top
+                m[0] = SSPM_TOP;
+            } else {
+                // 3d: increase 1 higher...
+                m[0] = sspm_key(d-1, 1, h);
+                for (int k=1; k<l; k++) m[k] = d-1;
+            }
+            return;
+        } else if (sspm_depth(m[i-1], h) != d) {
+            // 3e, 3f: next is different
+            m[i] = sspm_key(d-1, 1, h);
+            for (int k=i+1; k<l; k++) m[k] = d-1;
+            return;
+        } else {
+            // next is same
+            m[i] = d;
+        }
+    }
+}
+
 class SSPMSolver : public Solver
 {
 public:
@@ -38,21 +187,14 @@ protected:
      *
      * So we could reasonably assume 0 <= l <= 32
      *
-     * Two formats are possible to encode the array, apart from the bitstring
-     * - for each bit the depth: log n * log h 
+     * Every measure is stored as <ls> slot keys, see sspm_compare.
      */
     int l, h;
-    bitset pm_b;
-    int *pm_d;
-
-    bitset tmp_b;
-    int *tmp_d;
-
-    bitset best_b;
-    int *best_d;
-
-    bitset test_b;
-    int *test_d;
+    int ls; // l rounded up to whole 64-bit words
+    uint16_t *pm;
+    uint16_t *tmp;
+    uint16_t *best;
+    uint16_t *test;
 
     uintqueue Q;
     bitset dirty;
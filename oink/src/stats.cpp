@@ -0,0 +1,131 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iomanip>
+
+#include "stats.hpp"
+
+namespace pg
+{
+
+    template <typename T>
+    static void
+    add_to(std::vector<std::pair<std::string, T>> &items, const std::string &name, T value)
+    {
+        for (auto &item : items)
+        {
+            if (item.first == name)
+            {
+                item.second += value;
+                return;
+            }
+        }
+        items.emplace_back(name, value);
+    }
+
+    template <typename T>
+    static T
+    find_in(const std::vector<std::pair<std::string, T>> &items, const std::string &name)
+    {
+        for (auto &item : items)
+        {
+            if (item.first == name)
+                return item.second;
+        }
+        return 0;
+    }
+
+    void
+    Stats::count(const std::string &name, long value)
+    {
+        add_to(_counters, name, value);
+    }
+
+    void
+    Stats::time(const std::string &name, double seconds)
+    {
+        add_to(_timers, name, seconds);
+    }
+
+    long
+    Stats::counter(const std::string &name) const
+    {
+        return find_in(_counters, name);
+    }
+
+    double
+    Stats::timer(const std::string &name) const
+    {
+        return find_in(_timers, name);
+    }
+
+    void
+    Stats::add(const Stats &other)
+    {
+        for (auto &c : other._counters)
+            count(c.first, c.second);
+        for (auto &t : other._timers)
+            time(t.first, t.second);
+    }
+
+    void
+    Stats::clear()
+    {
+        _counters.clear();
+        _timers.clear();
+    }
+
+    static void
+    write_json_string(std::ostream &out, const std::string &s)
+    {
+        out << '"';
+        for (char c : s)
+        {
+            if (c == '"' or c == '\\')
+                out << '\\';
+            out << c;
+        }
+        out << '"';
+    }
+
+    void
+    Stats::write_json(std::ostream &out) const
+    {
+        out << "{\"counters\": {";
+        for (size_t i = 0; i < _counters.size(); i++)
+        {
+            if (i != 0)
+                out << ", ";
+            write_json_string(out, _counters[i].first);
+            out << ": " << _counters[i].second;
+        }
+        out << "}, \"timers\": {";
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(6);
+        for (size_t i = 0; i < _timers.size(); i++)
+        {
+            if (i != 0)
+                out << ", ";
+            write_json_string(out, _timers[i].first);
+            out << ": " << _timers[i].second;
+        }
+        out.flags(flags);
+        out.precision(precision);
+        out << "}}";
+    }
+
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pg
+{
+
+    /**
+     * Statistics of a run: named counters and timers (in seconds), in order of first use.
+     * Adding to an existing name accumulates, e.g., over the runs of a partial solver.
+     */
+    class Stats
+    {
+    public:
+        /**
+         * Add <value> to counter <name>.
+         */
+        void count(const std::string &name, long value = 1);
+
+        /**
+         * Add <seconds> to timer <name>.
+         */
+        void time(const std::string &name, double seconds);
+
+        /**
+         * Returns the value of counter <name>, or 0 if it was never counted.
+         */
+        long counter(const std::string &name) const;
+
+        /**
+         * Returns the value of timer <name>, or 0.0 if it was never timed.
+         */
+        double timer(const std::string &name) const;
+
+        const std::vector<std::pair<std::string, long>> &counters() const { return _counters; }
+        const std::vector<std::pair<std::string, double>> &timers() const { return _timers; }
+
+        /**
+         * Add all counters and timers of <other>.
+         */
+        void add(const Stats &other);
+
+        void clear();
+
+        /**
+         * Write the statistics as a JSON object {"counters": {...}, "timers": {...}}.
+         */
+        void write_json(std::ostream &out) const;
+
+    protected:
+        std::vector<std::pair<std::string, long>> _counters;
+        std::vector<std::pair<std::string, double>> _timers;
+    };
+
+}
+
+#endif
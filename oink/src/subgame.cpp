@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "subgame.hpp"
+
+namespace pg
+{
+
+    SubgameView::SubgameView(const Game &game, const bitset &mask) : game(game), _mask(mask)
+    {
+        init_ranks();
+    }
+
+    SubgameView::SubgameView(const Game &game, const std::vector<int> &selection) : game(game), _mask(game.vertexcount())
+    {
+        for (int v : selection)
+            _mask[v] = true;
+        init_ranks();
+    }
+
+    void
+    SubgameView::init_ranks(void)
+    {
+        const long n = game.vertexcount();
+        _ranks.resize((n + 63) / 64);
+        int count = 0;
+        for (size_t i = 0; i < _ranks.size(); i++)
+        {
+            _ranks[i] = count;
+            count += __builtin_popcountll(_mask.block(i));
+        }
+
+        _vertices.reserve(count);
+        for (auto v = _mask.find_first(); v != bitset::npos; v = _mask.find_next(v))
+            _vertices.push_back(v);
+    }
+
+    Game *
+    SubgameView::materialize() const
+    {
+        const int nv = vertexcount();
+        std::vector<int> count(nv);
+        int maxprio = 0;
+        for (int w = 0; w < nv; w++)
+        {
+            const int v = _vertices[w];
+            for (auto curedge = game.outs(v); *curedge != -1; curedge++)
+            {
+                if (_mask[*curedge])
+                    count[w]++;
+            }
+            if (game.priority(v) > maxprio)
+                maxprio = game.priority(v);
+        }
+
+        Game *res = new Game();
+        res->init_csr(nv, count.data(), maxprio);
+        for (int w = 0; w < nv; w++)
+        {
+            const int v = _vertices[w];
+            res->set_priority(w, game.priority(v));
+            res->set_owner(w, game.owner(v));
+            const char *label = game.rawlabel(v);
+            if (label != NULL)
+                res->set_label(w, label);
+            int *slot = res->outslots(w);
+            for (int to : outs(v))
+                *slot++ = to_sub(to);
+        }
+        res->csr_finish();
+        return res;
+    }
+
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SUBGAME_HPP
+#define SUBGAME_HPP
+
+#include <vector>
+
+#include "game.hpp"
+
+namespace pg
+{
+
+    /**
+     * The subgame of a game induced by a set of vertices, without copying the game.
+     * The vertices of the subgame are numbered 0..vertexcount()-1 in the order of the
+     * parent game, so a subgame of a sorted game is sorted. to_sub and to_parent translate
+     * between the two numberings; to_sub needs only a prefix count per 64 vertices.
+     *
+     * Solvers can traverse the view directly (outs and ins skip the vertices outside the
+     * subgame), or, if the subgame is small compared to the parent (see compact), work on
+     * a materialized copy with its own edge arrays, so they no longer scan the edges to
+     * the rest of the game. The parent must not change while the view exists.
+     */
+    class SubgameView
+    {
+    public:
+        /**
+         * The subgame of <game> of the vertices in <mask>, or in <selection>.
+         */
+        SubgameView(const Game &game, const bitset &mask);
+        SubgameView(const Game &game, const std::vector<int> &selection);
+
+        /**
+         * The edges of a vertex of the parent that stay in the subgame, as parent vertices.
+         */
+        class edges
+        {
+        public:
+            class iterator
+            {
+            public:
+                iterator(const int *ptr, const bitset &mask) : ptr(ptr), mask(mask) { skip(); }
+                inline int operator*() const { return *ptr; }
+                inline iterator &operator++()
+                {
+                    ptr++;
+                    skip();
+                    return *this;
+                }
+                inline bool operator!=(const iterator &) const { return *ptr != -1; }
+
+            private:
+                inline void skip()
+                {
+                    while (*ptr != -1 and !mask[*ptr])
+                        ptr++;
+                }
+                const int *ptr;
+                const bitset &mask;
+            };
+
+            edges(const int *ptr, const bitset &mask) : ptr(ptr), mask(mask) {}
+            inline iterator begin() const { return iterator(ptr, mask); }
+            inline iterator end() const { return iterator(ptr, mask); } // ends at the -1
+
+        private:
+            const int *ptr;
+            const bitset &mask;
+        };
+
+        inline const Game &parent() const { return game; }
+        inline const bitset &mask() const { return _mask; }
+
+        /**
+         * Return the number of vertices of the subgame.
+         */
+        inline long vertexcount() const { return _vertices.size(); }
+
+        /**
+         * Returns whether vertex <v> of the parent is in the subgame.
+         */
+        inline bool contains(int v) const { return _mask[v]; }
+
+        /**
+         * Translate vertex <v> of the parent (in the subgame) to the subgame, and back.
+         */
+        inline int to_sub(int v) const
+        {
+            const uint64_t below = _mask.block(v / 64) & ((uint64_t(1) << (v % 64)) - 1);
+            return _ranks[v / 64] + __builtin_popcountll(below);
+        }
+        inline int to_parent(int w) const { return _vertices[w]; }
+
+        /**
+         * The vertices of the subgame, as vertices of the parent, in order.
+         */
+        inline const std::vector<int> &vertices() const { return _vertices; }
+
+        /**
+         * The successors and predecessors of vertex <v> of the parent in the subgame.
+         * (ins requires the in array of the parent, see Game::build_in_array.)
+         */
+        inline edges outs(int v) const { return edges(game.outs(v), _mask); }
+        inline edges ins(int v) const { return edges(game.ins(v), _mask); }
+
+        /**
+         * Returns whether the subgame is small enough compared to the parent that
+         * materializing it pays off, i.e., at most 1/COMPACT_RATIO of the vertices.
+         */
+        static const int COMPACT_RATIO = 4;
+        inline bool compact() const { return vertexcount() * COMPACT_RATIO <= game.vertexcount(); }
+
+        /**
+         * Create a new Game of the subgame, with vertex <w> for vertex to_parent(w), with
+         * its priority, owner and label, and the edges of the subgame only.
+         * Vertices without successors in the subgame become dead ends; the caller decides
+         * whether the subgame must be total.
+         * The solution of the parent is not copied.
+         */
+        Game *materialize() const;
+
+    private:
+        void init_ranks(void);
+
+        const Game &game;
+        bitset _mask;
+        std::vector<int> _ranks;    // the number of vertices of the subgame before every block of 64 vertices
+        std::vector<int> _vertices; // the vertices of the subgame in the parent
+    };
+
+}
+
+#endif
@@ -15,6 +15,7 @@
  */
 
 #include "tl.hpp"
+#include "phases.hpp"
 
 
 #define PARTIALLY_CLOSED 0 // find tangles in partially locally closed regions, but costs time on practical games
@@ -186,6 +187,7 @@ TLSolver::attractTangles(const int pl, int v, bitset &R, bitset &Z, int maxpr)
 bool
 TLSolver::extractTangles(int startvertex, bitset &R, int *str)
 {
+    OINK_PHASE("extractTangles");
     bool new_tangles = false;
     const int pr = priority(startvertex);
     const int pl = pr&1;
@@ -663,6 +665,9 @@ TLSolver::run()
 
     logger << "found " << dominions << " dominions and "<< tangles << " tangles." << std::endl;
     logger << "solved in " << iterations << " iterations." << std::endl;
+    stats.count("dominions", dominions);
+    stats.count("tangles", tangles);
+    stats.count("iterations", iterations);
 
 #ifndef NDEBUG
     // Check if the whole game is now solved
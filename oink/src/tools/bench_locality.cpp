@@ -0,0 +1,286 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Benchmark of the vertex order of a game: the time and cache misses of an attractor
+ * decomposition over ins(), a sweep over outs() and optionally a solver, once with the
+ * vertices sorted by priority (Game::sort) and once also sorted for locality
+ * (Game::sort_locality). Cache misses are read from the Linux perf counters; they are
+ * "n/a" if the kernel does not allow that (see /proc/sys/kernel/perf_event_paranoid).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "game.hpp"
+#include "generators.hpp"
+#include "oink.hpp"
+
+using namespace pg;
+
+/**
+ * A hardware event counter of this thread, or a dummy if not available.
+ */
+class perf_counter
+{
+public:
+    perf_counter(uint32_t type, uint64_t config) : fd(-1) {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+        (void)type;
+        (void)config;
+#endif
+    }
+
+    ~perf_counter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    void start() {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    /**
+     * Returns the count since start(), or -1 if not available.
+     */
+    long stop() {
+#ifdef __linux__
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count;
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+
+private:
+    int fd;
+};
+
+struct measurement
+{
+    double ms;
+    long l1_misses;
+    long llc_misses;
+};
+
+template <typename F>
+static measurement
+measure(F f, int rounds)
+{
+#ifdef __linux__
+    perf_counter l1(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    perf_counter llc(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#else
+    perf_counter l1(0, 0), llc(0, 0);
+#endif
+    l1.start();
+    llc.start();
+    auto start = std::chrono::steady_clock::now();
+    for (int i=0; i<rounds; i++) f();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    measurement m;
+    m.llc_misses = llc.stop();
+    m.l1_misses = l1.stop();
+    m.ms = ms / rounds;
+    if (m.l1_misses > 0) m.l1_misses /= rounds;
+    if (m.llc_misses > 0) m.llc_misses /= rounds;
+    return m;
+}
+
+/**
+ * The top-level attractor decomposition of Zielonka's algorithm: repeatedly attract to the
+ * vertices of the highest remaining priority, for the player of that priority.
+ */
+static long
+attract_all(const Game &game, std::vector<int> &count, std::vector<char> &removed, std::vector<int> &queue)
+{
+    const int n = game.vertexcount();
+    for (int v=0; v<n; v++) count[v] = game.outcount(v);
+    std::fill(removed.begin(), removed.end(), 0);
+
+    long attracted = 0;
+    for (int top=n-1; top>=0; top--) {
+        if (removed[top]) continue;
+        const int pr = game.priority(top);
+        const int pl = pr & 1;
+        queue.clear();
+        for (int v=top; v>=0 and game.priority(v) == pr; v--) {
+            if (!removed[v]) {
+                removed[v] = 1;
+                queue.push_back(v);
+            }
+        }
+        for (size_t i=0; i<queue.size(); i++) {
+            for (auto curedge = game.ins(queue[i]); *curedge != -1; curedge++) {
+                const int from = *curedge;
+                if (removed[from]) continue;
+                if (game.owner(from) == pl or --count[from] == 0) {
+                    removed[from] = 1;
+                    queue.push_back(from);
+                }
+            }
+        }
+        attracted += queue.size();
+    }
+    return attracted;
+}
+
+/**
+ * A sweep over the successors of all vertices, reading their priorities, as the lifting
+ * and strategy improvement solvers do.
+ */
+static long
+scan_all(const Game &game)
+{
+    long sum = 0;
+    const int n = game.vertexcount();
+    for (int v=0; v<n; v++) {
+        for (auto curedge = game.outs(v); *curedge != -1; curedge++) {
+            sum += game.priority(*curedge) > game.priority(v);
+        }
+    }
+    return sum;
+}
+
+static void
+print_counter(long count)
+{
+    std::cout << std::setw(12);
+    if (count < 0) std::cout << "n/a";
+    else std::cout << count;
+}
+
+static void
+print_row(const char *what, const measurement &m)
+{
+    std::cout << std::left << std::setw(10) << what << std::right;
+    std::cout << std::setw(12) << std::fixed << std::setprecision(2) << m.ms;
+    print_counter(m.l1_misses);
+    print_counter(m.llc_misses);
+    std::cout << std::endl;
+}
+
+static void
+bench(Game &game, const char *order, int rounds, const std::string &solver)
+{
+    game.build_in_array(false);
+
+    const int n = game.vertexcount();
+    std::vector<int> count(n), queue;
+    std::vector<char> removed(n);
+    volatile long sink = 0;
+
+    std::cout << order << ":" << std::endl;
+    print_row("attract", measure([&]() { sink += attract_all(game, count, removed, queue); }, rounds));
+    print_row("scan", measure([&]() { sink += scan_all(game); }, rounds));
+
+    if (!solver.empty()) {
+        Game copy(game);
+        std::ostream null(NULL);
+        Oink en(copy, null);
+        en.setSolver(solver);
+        print_row(solver.c_str(), measure([&]() { en.run(); }, 1));
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+    std::string solver;
+    bool shuffle = false;
+    int rounds = 10;
+
+    int arg = 1;
+    for (; arg < argc and argv[arg][0] == '-'; arg++) {
+        const std::string opt = argv[arg];
+        if (opt == "--shuffle") shuffle = true;
+        else if (opt == "-s" and arg+1 < argc) solver = argv[++arg];
+        else if (opt == "-r" and arg+1 < argc) rounds = std::max(1, std::stoi(argv[++arg]));
+        else break;
+    }
+    if (arg >= argc) {
+        std::cout << "Syntax: " << argv[0] << " [--shuffle] [-r rounds] [-s solver] (FILE | FAMILY ARGS...)" << std::endl;
+        std::cout << "  --shuffle   renumber the vertices randomly first, as in a game without locality" << std::endl;
+        std::cout << "  FAMILY      a game family of the generator library, e.g., ladder 1000000" << std::endl;
+        return -1;
+    }
+
+    Game game(1);
+    try {
+        std::ifstream file(argv[arg]);
+        if (file.good()) {
+            game.parse_pgsolver(file, false);
+        } else {
+            std::vector<long> args;
+            for (int i=arg+1; i<argc; i++) args.push_back(std::stol(argv[i]));
+            generators::generate(game, argv[arg], args, 42);
+        }
+    } catch (const char *err) {
+        std::cerr << "error: " << err << std::endl;
+        return -1;
+    }
+
+    if (shuffle) {
+        std::vector<int> mapping(game.vertexcount());
+        for (int i=0; i<game.vertexcount(); i++) mapping[i] = i;
+        std::shuffle(mapping.begin(), mapping.end(), std::mt19937(42));
+        game.permute(mapping.data());
+    }
+
+    std::cout << game.vertexcount() << " vertices, " << game.edgecount() << " edges" << std::endl;
+    std::cout << std::left << std::setw(10) << "" << std::right << std::setw(12) << "time (ms)" << std::setw(12) << "L1 misses" << std::setw(12) << "LLC misses" << std::endl;
+
+    Game sorted(game);
+    sorted.sort();
+    bench(sorted, "priority order", rounds, solver);
+
+    game.sort_locality();
+    bench(game, "locality order", rounds, solver);
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2017-2018 Tom van Dijk, Johannes Kepler University Linz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Microbenchmark of the succinct measure kernels of SSPMSolver (compare, prog, trunc)
+ * on random measures, for a range of bit lengths l and depths h.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "sspm.hpp"
+
+using namespace pg;
+
+static std::mt19937 generator(42);
+
+static int
+rng(int low, int high)
+{
+    return std::uniform_int_distribution<int>(low, high)(generator);
+}
+
+/**
+ * Fill <m> with a random measure of <l> slots: nondecreasing depths in 0..h, random bits.
+ * The padding slots up to <ls> are 0, as in SSPMSolver.
+ */
+static void
+random_measure(uint16_t *m, int l, int ls, int h)
+{
+    std::vector<int> depths(l);
+    for (int i=0; i<l; i++) depths[i] = rng(0, h);
+    std::sort(depths.begin(), depths.end());
+    for (int i=0; i<l; i++) m[i] = sspm_key(depths[i], rng(0, 1), h);
+    for (int i=l; i<ls; i++) m[i] = 0;
+}
+
+static double
+seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int
+main(int argc, char** argv)
+{
+    if (argc > 2) {
+        std::cout << "Syntax: " << argv[0] << " [iterations]" << std::endl;
+        return -1;
+    }
+
+    const int iters = argc == 2 ? std::stoi(argv[1]) : 10000000;
+    const int count = 1024; // measures per configuration, must be a power of 2
+    const int lengths[] = { 4, 8, 16, 32 };
+    const int hs[] = { 8, 100, 10000 };
+
+    std::cout << "     l       h   compare (ns)   prog (ns)   trunc (ns)" << std::endl;
+    for (int l : lengths) {
+        const int ls = (l+3) & ~3;
+        for (int h : hs) {
+            std::vector<uint16_t> ms((size_t)count*ls), tmp(ls);
+            std::vector<int> ps(count);
+            for (int i=0; i<count; i++) {
+                random_measure(ms.data() + (size_t)i*ls, l, ls, h);
+                ps[i] = rng(0, h);
+            }
+            // make half the pairs share a prefix, so compare does not always stop at the first word
+            for (int i=0; i<count; i+=2) {
+                const int shared = rng(0, l);
+                for (int j=0; j<shared; j++) ms[(size_t)(i+1)*ls+j] = ms[(size_t)i*ls+j];
+                std::sort(ms.begin() + (size_t)(i+1)*ls, ms.begin() + (size_t)(i+1)*ls + l,
+                    [h](uint16_t a, uint16_t b) { return sspm_depth(a, h) < sspm_depth(b, h); });
+            }
+
+            long sum = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int it=0; it<iters; it++) {
+                const int i = it & (count-1);
+                const int j = (it+1) & (count-1);
+                sum += sspm_compare(ms.data() + (size_t)i*ls, ms.data() + (size_t)j*ls, ls, h, ps[i]);
+            }
+            const double t_compare = seconds_since(start);
+
+            start = std::chrono::steady_clock::now();
+            for (int it=0; it<iters; it++) {
+                const int i = it & (count-1);
+                memcpy(tmp.data(), ms.data() + (size_t)i*ls, sizeof(uint16_t[ls]));
+                sspm_prog(tmp.data(), l, h, ps[i]);
+                sum += tmp[l-1];
+            }
+            const double t_prog = seconds_since(start);
+
+            start = std::chrono::steady_clock::now();
+            for (int it=0; it<iters; it++) {
+                const int i = it & (count-1);
+                memcpy(tmp.data(), ms.data() + (size_t)i*ls, sizeof(uint16_t[ls]));
+                sspm_trunc(tmp.data(), l, h, ps[i]);
+                sum += tmp[l-1];
+            }
+            const double t_trunc = seconds_since(start);
+
+            std::cout.width(6); std::cout << l;
+            std::cout.width(8); std::cout << h;
+            std::cout.width(15); std::cout << 1e9*t_compare/iters;
+            std::cout.width(12); std::cout << 1e9*t_prog/iters;
+            std::cout.width(13); std::cout << 1e9*t_trunc/iters;
+            std::cout << (sum == 42 ? " " : "") << std::endl; // keep <sum> alive
+        }
+    }
+
+    return 0;
+}
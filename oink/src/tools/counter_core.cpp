@@ -14,9 +14,10 @@
  * limitations under the License.
  */
 
+
 #include <iostream>
 
-#include "game.hpp"
+#include "generators.hpp"
 
 using namespace pg;
 
@@ -24,33 +25,17 @@ using namespace pg;
 int
 main(int argc, char** argv)
 {
-    if (argc != 2) {
+    if (argc < 2) {
         std::cout << "Syntax: " << argv[0] << " N" << std::endl;
         return -1;
     }
 
-    int n = 2*std::stoi(argv[1]);
-
-    Game game(3+3*n);
-    game.vec_init();
-
-    /* create n+1 pieces */
-    for (int i=0; i<=n; i++) {
-        game.init_vertex(3*i+0, n+1+i, (i&1));
-        game.init_vertex(3*i+1, i, (i&1));
-        game.init_vertex(3*i+2, i, 1-(i&1));
-        game.vec_add_edge(3*i+0, 3*i+1);
-        game.vec_add_edge(3*i+1, 3*i+2);
-        game.vec_add_edge(3*i+2, 3*i+1);
-        game.vec_add_edge(3*i+2, 3*i+2);
-    }
-    
-    /* connect the pieces */
-    for (int i=0; i<n; i++) {
-        game.vec_add_edge(3*i+2, 3*i+3);
-        game.vec_add_edge(3*i+4, 3*i+0);
+    try {
+        Game game(1);
+        generators::counter_core(game, std::stoi(argv[1]));
+        game.write_pgsolver(std::cout);
+    } catch (const char *err) {
+        std::cerr << "error: " << err << std::endl;
+        return -1;
     }
-
-    game.vec_finish();
-    game.write_pgsolver(std::cout);
 }
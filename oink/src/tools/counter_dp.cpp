@@ -14,44 +14,27 @@
  * limitations under the License.
  */
 
+
 #include <iostream>
 
-#include "game.hpp"
+#include "generators.hpp"
 
 using namespace pg;
 
 int
 main(int argc, char** argv)
 {
-    if (argc != 2) {
+    if (argc < 2) {
         std::cout << "Syntax: " << argv[0] << " N" << std::endl;
         return -1;
     }
 
-    int n = std::stoi(argv[1]);
-
-    Game game(4+n*4);
-    game.vec_init();
-
-    /* create n+1 pieces */
-    for (int i=0; i<=n; i++) {
-        game.init_vertex(4*i+0, i, 1-(i&1));
-        game.init_vertex(4*i+1, i, 1-(i&1));
-        game.init_vertex(4*i+2, i, (i&1));
-        game.init_vertex(4*i+3, i+3, (i&1));
-        game.vec_add_edge(4*i+0, 4*i+1);
-        game.vec_add_edge(4*i+1, 4*i+0);
-        game.vec_add_edge(4*i+1, 4*i+2);
-        game.vec_add_edge(4*i+2, 4*i+1);
-        game.vec_add_edge(4*i+3, 4*i+2);
-    }
-    
-    /* connect the pieces */
-    for (int i=0; i<n; i++) {
-        game.vec_add_edge(4*i+6, 4*i+3);
-        game.vec_add_edge(4*i+1, 4*i+7);
+    try {
+        Game game(1);
+        generators::counter_dp(game, std::stoi(argv[1]));
+        game.write_pgsolver(std::cout);
+    } catch (const char *err) {
+        std::cerr << "error: " << err << std::endl;
+        return -1;
     }
-
-    game.vec_finish();
-    game.write_pgsolver(std::cout);
 }
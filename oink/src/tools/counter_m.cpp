@@ -14,42 +14,27 @@
  * limitations under the License.
  */
 
+
 #include <iostream>
 
-#include "game.hpp"
+#include "generators.hpp"
 
 using namespace pg;
 
 int
 main(int argc, char** argv)
 {
-    if (argc != 2) {
+    if (argc < 2) {
         std::cout << "Syntax: " << argv[0] << " N" << std::endl;
         return -1;
     }
 
-    int n = std::stoi(argv[1]);
-
-    Game game(3*n+3);
-    game.vec_init();
-
-    /* create 2n+1 pieces */
-    for (int i=0; i<=n; i++) {
-        game.init_vertex(3*i+0, i+2, (i&1));
-        game.init_vertex(3*i+1, 1-(i&1), (i&1));
-        game.init_vertex(3*i+2, 1-(i&1), 1-(i&1));
-        game.vec_add_edge(3*i+0, 3*i+1);
-        game.vec_add_edge(3*i+1, 3*i+2);
-        game.vec_add_edge(3*i+2, 3*i+1);
-    }
-    
-    /* connect the pieces */
-    for (int i=0; i<n; i++) {
-        game.vec_add_edge(3*i+0, 3*i+3);
-        game.vec_add_edge(3*i+1, 3*i+3);
-        game.vec_add_edge(3*i+5, 3*i+2);
+    try {
+        Game game(1);
+        generators::counter_m(game, std::stoi(argv[1]));
+        game.write_pgsolver(std::cout);
+    } catch (const char *err) {
+        std::cerr << "error: " << err << std::endl;
+        return -1;
     }
-
-    game.vec_finish();
-    game.write_pgsolver(std::cout);
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright 2021 Tom van Dijk, Johannes Kepler University Linz
+ * Copyright 2017-2018 Tom van Dijk, Johannes Kepler University Linz
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -14,9 +14,10 @@
  * limitations under the License.
  */
 
+
 #include <iostream>
 
-#include "game.hpp"
+#include "generators.hpp"
 
 using namespace pg;
 
@@ -28,34 +29,12 @@ main(int argc, char** argv)
         return -1;
     }
 
-    const int n = std::stoi(argv[1]);
-
-    Game game(1 + 5*n);
-    game.vec_init();
-
-    game.init_vertex(0, 0, 1);              // root of the distracted tangle
-    game.vec_add_edge(0, 0);                // self-loop
-
-    for (int i=0; i<n; i++) {
-        int c = 5*i+1;
-        int d = 2*(n+i+1);
-        game.init_vertex(c+0, 2*(n-i), 0);  // distracted vertex
-        game.init_vertex(c+1, d, 0);        // distraction
-        game.init_vertex(c+2, 1, 1);        // opponent tangle start
-        game.init_vertex(c+3, 1, 0);        // opponent tangle end
-        game.init_vertex(c+4, d+1, 0);      // attracting odd vertex
-        game.vec_add_edge(c+0, 0);          // from distracted vertex to root
-        game.vec_add_edge(0, c+0);          // from root to distracted vertex
-        game.vec_add_edge(c+0, c+1);        // from distracted vertex to distraction
-        game.vec_add_edge(c+1, c+2);        // from distraction to tangle
-        game.vec_add_edge(c+2, c+3);        // tangle forward edge
-        game.vec_add_edge(c+3, c+2);        // tangle backward edge
-        game.vec_add_edge(c+3, c+4);        // tangle to attracting odd vertex
-        game.vec_add_edge(c+4, c);          // attracting odd vertex to distracted tangle
+    try {
+        Game game(1);
+        generators::counter_ortl(game, std::stoi(argv[1]));
+        game.write_pgsolver(std::cout);
+    } catch (const char *err) {
+        std::cerr << "error: " << err << std::endl;
+        return -1;
     }
-
-    game.vec_finish();
-    game.sort();
-    game.renumber();
-    game.write_pgsolver(std::cout);
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright 2021 Tom van Dijk, Johannes Kepler University Linz
+ * Copyright 2017-2018 Tom van Dijk, Johannes Kepler University Linz
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -14,9 +14,10 @@
  * limitations under the License.
  */
 
+
 #include <iostream>
 
-#include "game.hpp"
+#include "generators.hpp"
 
 using namespace pg;
 
@@ -24,68 +25,17 @@ using namespace pg;
 int
 main(int argc, char** argv)
 {
-    if (argc != 2) {
+    if (argc < 2) {
         std::cout << "Syntax: " << argv[0] << " N" << std::endl;
         return -1;
     }
 
-    int n = 2*std::stoi(argv[1]);
-
-    // core: 3*(n+1)
-    // extension: 3*(n*n+(n&1))/4 + n
-    int n_positions = 3*(n+1) + n + (3*n*n+(n&1))/4;
-
-    Game game(n_positions);
-    game.vec_init();
-
-    /* create n+1 pieces */
-    for (int i=0; i<=n; i++) {
-        game.init_vertex(3*i+0, n+1+i, (i&1));
-        game.init_vertex(3*i+1, i, (i&1));
-        game.init_vertex(3*i+2, i, 1-(i&1));
-        game.vec_add_edge(3*i+0, 3*i+1);
-        game.vec_add_edge(3*i+1, 3*i+2);
-        game.vec_add_edge(3*i+2, 3*i+1);
-        game.vec_add_edge(3*i+2, 3*i+2);
-    }
-    
-    /* connect the pieces */
-    for (int i=0; i<n; i++) {
-        game.vec_add_edge(3*i+2, 3*i+3);
-        game.vec_add_edge(3*i+4, 3*i+0);
-    }
-
-    /* create more connectors */
-    int nxt = 3*n+3;
-    for (int i=0; i<=n; i++) {
-        for (int j=i+1; j<=n; j++) {
-            int i_parity = 1-(i&1); // parity of c_i vertex
-            int j_parity = 1-(j&1); // parity of c_j vertex
-            int ci = 3*i+2;
-            int cj = 3*j+2;
-            if (i_parity == j_parity) {
-                // same parity, only need 1 
-                game.init_vertex(nxt, 0, 1-i_parity);
-                game.vec_add_edge(ci, nxt);
-                game.vec_add_edge(cj, nxt);
-                game.vec_add_edge(nxt, ci);
-                game.vec_add_edge(nxt, cj);
-                nxt++;
-            } else {
-                // different parity, so we need two
-                game.init_vertex(nxt,   0, 1-i_parity);
-                game.init_vertex(nxt+1, 0, 1-j_parity);
-                game.vec_add_edge(ci, nxt);
-                game.vec_add_edge(nxt, ci);
-                game.vec_add_edge(nxt, nxt+1);
-                game.vec_add_edge(nxt+1, nxt);
-                game.vec_add_edge(cj, nxt+1);
-                game.vec_add_edge(nxt+1, cj);
-                nxt+=2;
-            }
-        }        
+    try {
+        Game game(1);
+        generators::counter_rob(game, std::stoi(argv[1]));
+        game.write_pgsolver(std::cout);
+    } catch (const char *err) {
+        std::cerr << "error: " << err << std::endl;
+        return -1;
     }
-
-    game.vec_finish();
-    game.write_pgsolver(std::cout);
 }
@@ -14,18 +14,13 @@
  * limitations under the License.
  */
 
+
 #include <iostream>
 #include <random>
 
-using namespace std;
+#include "generators.hpp"
 
-int
-rng(int low, int high)
-{
-    static random_device rand_dev;
-    static mt19937 generator(rand_dev());
-    return uniform_int_distribution<int>(low, high)(generator);
-}
+using namespace std;
 
 int
 main(int argc, char** argv)
@@ -41,56 +36,17 @@ main(int argc, char** argv)
     int maxP = stoi(argv[2]);
     int minD = stoi(argv[3]);
     int maxD = stoi(argv[4]);
-    int SL = argc == 5 ? 1 : 0;
-
-    // check bad arguments
-    if (maxD > n) {
-        cout << "max degree >= num nodes?!" << endl;
+    bool SL = argc == 5;
+
+    try {
+        pg::Game game(1);
+        pg::generators::random(game, n, maxP, minD, maxD, SL, random_device()());
+        game.write_pgsolver(cout);
+    } catch (const char *err) {
+        cout << err << "?!" << endl;
         cout.flush();
         return -1;
     }
-    if (minD > maxD) {
-        cout << "min degree >= max degree?!" << endl;
-        cout.flush();
-        return -1;
-    }
-    if (maxD == n && SL == 0) {
-        maxD--; // just fix the number
-    }
-
-    // allocate edge target array
-    int *tgt = new int[n];
-
-    // generate game
-    cout << "parity " << n << ";" << endl;
-    for (int i=0; i<n; i++) {
-        // generate priority and owner
-        cout << i << " " << rng(0, maxP) << " " << rng(0, 1) << " ";
-        // determine number of edges
-        int e_count = rng(minD, maxD);
-        // initialize edge target array
-        for (int j=0; j<n; j++) tgt[j] = j;
-        // initialize size of array
-        int m = n;
-        // maybe remove the self-loop
-        if (SL == 0) {
-            tgt[i] = n-1;
-            m--;
-        }
-        // generate random edges
-        for (int j=0; j<e_count; j++) {
-            int x = rng(0, m-1);
-            if (j != 0) cout << ",";
-            cout << tgt[x];
-            tgt[x] = tgt[m-1];
-            m--;
-        }
-        // generate no label
-        cout << ";" << endl;
-    }
-
-    // free edge target array
-    delete[] tgt;
 
     return 0;
 }
@@ -29,6 +29,7 @@
 #include "cxxopts.hpp"
 #include "game.hpp"
 #include "oink.hpp"
+#include "phases.hpp"
 #include "solvers.hpp"
 #include "verifier.hpp"
 #include "tools/getrss.h"
@@ -219,23 +220,31 @@ int main(int argc, char **argv)
         ("help", "Print help")
         ("t,trace", "Generate trace (with increasing verbosity)")
         ("v,verify", "Verify solution")
+        ("par-verify", "Verify solution with the parallel verifier (with --workers, default autodetect)")
         ("p,print", "Print solution to stdout")
         ("i,input", "Input parity game", cxxopts::value<std::string>())
         ("sol", "Input (partial) solution", cxxopts::value<std::string>())
         ("o,output", "Output game or solution", cxxopts::value<std::string>())
+        ("cert", "Output certificate of the solution (for verify)", cxxopts::value<std::string>())
+        ("stats", "Output solver statistics as JSON (- for stdout)", cxxopts::value<std::string>())
+        ("phases", "Output phase timers as a Chrome trace (needs OINK_PHASES)", cxxopts::value<std::string>())
         ("dot", "Write .dot file (before preprocessing)", cxxopts::value<std::string>())
         /* Preprocessing */
         ("inflate", "Inflate game")
         ("compress", "Compress game")
+        ("locality", "Renumber vertices within each priority for memory locality")
         ("no-single", "Do not solve single-parity games during preprocessing")
         ("no-loops", "Do not remove self-loops during preprocessing (default behavior)")
         ("no-wcwc", "Do not solve winner-controlled winning cycles during preprocessing")
         ("no", "Do not touch the game at all")
         /* Solving */
         ("scc", "Iteratively solve bottom SCCs")
+        ("no-compact", "Do not continue on a compacted copy when most vertices are solved")
         ("s,solver", "Use given solver (--solvers for info)", cxxopts::value<std::string>())
         ("solvers", "List available solvers")
         ("w,workers", "Number of workers for parallel code", cxxopts::value<int>())
+        ("lace-stats", "Report tasks, steals and idle time of the Lace workers (needs OINK_LACE_STATS)")
+        ("mem", "Memory policy for parallel solvers: thp, hugetlb, interleave, first-touch (comma separated) or default", cxxopts::value<std::string>())
         ("z,timeout", "Number of seconds for timeout", cxxopts::value<int>());
 
     /* Add solvers */
@@ -341,9 +350,20 @@ int main(int argc, char **argv)
      * (Remember the mapping to reverse the reindex later.)
      */
 
+    // keep the original priorities for the certificate, as preprocessing renumbers them
+    Game *original = options.count("cert") ? new Game(pg) : NULL;
+
     int *mapping = new int[pg.nodecount()];
-    pg.sort(mapping);
-    out << "parity game reindexed" << std::endl;
+    if (options.count("locality"))
+    {
+        pg.sort_locality(mapping);
+        out << "parity game reindexed for locality" << std::endl;
+    }
+    else
+    {
+        pg.sort(mapping);
+        out << "parity game reindexed" << std::endl;
+    }
 
     /**
      * STEP 5
@@ -369,25 +389,42 @@ int main(int argc, char **argv)
         en.setRemoveWCWC(false);
 
     // solver
+    std::string solver_label = "tl"; // default solver
     if (options.count("solver"))
     {
-        en.setSolver(solvers.id(options["solver"].as<std::string>()));
+        solver_label = options["solver"].as<std::string>();
     }
     else
     {
-        en.setSolver("tl"); // default solver
         for (unsigned id = 0; id < solvers.count(); id++)
         {
             if (options.count(solvers.label(id)))
-                en.setSolver(id);
+                solver_label = solvers.label(id);
         }
     }
+    en.setSolver(solvers.id(solver_label));
 
     // solving options
     if (options.count("scc"))
         en.setBottomSCC(true);
+    if (options.count("no-compact"))
+        en.setCompaction(false);
     if (options.count("workers"))
         en.setWorkers(options["workers"].as<int>());
+    if (options.count("lace-stats"))
+        en.setLaceStats(true);
+    if (options.count("mem"))
+    {
+        try
+        {
+            en.setMemPolicy(mem_policy::parse(options["mem"].as<std::string>()));
+        }
+        catch (const char *err)
+        {
+            out << "option error: " << err << std::endl;
+            return -1;
+        }
+    }
 
     /**
      * STEP 6
@@ -410,17 +447,41 @@ int main(int argc, char **argv)
         return -1;
     }
 
+    if (options.count("stats"))
+    {
+        // write statistics to file or stdout
+        std::ofstream file;
+        const std::string filename = options["stats"].as<std::string>();
+        if (filename != "-")
+            file.open(filename);
+        std::ostream &os = filename == "-" ? std::cout : file;
+        os << "{\"solver\": \"" << solver_label << "\", \"vertices\": " << pg.vertexcount() << ", \"edges\": " << pg.edgecount() << ", \"stats\": ";
+        en.getStats().write_json(os);
+        os << "}" << std::endl;
+    }
+
+    if (options.count("phases"))
+    {
+        // write the phases of parsing, preprocessing and solving, for chrome://tracing or speedscope
+        if (!phases::enabled())
+            out << "phase timers are not compiled in, configure with -DOINK_PHASES=ON" << std::endl;
+        std::ofstream file(options["phases"].as<std::string>());
+        phases::write_chrome_trace(file);
+    }
+
     /**
      * STEP 7
      * Verify the solution.
      */
 
-    if (options.count("v"))
+    if (options.count("v") or options.count("par-verify"))
     {
         try
         {
             out << "verifying solution..." << std::endl;
             Verifier v(&pg, out);
+            if (options.count("par-verify"))
+                v.setWorkers(options.count("workers") ? options["workers"].as<int>() : 0);
             double vbegin = wctime();
             v.verify(true, true, false);
             double vend = wctime();
@@ -445,7 +506,7 @@ int main(int argc, char **argv)
      * Revert reindex if we need to output.
      */
 
-    if (options.count("output") or options.count("p"))
+    if (options.count("output") or options.count("cert") or options.count("p"))
         pg.permute(mapping);
 
     if (options.count("output"))
@@ -458,6 +519,24 @@ int main(int argc, char **argv)
         }
     }
 
+    if (options.count("cert"))
+    {
+        // write certificate to file
+        try
+        {
+            std::ofstream file(options["cert"].as<std::string>());
+            original->copy_solution(pg);
+            Verifier v(original, out);
+            v.certify(file);
+            delete original;
+        }
+        catch (const char *err)
+        {
+            out << "certification error: " << err << std::endl;
+            return -1;
+        }
+    }
+
     if (options.count("p"))
     {
         // print winning nodes
@@ -561,7 +561,7 @@ namespace utree
     int step_down(const int pl) ;
     int step_right(const int pl);
 
-    void map(const int pl, const short sign, pg::bitset nodes);
+    void map(const int pl, const short sign, const pg::bitset &nodes);
     void map(const int pl, const short sign, std::vector<int> nodes);
 
     /**
@@ -652,17 +652,15 @@ int agent<B>::step_right(const int pl)
   return _trees[pl];
 }
 template< class B >
-void agent<B>::map(const int pl, const short sign, pg::bitset nodes)
+void agent<B>::map(const int pl, const short sign, const pg::bitset &nodes)
 {
-  for (int i = 0; i < _size; i++){
-    if (nodes[i]){
-      // remove from previous mapping
-      _buffer[_map[2 * i + pl].node][i] = false;
-      // map
-      _map[2*i+pl].node = _trees[pl];
-      _map[2*i+pl].sign = sign;
-    }
-  }
+  nodes.for_each([&](size_t i){
+    // remove from previous mapping
+    _buffer[_map[2 * i + pl].node][i] = false;
+    // map
+    _map[2*i+pl].node = _trees[pl];
+    _map[2*i+pl].sign = sign;
+  });
   // map all positions to this node
   _buffer[_trees[pl]] |= nodes;
 }
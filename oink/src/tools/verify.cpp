@@ -35,8 +35,8 @@ wctime()
 int
 main(int argc, const char **argv)
 {
-    if (argc != 3) {
-        std::cout << "Syntax: " << argv[0] << " pg_file sol_file" << std::endl;
+    if (argc != 3 and argc != 4) {
+        std::cout << "Syntax: " << argv[0] << " pg_file sol_file [cert_file]" << std::endl;
         return -1;
     }
 
@@ -52,11 +52,16 @@ main(int argc, const char **argv)
         inpsol.close();
         std::cout << "solution loaded." << std::endl;
 
-        pg.sort();
-
         Verifier v(&pg, std::cout);
         auto begin = wctime();
-        v.verify(true);
+        if (argc == 4) {
+            // the certificate is for the vertices of the file, so do not sort
+            std::ifstream inpcert(argv[3]);
+            v.verifyCertificate(inpcert);
+        } else {
+            pg.sort();
+            v.verify(true);
+        }
         auto end = wctime();
         std::cout << "verified in " << (end - begin) << " sec." << std::endl;
         
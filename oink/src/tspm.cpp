@@ -17,6 +17,8 @@
 #include <algorithm>
 #include <iomanip>
 #include "tspm.hpp"
+#include "lace.h"
+#include "phases.hpp"
 
 namespace pg {
 
@@ -291,6 +293,7 @@ TSPMSolver::lift(int node, int target)
         if (ch1 and pm[1] == -1 and (d&1) == 1) counts[d]--;
         // increase count and return true
         lift_count++;
+        OINK_COUNT("lifts", 1);
         return true;
     } else {
         // no lift was performed, return false. 
@@ -298,6 +301,103 @@ TSPMSolver::lift(int node, int target)
     }
 }
 
+/**
+ * Thread-safe variant of lift() for the parallel engine.
+ * Computes the new measure on snapshots, then writes it with a max-update.
+ */
+bool
+TSPMSolver::parlift(int worker, int node, int target)
+{
+    int *cur = scratch + 4*k*worker;
+    int *ptmp = cur + k, *pbest = cur + 2*k, *succ = cur + 3*k;
+
+    const int pl_max = owner(node);
+    const int pl_min = 1 - pl_max;
+    const int d = priority(node);
+
+retry:
+    engine->read(node, cur, pms + k*node, k);
+
+    // check if already Top for both players
+    if (cur[0] == -1 and cur[1] == -1) return false;
+
+    bool ch_max = false, ch_min = false;
+    int best_to = -1;
+    unsigned best_version = 0;
+
+    // do max for player <pl_max>
+    if (cur[pl_max] != -1) {
+        if (target != -1) {
+            engine->read(target, succ, pms + k*target, k);
+            Prog(ptmp, succ, d, pl_max);
+            if (pm_less(cur, ptmp, d, pl_max)) {
+                pm_copy(cur, ptmp, pl_max);
+                ch_max = true;
+            }
+        } else {
+            for (auto curedge = outs(node); *curedge != -1; curedge++) {
+                int to = *curedge;
+                if (disabled[to]) continue;
+                engine->read(to, succ, pms + k*to, k);
+                Prog(ptmp, succ, d, pl_max);
+                if (pm_less(cur, ptmp, d, pl_max)) {
+                    pm_copy(cur, ptmp, pl_max);
+                    ch_max = true;
+                }
+            }
+        }
+    }
+
+    // do min for player <pl_min>
+    if (cur[pl_min] != -1 and (target == -1 or target == __atomic_load_n(strategy + node, __ATOMIC_ACQUIRE))) {
+        for (auto curedge = outs(node); *curedge != -1; curedge++) {
+            int to = *curedge;
+            if (disabled[to]) continue;
+            unsigned version = engine->read(to, succ, pms + k*to, k);
+            Prog(ptmp, succ, d, pl_min);
+            if (best_to == -1 or pm_less(ptmp, pbest, d, pl_min)) {
+                for (int i=0; i<k; i++) pbest[i] = ptmp[i];
+                best_to = to;
+                best_version = version;
+            }
+        }
+        if (best_to != -1 and pm_less(cur, pbest, d, pl_min)) {
+            pm_copy(cur, pbest, pl_min);
+            ch_min = true;
+        }
+    }
+
+    if (!ch_max and !ch_min and best_to == -1) return false;
+
+    // another worker may have lifted <node> in the meantime, so only write increases
+    int *pm = pms + k*node;
+    bool ch0 = false, ch1 = false;
+    engine->lock(node);
+    if (best_to != -1 and !engine->unchanged(best_to, best_version, node)) {
+        // the best successor increased meanwhile, so the strategy may be stale
+        engine->unlock(node);
+        goto retry;
+    }
+    if (ch_max and pm_less(pm, cur, d, pl_max)) {
+        pm_copy(pm, cur, pl_max);
+        if (pl_max) ch1 = true;
+        else ch0 = true;
+    }
+    if (ch_min and pm_less(pm, cur, d, pl_min)) {
+        pm_copy(pm, cur, pl_min);
+        if (pl_min) ch1 = true;
+        else ch0 = true;
+    }
+    if (best_to != -1) strategy[node] = best_to;
+    engine->unlock(node);
+
+    // lower the bound like lift() does; other workers read counts concurrently, which is
+    // sound because a smaller bound only makes Prog reach Top sooner
+    if (ch0 and cur[0] == -1 and (d&1) == 0) __atomic_sub_fetch(counts + d, 1, __ATOMIC_RELAXED);
+    if (ch1 and cur[1] == -1 and (d&1) == 1) __atomic_sub_fetch(counts + d, 1, __ATOMIC_RELAXED);
+    return ch0 or ch1;
+}
+
 void
 TSPMSolver::update(int pl)
 {
@@ -355,6 +455,28 @@ TSPMSolver::update(int pl)
     }
 }
 
+/**
+ * Lift until fixed point with the parallel engine, instead of the todo loop in run().
+ */
+void
+TSPMSolver::liftpar(int64_t &last_update)
+{
+    OINK_PHASE("liftpar");
+    while (!todo.empty() or !engine->empty()) {
+        while (!todo.empty()) engine->push(todo_pop());
+        // stop lifting when it is time for the next update, like the todo loop in run()
+        engine->run(std::max<int64_t>(0, last_update + 10*nodecount() - lift_count));
+        lift_count += engine->lift_count;
+        lift_attempt += engine->lift_attempt;
+
+        if (last_update + 10*nodecount() < lift_count) {
+            last_update = lift_count;
+            update(0);
+            update(1);
+        }
+    }
+}
+
 void
 TSPMSolver::run()
 {
@@ -387,6 +509,12 @@ TSPMSolver::run()
     // set number of lifts and lift attempts to 0
     lift_count = lift_attempt = 0;
 
+    // with Lace, lift with all workers
+    if (lace_workers() != 0) {
+        engine = new PMLifter(game, disabled, this);
+        scratch = new int[4*k*engine->workers()];
+    }
+
     /**
      * Strategy that updates predecessors then marks updated predecessors for processing.
      * Uses a queue/stack to store the dirty vertices.
@@ -412,6 +540,9 @@ TSPMSolver::run()
     logger << "main loop now" << std::endl;
     int64_t last_update = 0;
 
+    if (engine != NULL) liftpar(last_update);
+
+    OINK_PHASE("liftloop");
     while (!todo.empty()) {
         // get a node that is not progressive
         int n = todo_pop();
@@ -458,7 +589,16 @@ TSPMSolver::run()
     delete[] dirty;
     delete[] unstable;
 
+    if (engine != NULL) {
+        logger << "parallel lifting with " << engine->workers() << " workers, " << engine->steals << " steals." << std::endl;
+        delete[] scratch;
+        delete engine;
+        engine = NULL;
+    }
+
     logger << "solved with " << lift_count << " lifts, " << lift_attempt << " lift attempts." << std::endl;
+    stats.count("lifts", lift_count);
+    stats.count("lift_attempts", lift_attempt);
 }
 
 }
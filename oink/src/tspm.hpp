@@ -21,10 +21,11 @@
 
 #include "oink.hpp"
 #include "solver.hpp"
+#include "pmlift.hpp"
 
 namespace pg {
 
-class TSPMSolver : public Solver
+class TSPMSolver : public Solver, public PMLifter::Client
 {
 public:
     TSPMSolver(Oink *oink, Game *game);
@@ -46,6 +47,12 @@ protected:
     int *dirty;
     int *unstable;
 
+    PMLifter *engine = NULL; // parallel lifting, only with Lace
+    int *scratch;            // per worker: current, tmp, best, successor
+
+    virtual bool parlift(int worker, int node, int target);
+    void liftpar(int64_t &last_update);
+
     bool canlift(int node, int pl);
     bool lift(int node, int target);
     bool pm_less(int *a, int *b, int d, int pl);
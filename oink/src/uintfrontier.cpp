@@ -0,0 +1,362 @@
+/*
+ * Copyright 2017-2018 Tom van Dijk, Johannes Kepler University Linz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#include "uintfrontier.hpp"
+#include "error.hpp"
+
+namespace pg {
+
+static const int RINGSIZE = 64; // initial number of slots in a ring
+
+uintfrontier::uintfrontier() : nworkers(0), segs(NULL), slabs(NULL)
+{
+}
+
+uintfrontier::uintfrontier(int workers) : nworkers(0), segs(NULL), slabs(NULL)
+{
+    resize(workers);
+}
+
+uintfrontier::~uintfrontier()
+{
+    resize(0);
+}
+
+void
+uintfrontier::resize(int workers)
+{
+    if (segs != NULL) {
+        for (int w=0; w<nworkers; w++) {
+            ring *r = segs[w].pub;
+            while (r != NULL) {
+                ring *prev = r->prev;
+                free(r);
+                r = prev;
+            }
+        }
+        delete[] segs;
+        segs = NULL;
+    }
+    if (slabs != NULL) {
+        for (int i=0; i<MAXSLABS; i++) delete[] slabs[i];
+        free(slabs);
+        slabs = NULL;
+    }
+
+    nworkers = workers;
+    if (workers == 0) return;
+
+    segs = new segment[workers];
+    for (int w=0; w<workers; w++) {
+        segs[w].pub = (ring*)malloc(sizeof(ring) + sizeof(int[RINGSIZE]));
+        segs[w].pub->size = RINGSIZE;
+        segs[w].pub->prev = NULL;
+        segs[w].steals = 0;
+    }
+    // calloc, so the table of slabs only costs memory when it is used
+    slabs = (chunk**)calloc(MAXSLABS, sizeof(chunk*));
+    clear();
+}
+
+void
+uintfrontier::clear()
+{
+    for (int w=0; w<nworkers; w++) {
+        segment &s = segs[w];
+        // keep only the newest ring
+        ring *r = s.pub->prev;
+        while (r != NULL) {
+            ring *prev = r->prev;
+            free(r);
+            r = prev;
+        }
+        s.pub->prev = NULL;
+        s.head = -1;
+        s.tail = -1;
+        s.freelist = -1;
+        s.freecount = 0;
+        s.starving = false;
+        s.top = 0;
+        s.bottom = 0;
+    }
+    // every chunk is free again, hand out the ids from 0
+    allocated = 0;
+    freestack = 0;
+    hungry = 0;
+}
+
+void
+uintfrontier::flush()
+{
+    for (int w=0; w<nworkers; w++) {
+        segment &s = segs[w];
+        if (s.tail != -1 and at(s.tail)->begin != at(s.tail)->end) {
+            publish(w, s.tail);
+            s.tail = -1;
+        }
+    }
+}
+
+size_t
+uintfrontier::size() const
+{
+    size_t count = 0;
+    for (int w=0; w<nworkers; w++) collect(w, [&](uint) { count++; });
+    return count;
+}
+
+uint64_t
+uintfrontier::steals() const
+{
+    uint64_t count = 0;
+    for (int w=0; w<nworkers; w++) count += segs[w].steals;
+    return count;
+}
+
+/**
+ * Get a free chunk: from the private free list, the global free stack, or a new one.
+ */
+int
+uintfrontier::alloc(int worker)
+{
+    segment &s = segs[worker];
+    int id = s.freelist;
+    if (id != -1) {
+        s.freelist = at(id)->next;
+        s.freecount--;
+    } else {
+        // pop the global free stack; the tag prevents ABA when a chunk is pushed back meanwhile
+        uint64_t old = __atomic_load_n(&freestack, __ATOMIC_ACQUIRE);
+        while ((old & 0xffffffff) != 0) {
+            const int top = (int)(old & 0xffffffff) - 1;
+            const int next = __atomic_load_n(&at(top)->next, __ATOMIC_RELAXED);
+            const uint64_t upd = ((old >> 32) + 1) << 32 | (uint64_t)(next + 1);
+            if (__atomic_compare_exchange_n(&freestack, &old, upd, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                id = top;
+                break;
+            }
+        }
+    }
+    if (id == -1) {
+        id = __atomic_fetch_add(&allocated, 1, __ATOMIC_RELAXED);
+        if (id >= (MAXSLABS << SLABBITS)) THROW_ERROR("uintfrontier: out of chunks");
+        chunk **slab = slabs + (id >> SLABBITS);
+        if (__atomic_load_n(slab, __ATOMIC_ACQUIRE) == NULL) {
+            // several workers may race to allocate the slab, only one wins
+            chunk *mem = new chunk[1 << SLABBITS];
+            chunk *expected = NULL;
+            if (!__atomic_compare_exchange_n(slab, &expected, mem, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) delete[] mem;
+        }
+    }
+    chunk *c = at(id);
+    c->begin = 0;
+    c->end = 0;
+    return id;
+}
+
+/**
+ * Return the consumed chunk <id> to the private free list, or else to the global free stack.
+ */
+void
+uintfrontier::recycle(int worker, int id)
+{
+    segment &s = segs[worker];
+    if (s.freecount < FREEMAX) {
+        at(id)->next = s.freelist;
+        s.freelist = id;
+        s.freecount++;
+        return;
+    }
+    uint64_t old = __atomic_load_n(&freestack, __ATOMIC_RELAXED);
+    while (true) {
+        __atomic_store_n(&at(id)->next, (int)(old & 0xffffffff) - 1, __ATOMIC_RELAXED);
+        const uint64_t upd = ((old >> 32) + 1) << 32 | (uint64_t)(id + 1);
+        if (__atomic_compare_exchange_n(&freestack, &old, upd, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) return;
+    }
+}
+
+/**
+ * Publish chunk <id> of <worker> at the bottom of its ring; only called by the owner.
+ */
+void
+uintfrontier::publish(int worker, int id)
+{
+    segment &s = segs[worker];
+    const int64_t b = s.bottom;
+    const int64_t t = __atomic_load_n(&s.top, __ATOMIC_ACQUIRE);
+    ring *r = s.pub;
+    if (b - t >= r->size) {
+        // full, copy to a ring twice the size; a thief may still read the old ring
+        ring *bigger = (ring*)malloc(sizeof(ring) + sizeof(int[2*r->size]));
+        bigger->size = 2*r->size;
+        bigger->prev = r;
+        for (int64_t i=t; i<b; i++) bigger->items[i & (bigger->size-1)] = r->items[i & (r->size-1)];
+        __atomic_store_n(&s.pub, bigger, __ATOMIC_RELEASE);
+        r = bigger;
+    }
+    __atomic_store_n(&r->items[b & (r->size-1)], id, __ATOMIC_RELAXED);
+    __atomic_store_n(&s.bottom, b+1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Take the oldest published chunk of segment <s>, or -1 if there is none.
+ */
+int
+uintfrontier::take(segment &s)
+{
+    int64_t t = __atomic_load_n(&s.top, __ATOMIC_ACQUIRE);
+    while (true) {
+        const int64_t b = __atomic_load_n(&s.bottom, __ATOMIC_ACQUIRE);
+        if (t >= b) return -1;
+        const ring *r = __atomic_load_n(&s.pub, __ATOMIC_ACQUIRE);
+        const int id = __atomic_load_n(&r->items[t & (r->size-1)], __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&s.top, &t, t+1, false, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE)) return id;
+    }
+}
+
+/**
+ * Some worker is starving: publish the partial tail chunk of <worker>,
+ * unless it still has published chunks that can be stolen.
+ */
+void
+uintfrontier::share(int worker)
+{
+    segment &s = segs[worker];
+    if (__atomic_load_n(&s.top, __ATOMIC_RELAXED) != s.bottom) return;
+    const chunk *c = at(s.tail);
+    if (c->end - c->begin < 2) return;
+    publish(worker, s.tail);
+    s.tail = -1;
+}
+
+/**
+ * The owner of segment <s> found an element, so it no longer starves.
+ */
+void
+uintfrontier::fed(segment &s)
+{
+    if (s.starving) {
+        s.starving = false;
+        __atomic_sub_fetch(&hungry, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * Make room in the tail chunk of <worker>, publishing it if it is full.
+ */
+uintfrontier::chunk *
+uintfrontier::room(int worker)
+{
+    segment &s = segs[worker];
+    if (s.tail != -1) {
+        chunk *c = at(s.tail);
+        if (c->end != CHUNK) return c;
+        publish(worker, s.tail);
+    }
+    s.tail = alloc(worker);
+    return at(s.tail);
+}
+
+void
+uintfrontier::push_slow(int worker, uint element)
+{
+    chunk *c = room(worker);
+    c->items[c->end++] = element;
+    if (__atomic_load_n(&hungry, __ATOMIC_RELAXED)) share(worker);
+}
+
+void
+uintfrontier::push(int worker, const uint *elements, uint count)
+{
+    while (count != 0) {
+        chunk *c = room(worker);
+        const uint n = std::min(count, CHUNK - c->end);
+        memcpy(c->items + c->end, elements, sizeof(uint[n]));
+        c->end += n;
+        elements += n;
+        count -= n;
+    }
+    if (segs[worker].tail != -1 and __atomic_load_n(&hungry, __ATOMIC_RELAXED)) share(worker);
+}
+
+/**
+ * The head chunk of <worker> is consumed. Continue with the oldest published chunk of
+ * <worker>, then with its tail chunk, then with a chunk stolen from another worker.
+ */
+bool
+uintfrontier::pop_slow(int worker, uint &element)
+{
+    segment &s = segs[worker];
+    if (s.head != -1) {
+        recycle(worker, s.head);
+        s.head = -1;
+    }
+
+    int id = take(s);
+    if (id == -1 and s.tail != -1) {
+        chunk *c = at(s.tail);
+        if (c->begin != c->end) {
+            element = c->items[c->begin++];
+            if (c->begin == c->end) c->begin = c->end = 0;
+            fed(s);
+            return true;
+        }
+    }
+    for (int i=1; id == -1 and i<nworkers; i++) {
+        id = take(segs[(worker+i) % nworkers]);
+        if (id != -1) s.steals++;
+    }
+
+    if (id == -1) {
+        // with a single worker, nobody else can share
+        if (!s.starving and nworkers > 1) {
+            s.starving = true;
+            __atomic_add_fetch(&hungry, 1, __ATOMIC_RELAXED);
+        }
+        return false;
+    }
+
+    fed(s);
+    s.head = id;
+    chunk *c = at(id);
+    element = c->items[c->begin++];
+    return true;
+}
+
+uintfrontier::uint
+uintfrontier::pop(int worker, uint *dst, uint max)
+{
+    uint count = 0;
+    while (count < max) {
+        segment &s = segs[worker];
+        if (s.head != -1) {
+            chunk *c = at(s.head);
+            const uint n = std::min(max - count, c->end - c->begin);
+            memcpy(dst + count, c->items + c->begin, sizeof(uint[n]));
+            c->begin += n;
+            count += n;
+            if (count == max) break;
+        }
+        if (!pop_slow(worker, dst[count])) break;
+        count++;
+    }
+    return count;
+}
+
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2017-2018 Tom van Dijk, Johannes Kepler University Linz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UINTFRONTIER_HPP
+#define UINTFRONTIER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#include "uintqueue.hpp"
+
+namespace pg
+{
+
+/**
+ * Concurrent companion of uintqueue: a frontier of unsigned integers shared by all workers.
+ *
+ * Every worker owns a segment, a chain of chunks of CHUNK elements. A worker pushes to the
+ * chunk at its tail and pops from the chunk at its head, without synchronization. Full chunks
+ * are published in a single-producer multi-consumer ring, from which the owner takes its
+ * oldest chunk and idle workers steal whole chunks, using one compare-and-swap per chunk.
+ * While some worker is starving, a worker also publishes its partial tail chunk.
+ * Chunks are recycled via a per-worker free list and a lock-free global free stack.
+ *
+ * Each worker sees its own elements in FIFO order, so a single worker behaves like the
+ * sequential worklists. The order over several workers depends on the schedule;
+ * drain(..., true) sorts the result, for reproducible traces.
+ *
+ * push() and pop() are only called by the owner <worker>, but concurrently with the other
+ * workers. The other methods are not thread safe.
+ */
+class uintfrontier
+{
+public:
+
+    /******************************************************************************/
+    /* Typedef and constants                                                      */
+    /******************************************************************************/
+
+    typedef unsigned int uint;
+
+    static const uint CHUNK = 64; // elements per chunk, the unit of stealing
+
+    /******************************************************************************/
+
+    /******************************************************************************/
+    /* Constructors and destructor                                                */
+    /******************************************************************************/
+
+    uintfrontier();
+    uintfrontier(int workers);
+    ~uintfrontier();
+
+    /**
+     * Discard the contents and prepare for <workers> workers; 0 releases all memory.
+     */
+    void resize(int workers);
+
+    /******************************************************************************/
+
+    /******************************************************************************/
+    /* Concurrent methods                                                         */
+    /******************************************************************************/
+
+    __attribute__((always_inline)) void push(int worker, uint element)
+    {
+        segment &s = segs[worker];
+        if (s.tail != -1) {
+            chunk *c = at(s.tail);
+            if (c->end != CHUNK) {
+                c->items[c->end++] = element;
+                if (__atomic_load_n(&hungry, __ATOMIC_RELAXED)) share(worker);
+                return;
+            }
+        }
+        push_slow(worker, element);
+    }
+
+    /**
+     * Push the <count> elements at <elements>.
+     */
+    void push(int worker, const uint *elements, uint count);
+
+    /**
+     * Pop an element of <worker>, or steal one, into <element>.
+     * Returns false if no elements were found; other workers may still push more.
+     */
+    __attribute__((always_inline)) bool pop(int worker, uint &element)
+    {
+        segment &s = segs[worker];
+        if (s.head != -1) {
+            chunk *c = at(s.head);
+            if (c->begin != c->end) {
+                element = c->items[c->begin++];
+                return true;
+            }
+        }
+        return pop_slow(worker, element);
+    }
+
+    /**
+     * Pop up to <max> elements into <dst>, returns the number of elements popped.
+     */
+    uint pop(int worker, uint *dst, uint max);
+
+    /******************************************************************************/
+
+    /******************************************************************************/
+    /* Sequential methods                                                         */
+    /******************************************************************************/
+
+    size_t size() const;
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * Publish the partial tail chunks, so any worker can pop every element.
+     * Call this after pushing from outside the workers, e.g., before starting them.
+     */
+    void flush();
+
+    /**
+     * Remove all elements, keeping the allocated chunks.
+     */
+    void clear();
+
+    /**
+     * Append all elements to <dst> and clear. The order is per worker, each in FIFO order,
+     * unless <sorted> is set; then the appended elements are sorted.
+     */
+    template <typename C>
+    void drain(C &dst, bool sorted = false)
+    {
+        const size_t start = dst.size();
+        for (int w=0; w<nworkers; w++) {
+            collect(w, [&](uint e) { dst.push_back(e); });
+        }
+        if (sorted) std::sort(dst.begin() + start, dst.end());
+        clear();
+    }
+
+    /**
+     * As drain, for a uintqueue with sufficient capacity.
+     */
+    void drain(uintqueue &dst, bool sorted = false)
+    {
+        const uint start = dst.size();
+        for (int w=0; w<nworkers; w++) {
+            collect(w, [&](uint e) { dst.push(e); });
+        }
+        if (sorted and dst.size() != start) std::sort(&dst[start], &dst[0] + dst.size());
+        clear();
+    }
+
+    /**
+     * Number of chunks stolen from other workers, since the last resize.
+     */
+    uint64_t steals() const;
+
+    /******************************************************************************/
+
+protected:
+
+    /******************************************************************************/
+    /* Chunks, rings and segments                                                 */
+    /******************************************************************************/
+
+    struct chunk {
+        uint begin;           // index of the oldest element
+        uint end;             // index after the newest element
+        int next;             // next chunk in a free list
+        uint items[CHUNK];
+    };
+
+    /**
+     * Ring of published chunk ids, grown by the owner; old rings stay valid until clear().
+     */
+    struct ring {
+        int64_t size;         // a power of 2
+        ring *prev;
+        int items[];
+    };
+
+    struct alignas(64) segment {
+        int head;             // chunk being consumed, or -1
+        int tail;             // chunk being filled, or -1
+        int freelist;         // private free chunks
+        int freecount;
+        bool starving;        // counted in <hungry>
+        uint64_t steals;
+        ring *pub;
+        int64_t bottom;       // written by the owner only
+        alignas(64) int64_t top; // advanced by any worker
+    };
+
+    static const int SLABBITS = 8;          // 256 chunks per slab
+    static const int MAXSLABS = 1 << 16;
+    static const int FREEMAX = 16;          // chunks in a private free list
+
+    int nworkers;
+    segment *segs;
+    chunk **slabs;            // chunk <id> is slabs[id >> SLABBITS][id & 255]
+    int allocated;            // number of chunk ids handed out
+    uint64_t freestack;       // global free stack: tag << 32 | (top id + 1)
+    int hungry;               // number of starving workers
+
+    __attribute__((always_inline)) chunk *at(int id) const
+    {
+        return slabs[id >> SLABBITS] + (id & ((1 << SLABBITS) - 1));
+    }
+
+    int alloc(int worker);
+    void recycle(int worker, int id);
+    void publish(int worker, int id);
+    int take(segment &s);
+    void share(int worker);
+    void fed(segment &s);
+    chunk *room(int worker);
+    void push_slow(int worker, uint element);
+    bool pop_slow(int worker, uint &element);
+
+    /**
+     * Call <f> on the elements of <worker>, oldest first.
+     */
+    template <typename F>
+    void collect(int worker, F f) const
+    {
+        const segment &s = segs[worker];
+        if (s.head != -1) {
+            const chunk *c = at(s.head);
+            for (uint i=c->begin; i<c->end; i++) f(c->items[i]);
+        }
+        for (int64_t t=s.top; t<s.bottom; t++) {
+            const chunk *c = at(s.pub->items[t & (s.pub->size-1)]);
+            for (uint i=c->begin; i<c->end; i++) f(c->items[i]);
+        }
+        if (s.tail != -1) {
+            const chunk *c = at(s.tail);
+            for (uint i=c->begin; i<c->end; i++) f(c->items[i]);
+        }
+    }
+
+    /******************************************************************************/
+
+};
+
+}
+
+#endif
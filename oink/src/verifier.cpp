@@ -26,11 +26,61 @@
 
 #include "game.hpp"
 #include "verifier.hpp"
+#include "lace.h"
 
 using namespace std;
 
 namespace pg {
 
+/**
+ * The state of a Tarjan search; the searches at different priorities share nothing,
+ * so each worker of the parallel verifier has its own.
+ */
+struct Verifier::tarjan_state
+{
+    tarjan_state(int n_vertices) : pre(0)
+    {
+        done = new int[n_vertices];
+        low = new int64_t[n_vertices];
+        for (int i=0; i<n_vertices; i++) done[i] = -1;
+        for (int i=0; i<n_vertices; i++) low[i] = 0;
+    }
+
+    ~tarjan_state()
+    {
+        delete[] done;
+        delete[] low;
+    }
+
+    int *done;
+    int64_t *low;
+    int64_t pre;
+    std::vector<int> res;
+    std::stack<int> st;
+};
+
+/**
+ * The state of the searches of certify, shared by the priorities: the marks are the priority
+ * of the last search that visited the vertex, so they need no reset.
+ */
+struct Verifier::certify_state
+{
+    certify_state(int n_vertices) :
+        found(n_vertices, -1), finished(n_vertices, -1), pre(0), index(n_vertices, 0), low(n_vertices, 0), measure(n_vertices, 0)
+    {
+    }
+
+    std::vector<int> found;         // reaches a vertex of priority found[v]
+    std::vector<int> finished;      // the SCC was finished at priority finished[v]
+    int64_t pre;
+    std::vector<int64_t> index;
+    std::vector<int64_t> low;
+    std::vector<int64_t> measure;   // the measure at priority finished[v]
+    std::vector<int> vertices;      // the vertices found by the backward search
+    std::vector<int> res;
+    std::vector<std::pair<int, const int*>> st; // vertex and next edge
+};
+
 void
 Verifier::verify(bool fullgame, bool even, bool odd)
 {
@@ -39,62 +89,76 @@ Verifier::verify(bool fullgame, bool even, bool odd)
     // ensure that the arrays are built
     game->build_in_array(false);
 
-    const int n_vertices = game->vertexcount();
+    this->fullgame = fullgame;
+    this->even = even;
+    this->odd = odd;
 
-    /**
-     * The first loop removes all edges from "won" vertices that are not the strategy.
-     * This turns each dominion into a single player game.
-     * Also some trivial checks are performed.
-     */
-    for (int i=0; i<n_vertices; i++) {
-        // (for full solutions) check whether every vertex is won
-        if (!game->solved[i]) {
-            if (fullgame) throw "not every vertex is won";
-            else continue;
+    if (workers < 0) {
+        verifySeq();
+    } else if (lace_workers() == 0) {
+        lace_start(workers, 0);
+        try {
+            verifyPar();
+        } catch (const char *) {
+            lace_stop();
+            throw;
         }
+        lace_stop();
+    } else {
+        verifyPar();
+    }
+}
 
-        const bool winner = game->winner[i];
+const char *
+Verifier::checkVertex(int i, int &escape, int &strategies)
+{
+    // (for full solutions) check whether every vertex is won
+    if (!game->solved[i]) {
+        if (fullgame) return "not every vertex is won";
+        else return NULL;
+    }
 
-        if (winner == 0 and !even) continue; // whatever
-        if (winner == 1 and !odd) continue; // whatever
+    const bool winner = game->winner[i];
 
-        if (winner == game->owner(i)) {
-            // if winner, check whether the strategy stays in the dominion
-            int str = game->strategy[i];
-            if (str == -1) {
-                throw "winning vertex has no strategy";
-            } else if (!game->has_edge(i, str)) {
-                throw "strategy is not a valid move";
-            } else if (!game->solved[str] or game->winner[str] != winner) {
-                throw "strategy leaves dominion";
-            }
-            n_strategies++; // number of checked strategies
-        } else {
-            // if loser, check whether the loser can escape
-            for (auto curedge = game->outs(i); *curedge != -1; curedge++) {
-                int to = *curedge;
-                if (!game->solved[to] or game->winner[to] != winner) {
-                    logger << "escape edge from " << game->label_vertex(i) << " to " << game->label_vertex(to) << std::endl;
-                    throw "loser can escape";
-                }
+    if (winner == 0 and !even) return NULL; // whatever
+    if (winner == 1 and !odd) return NULL; // whatever
+
+    if (winner == game->owner(i)) {
+        // if winner, check whether the strategy stays in the dominion
+        int str = game->strategy[i];
+        if (str == -1) {
+            return "winning vertex has no strategy";
+        } else if (!game->has_edge(i, str)) {
+            return "strategy is not a valid move";
+        } else if (!game->solved[str] or game->winner[str] != winner) {
+            return "strategy leaves dominion";
+        }
+        strategies++; // number of checked strategies
+    } else {
+        // if loser, check whether the loser can escape
+        for (auto curedge = game->outs(i); *curedge != -1; curedge++) {
+            int to = *curedge;
+            if (!game->solved[to] or game->winner[to] != winner) {
+                escape = to;
+                return "loser can escape";
             }
-            // and of course check that no strategy is set
-            if (game->strategy[i] != -1) throw "losing vertex has strategy";
         }
+        // and of course check that no strategy is set
+        if (game->strategy[i] != -1) return "losing vertex has strategy";
     }
 
-    // Allocate datastructures for Tarjan search
-    int *done = new int[n_vertices];
-    int64_t *low = new int64_t[n_vertices];
-    for (int i=0; i<n_vertices; i++) done[i] = -1;
-    for (int i=0; i<n_vertices; i++) low[i] = 0;
-
-    std::vector<int> res;
-    std::stack<int> st;
+    return NULL;
+}
 
-    int64_t pre = 0;
+bool
+Verifier::findLoserSCC(int top, int bottom, tarjan_state &ts, std::vector<int> &scc, int &scc_prio)
+{
+    int *done = ts.done;
+    int64_t *low = ts.low;
+    std::vector<int> &res = ts.res;
+    std::stack<int> &st = ts.st;
 
-    for (int i=n_vertices-1; i>=0; i--) {
+    for (int i=top; i>=bottom; i--) {
         // only if a dominion
         if (!game->solved[i]) continue;
 
@@ -112,7 +176,7 @@ Verifier::verify(bool fullgame, bool even, bool odd)
         if (done[i] == prio) continue;
 
         // set <bot> (in tarjan search) to current pre
-        int64_t bot = pre;
+        int64_t bot = ts.pre;
 
         // start the tarjan search at vertex <i>
         st.push(i);
@@ -124,7 +188,7 @@ Verifier::verify(bool fullgame, bool even, bool odd)
              * When we see it for the first item, we assign the next number to it and add it to <res>.
              */
             if (low[v] <= bot) {
-                low[v] = ++pre;
+                low[v] = ++ts.pre;
                 res.push_back(v);
             }
 
@@ -199,19 +263,16 @@ Verifier::verify(bool fullgame, bool even, bool odd)
 
             if (cycles && (max_prio&1) == (prio&1)) {
                 /**
-                 * Found! Report.
+                 * Found!
                  */
-                logger << "\033[1;31mscc where loser wins\033[m with priority \033[1;34m" << max_prio << "\033[m";
+                scc.clear();
                 for (auto it=res.rbegin(); it!=res.rend(); it++) {
                     int n = *it;
-                    logger << " " << n;
+                    scc.push_back(n);
                     if (n == v) break;
                 }
-                logger << std::endl;
-                delete[] done;
-                delete[] low;
-
-                throw "loser can win";
+                scc_prio = max_prio;
+                return true;
             }
 
             /**
@@ -226,8 +287,443 @@ Verifier::verify(bool fullgame, bool even, bool odd)
         }
     }
 
-    delete[] done;
-    delete[] low;
+    return false;
+}
+
+void
+Verifier::reportEscape(int v, int escape)
+{
+    if (escape == -1) return;
+    logger << "escape edge from " << game->label_vertex(v) << " to " << game->label_vertex(escape) << std::endl;
+}
+
+void
+Verifier::reportSCC(const std::vector<int> &scc, int scc_prio)
+{
+    logger << "\033[1;31mscc where loser wins\033[m with priority \033[1;34m" << scc_prio << "\033[m";
+    for (int n : scc) logger << " " << n;
+    logger << std::endl;
+}
+
+void
+Verifier::verifySeq()
+{
+    const int n_vertices = game->vertexcount();
+
+    /**
+     * The first loop removes all edges from "won" vertices that are not the strategy.
+     * This turns each dominion into a single player game.
+     * Also some trivial checks are performed.
+     */
+    for (int i=0; i<n_vertices; i++) {
+        int escape = -1;
+        const char *err = checkVertex(i, escape, n_strategies);
+        if (err != NULL) {
+            reportEscape(i, escape);
+            throw err;
+        }
+    }
+
+    // Tarjan search for an SCC where the loser wins, over all vertices
+    tarjan_state ts(n_vertices);
+    std::vector<int> scc;
+    int scc_prio;
+    if (findLoserSCC(n_vertices-1, 0, ts, scc, scc_prio)) {
+        reportSCC(scc, scc_prio);
+        throw "loser can win";
+    }
+}
+
+/**
+ * Check the vertices <first> to <first+count-1>, recording the lowest vertex that fails.
+ */
+void
+_verify_vertices(Verifier *v, int first, int count)
+{
+    int strategies = 0;
+    for (int i=first; i<first+count; i++) {
+        // stop if a lower vertex already failed
+        int fail = __atomic_load_n(&v->fail_vertex, __ATOMIC_RELAXED);
+        if (i >= fail) break;
+        int escape = -1;
+        if (v->checkVertex(i, escape, strategies) != NULL) {
+            while (i < fail and !__atomic_compare_exchange_n(&v->fail_vertex, &fail, i, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+            break;
+        }
+    }
+    __atomic_fetch_add(&v->n_strategies, strategies, __ATOMIC_RELAXED);
+}
+
+VOID_TASK_3(verify_vertices, Verifier *, v, int, first, int, count)
+{
+    if (count > 4096) {
+        SPAWN(verify_vertices, v, first+count/2, count-count/2);
+        CALL(verify_vertices, v, first, count/2);
+        SYNC(verify_vertices);
+    } else {
+        _verify_vertices(v, first, count);
+    }
+}
+
+/**
+ * Search the vertices of band <b> for an SCC where the loser wins, with the Tarjan state of <worker>.
+ * The searches at different priorities are independent, as the Tarjan search only skips
+ * vertices marked at the same priority.
+ */
+void
+_verify_band(Verifier *v, int b, int worker)
+{
+    // a higher band already failed, which the sequential verifier would report first
+    if (__atomic_load_n(&v->fail_band, __ATOMIC_RELAXED) > b) return;
+
+    if (v->states[worker] == NULL) v->states[worker] = new Verifier::tarjan_state(v->game->vertexcount());
+    std::vector<int> scc;
+    int scc_prio;
+    if (v->findLoserSCC(v->bands[b+1]-1, v->bands[b], *v->states[worker], scc, scc_prio)) {
+        int fail = __atomic_load_n(&v->fail_band, __ATOMIC_RELAXED);
+        while (b > fail and !__atomic_compare_exchange_n(&v->fail_band, &fail, b, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+    }
+}
+
+VOID_TASK_3(verify_bands, Verifier *, v, int, first, int, count)
+{
+    if (count > 1) {
+        // the higher bands first, so they can cut the lower bands short
+        SPAWN(verify_bands, v, first, count/2);
+        CALL(verify_bands, v, first+count/2, count-count/2);
+        SYNC(verify_bands);
+    } else {
+        _verify_band(v, first, LACE_WORKER_ID);
+    }
+}
+
+/**
+ * As verifySeq, with the per-vertex checks in parallel, and the Tarjan searches
+ * of different priorities in parallel. Reports the same errors as verifySeq.
+ */
+void
+Verifier::verifyPar()
+{
+    const int n_vertices = game->vertexcount();
+
+    fail_vertex = n_vertices;
+    RUN(verify_vertices, this, 0, n_vertices);
+    if (fail_vertex != n_vertices) {
+        // check the failing vertex again, for the error
+        int escape = -1, strategies = 0;
+        const char *err = checkVertex(fail_vertex, escape, strategies);
+        reportEscape(fail_vertex, escape);
+        throw err;
+    }
+
+    // the bands of vertices with the same priority, as the vertices are sorted
+    bands.clear();
+    for (int i=0; i<n_vertices; i++) {
+        if (i == 0 or game->priority(i) != game->priority(i-1)) bands.push_back(i);
+    }
+    bands.push_back(n_vertices);
+    const int n_bands = bands.size()-1;
+
+    const int n_workers = lace_workers();
+    states = new tarjan_state*[n_workers];
+    for (int w=0; w<n_workers; w++) states[w] = NULL;
+
+    fail_band = -1;
+    if (n_bands > 0) RUN(verify_bands, this, 0, n_bands);
+
+    for (int w=0; w<n_workers; w++) delete states[w];
+    delete[] states;
+
+    if (fail_band != -1) {
+        // search the failing band again, for the same SCC as verifySeq
+        tarjan_state ts(n_vertices);
+        std::vector<int> scc;
+        int scc_prio;
+        findLoserSCC(bands[fail_band+1]-1, bands[fail_band], ts, scc, scc_prio);
+        reportSCC(scc, scc_prio);
+        throw "loser can win";
+    }
+}
+
+void
+Verifier::certify(std::ostream &out)
+{
+    // not sorted, so the certificate matches the vertices of the caller
+    game->build_in_array(false);
+
+    this->fullgame = true;
+    this->even = true;
+    this->odd = true;
+
+    const int n_vertices = game->vertexcount();
+
+    for (int i=0; i<n_vertices; i++) {
+        int escape = -1;
+        const char *err = checkVertex(i, escape, n_strategies);
+        if (err != NULL) {
+            reportEscape(i, escape);
+            throw err;
+        }
+    }
+
+    // the vertices by priority, highest first, as the Tarjan search of verifySeq
+    std::vector<int> order(n_vertices);
+    for (int i=0; i<n_vertices; i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return game->priority(a) > game->priority(b); });
+
+    certify_state cs(n_vertices);
+    std::vector<std::array<int64_t, 3>> cert;
+    std::vector<int> start;
+    for (int i=0; i<n_vertices;) {
+        const int prio = game->priority(order[i]);
+        start.clear();
+        for (; i<n_vertices and game->priority(order[i]) == prio; i++) {
+            // the measure is only for the priorities of the loser
+            if (game->winner[order[i]] != (prio&1)) start.push_back(order[i]);
+        }
+        if (!start.empty()) certifyBand(prio, start, cs, cert);
+    }
+
+    // one line per vertex, with increasing priorities
+    std::sort(cert.begin(), cert.end());
+    int lines = 0;
+    for (size_t k=0; k<cert.size(); k++) {
+        if (k == 0 or cert[k][0] != cert[k-1][0]) lines++;
+    }
+    out << "paritycert " << lines << ";" << std::endl;
+    for (size_t k=0; k<cert.size();) {
+        const int64_t v = cert[k][0];
+        out << v;
+        for (; k<cert.size() and cert[k][0] == v; k++) out << " " << cert[k][1] << " " << cert[k][2];
+        out << ";" << std::endl;
+    }
+}
+
+void
+Verifier::certifyBand(int prio, const std::vector<int> &start, certify_state &cs, std::vector<std::array<int64_t, 3>> &cert)
+{
+    const int winner = 1-(prio&1);
+
+    // restrict the dominion to the strategy of the winner
+    auto allowed = [&](int from, int to) {
+        return game->strategy[from] == -1 or game->strategy[from] == to;
+    };
+
+    /**
+     * The measure is 0 for vertices that do not reach <start> via lower priorities,
+     * so only search the vertices that do.
+     */
+    std::vector<int> &vertices = cs.vertices;
+    vertices.clear();
+    for (int v : start) {
+        cs.found[v] = prio;
+        vertices.push_back(v);
+    }
+    for (size_t k=0; k<vertices.size(); k++) {
+        const int v = vertices[k];
+        for (auto curedge = game->ins(v); *curedge != -1; curedge++) {
+            const int from = *curedge;
+            if (cs.found[from] == prio) continue;
+            if (!game->solved[from] or game->winner[from] != winner) continue;
+            if (game->priority(from) > prio or !allowed(from, v)) continue;
+            cs.found[from] = prio;
+            vertices.push_back(from);
+        }
+    }
+
+    /**
+     * Tarjan search, which finishes the SCCs in reverse topological order; so the measure
+     * of an SCC is the highest measure of its successors, plus 1 for a vertex with <prio>,
+     * which is not on a cycle, or the loser wins.
+     */
+    const int64_t bot = cs.pre;
+    std::vector<int> &res = cs.res;
+    auto &st = cs.st;
+    for (int i : vertices) {
+        if (cs.low[i] > bot) continue; // already visited
+        cs.index[i] = cs.low[i] = ++cs.pre;
+        res.push_back(i);
+        st.push_back(std::make_pair(i, game->outs(i)));
+
+        while (!st.empty()) {
+            const int v = st.back().first;
+            const int *&curedge = st.back().second;
+            bool pushed = false;
+            for (; *curedge != -1; curedge++) {
+                const int to = *curedge;
+                if (cs.found[to] != prio or cs.finished[to] == prio or !allowed(v, to)) continue;
+                if (cs.low[to] <= bot) {
+                    // not visited, 'recurse' and return to this edge
+                    cs.index[to] = cs.low[to] = ++cs.pre;
+                    res.push_back(to);
+                    st.push_back(std::make_pair(to, game->outs(to)));
+                    pushed = true;
+                    break;
+                }
+                if (cs.low[to] < cs.low[v]) cs.low[v] = cs.low[to];
+            }
+            if (pushed) continue;
+
+            st.pop_back();
+            if (cs.low[v] != cs.index[v]) {
+                // not the root, pass <low> to the parent
+                const int parent = st.back().first;
+                if (cs.low[v] < cs.low[parent]) cs.low[parent] = cs.low[v];
+                continue;
+            }
+
+            // the root of an SCC
+            int64_t m = 0;
+            bool cycles = false, has_prio = false;
+            int scc_size = 0;
+            for (auto it=res.rbegin(); it!=res.rend(); it++) {
+                const int n = *it;
+                scc_size++;
+                if (game->priority(n) == prio) has_prio = true;
+                for (auto e = game->outs(n); *e != -1; e++) {
+                    if (!allowed(n, *e)) continue;
+                    if (*e == n) cycles = true;
+                    // only the finished SCCs, which excludes this SCC
+                    if (cs.found[*e] == prio and cs.finished[*e] == prio and cs.measure[*e] > m) m = cs.measure[*e];
+                }
+                if (n == v) break;
+            }
+
+            if (has_prio and (cycles or scc_size > 1)) {
+                std::vector<int> scc;
+                for (auto it=res.rbegin(); it!=res.rend(); it++) {
+                    scc.push_back(*it);
+                    if (*it == v) break;
+                }
+                reportSCC(scc, prio);
+                res.clear();
+                st.clear();
+                throw "loser can win";
+            }
+
+            for (;;) {
+                const int n = res.back();
+                res.pop_back();
+                cs.finished[n] = prio;
+                cs.measure[n] = m + (game->priority(n) == prio ? 1 : 0);
+                cert.push_back({n, prio, cs.measure[n]});
+                if (n == v) break;
+            }
+        }
+    }
+}
+
+void
+Verifier::verifyCertificate(std::istream &in, bool fullgame, bool even, bool odd)
+{
+    this->fullgame = fullgame;
+    this->even = even;
+    this->odd = odd;
+
+    const int n_vertices = game->vertexcount();
+
+    /**
+     * Read the certificate, the (priority, measure) pairs of each line in increasing order.
+     */
+    std::vector<int> line_vertex, line_size;
+    std::vector<int> read_prios;
+    std::vector<int64_t> read_values;
+    std::vector<char> listed(n_vertices, 0);
+
+    string line;
+    while (getline(in, line)) {
+        stringstream ss(line);
+        string token;
+
+        // ignore empty line
+        if (!(ss >> token)) continue;
+
+        // ignore line with "paritycert"
+        if (token == "paritycert") continue;
+
+        int v;
+        if (!(stringstream(token) >> v)) throw "invalid certificate";
+        if (v < 0 or v >= n_vertices) throw "node index out of bounds";
+        if (listed[v]) throw "node listed twice in certificate";
+        listed[v] = 1;
+
+        int count = 0;
+        int64_t p, f;
+        while (ss >> p) {
+            if (!(ss >> f)) throw "missing measure";
+            if (p < 0 or p > INT32_MAX or f < 0 or f > INT64_MAX/2) throw "invalid certificate";
+            if (count != 0 and p <= read_prios.back()) throw "priorities of certificate not increasing";
+            read_prios.push_back((int)p);
+            read_values.push_back(f);
+            count++;
+        }
+        line_vertex.push_back(v);
+        line_size.push_back(count);
+    }
+
+    // place the lines by vertex, the values of vertex v are at first[v] to first[v+1]-1
+    std::vector<int> first(n_vertices+1, 0);
+    for (size_t l=0; l<line_vertex.size(); l++) first[line_vertex[l]+1] = line_size[l];
+    for (int v=0; v<n_vertices; v++) first[v+1] += first[v];
+    std::vector<int> prios(read_prios.size());
+    std::vector<int64_t> values(read_values.size());
+    for (size_t l=0, k=0; l<line_vertex.size(); l++) {
+        for (int j=first[line_vertex[l]]; j<first[line_vertex[l]+1]; j++, k++) {
+            prios[j] = read_prios[k];
+            values[j] = read_values[k];
+        }
+    }
+    std::vector<int>().swap(read_prios);
+    std::vector<int64_t>().swap(read_values);
+
+    /**
+     * One pass over the vertices and their edges, with the checks of verify, and that the measure
+     * of the loser does not increase along the edges of the restricted dominion.
+     */
+    for (int u=0; u<n_vertices; u++) {
+        int escape = -1;
+        const char *err = checkVertex(u, escape, n_strategies);
+        if (err != NULL) {
+            reportEscape(u, escape);
+            throw err;
+        }
+
+        if (!game->solved[u]) continue;
+        const int winner = game->winner[u];
+        if (winner == 0 and !even) continue;
+        if (winner == 1 and !odd) continue;
+
+        const int pu = game->priority(u);
+        const int loser = 1-winner;
+
+        // the measure must decrease from a vertex with a priority of the loser
+        if ((pu&1) == loser) {
+            int k = first[u];
+            while (k < first[u+1] and prios[k] < pu) k++;
+            if (k == first[u+1] or prios[k] != pu or values[k] == 0) {
+                logger << "no measure for " << game->label_vertex(u) << " at priority " << pu << std::endl;
+                throw "certificate does not hold";
+            }
+        }
+
+        for (auto curedge = game->outs(u); *curedge != -1; curedge++) {
+            const int v = *curedge;
+            if (game->strategy[u] != -1 and game->strategy[u] != v) continue;
+
+            // merge the values of <v> at priorities of the loser from <pu> with those of <u>
+            int a = first[u];
+            for (int b=first[v]; b<first[v+1]; b++) {
+                const int p = prios[b];
+                if (p < pu or (p&1) != loser) continue;
+                while (a < first[u+1] and prios[a] < p) a++;
+                const int64_t fu = (a < first[u+1] and prios[a] == p) ? values[a] : 0;
+                if (fu < values[b] + (p == pu ? 1 : 0)) {
+                    logger << "measure increases from " << game->label_vertex(u) << " to " << game->label_vertex(v) << " at priority " << p << std::endl;
+                    throw "certificate does not hold";
+                }
+            }
+        }
+    }
 }
 
 }
@@ -17,7 +17,12 @@
 #ifndef VERIFIER_HPP
 #define VERIFIER_HPP
 
+#include <array>
+#include <cstdint>
 #include <istream>
+#include <ostream>
+#include <vector>
+
 #include "game.hpp"
 
 namespace pg {
@@ -27,13 +32,82 @@ class Verifier
 public:
     Verifier(Game* pg, std::ostream &lgr) : game(pg), logger(lgr) { }
 
+    /**
+     * Set the number of workers for the parallel verifier.
+     * -1 for the sequential verifier (default), 0 for autodetect.
+     */
+    void setWorkers(int count) { workers = count; }
+
     void verify(bool fullgame=true, bool even=true, bool odd=true);
 
+    /**
+     * Verify the (full) solution and write a certificate for it to <out>, in the vertex order
+     * of the game, which is not sorted. Throws the errors of verify if the solution is wrong.
+     *
+     * The certificate is a progress measure: for every vertex v and every priority p of the
+     * loser of v, the maximum number of vertices with priority p on a path from v that only
+     * visits priorities up to p, in the dominion restricted to the strategy of the winner.
+     * The file lists the nonzero values, one line "v p f p f ...;" per vertex.
+     */
+    void certify(std::ostream &out);
+
+    /**
+     * Verify the solution with the certificate in <in>, with the checks of verify, but in a
+     * single pass over the edges instead of Tarjan searches: along every edge of a dominion,
+     * the measure must not increase at any priority of the loser, and decrease at the
+     * priority of the source vertex. So every cycle visits a higher priority of the winner.
+     */
+    void verifyCertificate(std::istream &in, bool fullgame=true, bool even=true, bool odd=true);
+
     int n_strategies = 0;
 
 protected:
+    struct tarjan_state;
+    struct certify_state;
+
+    /**
+     * Check whether the strategy of the winner of vertex <v> stays in the dominion,
+     * or whether the loser can escape from <v>.
+     * Returns the error or NULL; sets <escape> to the successor for "loser can escape".
+     * Increments <strategies> if a strategy is checked.
+     */
+    const char *checkVertex(int v, int &escape, int &strategies);
+
+    /**
+     * Search for an SCC where the loser wins, with a Tarjan search from the vertices <top>
+     * down to <bottom>. Returns true if found; then <scc> and <scc_prio> are its vertices
+     * and its highest priority.
+     */
+    bool findLoserSCC(int top, int bottom, tarjan_state &ts, std::vector<int> &scc, int &scc_prio);
+
+    /**
+     * Compute the measure at priority <prio> for the dominion of the winner <1-(prio&1)>,
+     * with a backward search from the vertices <start> of priority <prio>, then a Tarjan
+     * search over the vertices found. Appends (vertex, prio, measure) to <cert>.
+     * Throws "loser can win" if a cycle visits <prio>.
+     */
+    void certifyBand(int prio, const std::vector<int> &start, certify_state &cs, std::vector<std::array<int64_t, 3>> &cert);
+
+    void reportEscape(int v, int escape);
+    void reportSCC(const std::vector<int> &scc, int scc_prio);
+
+    void verifySeq(void);
+    void verifyPar(void);
+    friend void _verify_vertices(Verifier *, int, int); // access points from a Lace worker
+    friend void _verify_band(Verifier *, int, int);
+
     Game *game;
     std::ostream &logger;
+    int workers = -1;
+
+    bool fullgame = true;     // every vertex must be won
+    bool even = true;         // check dominions of even
+    bool odd = true;          // check dominions of odd
+
+    int fail_vertex;          // parallel: the lowest vertex that fails checkVertex
+    int fail_band;            // parallel: the highest band with an SCC where the loser wins
+    std::vector<int> bands;   // parallel: the first vertex of each priority, and vertexcount
+    tarjan_state **states;    // parallel: the Tarjan search of each worker
 };
 
 }
@@ -0,0 +1,395 @@
+/**
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VERTEXSET_HPP
+#define VERTEXSET_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "bitset.hpp"
+
+namespace pg
+{
+
+/**
+ * A set of vertices 0..size-1 that adapts its representation to its cardinality.
+ *
+ * Small sets are a sorted array of vertices, so their operations cost time and memory
+ * proportional to the number of vertices rather than to size/64. When a set grows beyond
+ * sparse_max() vertices, it switches to a dense bitset; when a dense set shrinks to half
+ * of that by a set operation, it switches back. Sets over fewer than SPARSE_MIN*256
+ * vertices are always dense, as their bitsets are only a few blocks.
+ * Recursive solvers use this for subgames, where deep recursions often work on tiny
+ * subgames of a large game.
+ *
+ * The API follows bitset. The set operations with a bitset operand expect a bitset of the
+ * same size, e.g., the winning regions of a solver.
+ */
+class vertexset
+{
+public:
+    typedef unsigned int uint;
+
+    static const size_t npos = bitset::npos;
+
+    vertexset() : _size(0), _dense(false)
+    {
+    }
+
+    /**
+     * The empty set of vertices 0..size-1.
+     */
+    explicit vertexset(size_t size) : _size(size), _dense(false)
+    {
+        if (sparse_max() == 0) to_dense();
+    }
+
+    /**
+     * The set of vertices in <bits>.
+     */
+    explicit vertexset(const bitset &bits) : _size(bits.size()), _dense(true), _bits(bits)
+    {
+        adapt();
+    }
+
+    inline size_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     * The maximum number of vertices of a sparse set; a quarter of the number of blocks of
+     * the dense set, so a sparse operation never costs more than a dense one.
+     * Returns 0 if the set is always dense.
+     */
+    inline size_t sparse_max() const
+    {
+        return _size / 256 < SPARSE_MIN ? 0 : _size / 256;
+    }
+
+    inline bool is_sparse() const
+    {
+        return !_dense;
+    }
+
+    size_t count() const
+    {
+        return _dense ? _bits.count() : _vertices.size();
+    }
+
+    inline bool any() const
+    {
+        return _dense ? _bits.any() : !_vertices.empty();
+    }
+
+    inline bool none() const
+    {
+        return !any();
+    }
+
+    inline bool test(size_t pos) const
+    {
+        if (_dense) return _bits.test(pos);
+        return std::binary_search(_vertices.begin(), _vertices.end(), (uint)pos);
+    }
+
+    inline bool operator[](size_t pos) const
+    {
+        return test(pos);
+    }
+
+    void set(size_t pos)
+    {
+        if (_dense) {
+            _bits.set(pos);
+            return;
+        }
+        auto it = std::lower_bound(_vertices.begin(), _vertices.end(), (uint)pos);
+        if (it != _vertices.end() and *it == pos) return;
+        _vertices.insert(it, (uint)pos);
+        if (_vertices.size() > sparse_max()) to_dense();
+    }
+
+    void reset(size_t pos)
+    {
+        if (_dense) {
+            _bits.reset(pos);
+            return;
+        }
+        auto it = std::lower_bound(_vertices.begin(), _vertices.end(), (uint)pos);
+        if (it != _vertices.end() and *it == pos) _vertices.erase(it);
+    }
+
+    /**
+     * Remove all vertices; releases the dense bitset, unless the set is always dense.
+     */
+    void clear()
+    {
+        _vertices.clear();
+        if (!_dense) return;
+        if (sparse_max() == 0) {
+            _bits.reset();
+        } else {
+            bitset().swap(_bits);
+            _dense = false;
+        }
+    }
+
+    size_t find_last() const
+    {
+        if (_dense) return _bits.find_last();
+        return _vertices.empty() ? npos : _vertices.back();
+    }
+
+    size_t find_prev(size_t pos) const
+    {
+        if (_dense) return _bits.find_prev(pos);
+        if (pos == 0 or pos == npos) return npos;
+        auto it = std::lower_bound(_vertices.begin(), _vertices.end(), (uint)pos);
+        return it == _vertices.begin() ? npos : *--it;
+    }
+
+    /**
+     * Call <f> on every vertex in <lo> (inclusive) to <hi> (exclusive), in increasing order.
+     * <f> must not change this set.
+     */
+    template <typename F>
+    void for_each(F f, size_t lo = 0, size_t hi = npos) const
+    {
+        if (_dense) return _bits.for_each(f, lo, hi);
+        for (auto it = lower(lo), end = lower(hi); it != end; it++) f((size_t)*it);
+    }
+
+    /**
+     * As for_each, in decreasing order.
+     */
+    template <typename F>
+    void for_each_reverse(F f, size_t lo = 0, size_t hi = npos) const
+    {
+        if (_dense) return _bits.for_each_reverse(f, lo, hi);
+        for (auto it = lower(hi), begin = lower(lo); it != begin;) f((size_t)*--it);
+    }
+
+    /**
+     * As for_each, for the vertices that are also in <other>.
+     */
+    template <typename F>
+    void for_each_and(const bitset &other, F f, size_t lo = 0, size_t hi = npos) const
+    {
+        if (_dense) return _bits.for_each_and(other, f, lo, hi);
+        for (auto it = lower(lo), end = lower(hi); it != end; it++) if (other[*it]) f((size_t)*it);
+    }
+
+    /**
+     * As for_each_and, in decreasing order.
+     */
+    template <typename F>
+    void for_each_and_reverse(const bitset &other, F f, size_t lo = 0, size_t hi = npos) const
+    {
+        if (_dense) return _bits.for_each_and_reverse(other, f, lo, hi);
+        for (auto it = lower(hi), begin = lower(lo); it != begin;) {
+            const uint v = *--it;
+            if (other[v]) f((size_t)v);
+        }
+    }
+
+    vertexset& operator&=(const bitset &other)
+    {
+        if (_dense) {
+            _bits &= other;
+            adapt();
+        } else {
+            filter([&](uint v) { return !other[v]; });
+        }
+        return *this;
+    }
+
+    vertexset& operator-=(const bitset &other)
+    {
+        if (_dense) {
+            _bits -= other;
+            adapt();
+        } else {
+            filter([&](uint v) { return other[v]; });
+        }
+        return *this;
+    }
+
+    vertexset& operator|=(const bitset &other)
+    {
+        if (!_dense) to_dense();
+        _bits |= other;
+        return *this;
+    }
+
+    vertexset& operator&=(const vertexset &other)
+    {
+        if (!_dense) {
+            filter([&](uint v) { return !other[v]; });
+        } else if (other._dense) {
+            _bits &= other._bits;
+            adapt();
+        } else {
+            // the result is at most as large as the sparse <other>
+            std::vector<uint> res;
+            for (uint v : other._vertices) if (_bits[v]) res.push_back(v);
+            clear();
+            _vertices.swap(res);
+        }
+        return *this;
+    }
+
+    vertexset& operator-=(const vertexset &other)
+    {
+        if (!_dense) {
+            filter([&](uint v) { return other[v]; });
+        } else if (other._dense) {
+            _bits -= other._bits;
+            adapt();
+        } else {
+            for (uint v : other._vertices) _bits.reset(v);
+            adapt();
+        }
+        return *this;
+    }
+
+    vertexset& operator|=(const vertexset &other)
+    {
+        if (!_dense and !other._dense) {
+            std::vector<uint> res;
+            res.reserve(_vertices.size() + other._vertices.size());
+            std::set_union(_vertices.begin(), _vertices.end(), other._vertices.begin(), other._vertices.end(), std::back_inserter(res));
+            _vertices.swap(res);
+            if (_vertices.size() > sparse_max()) to_dense();
+        } else {
+            if (!_dense) to_dense();
+            if (other._dense) _bits |= other._bits;
+            else for (uint v : other._vertices) _bits.set(v);
+        }
+        return *this;
+    }
+
+    vertexset& operator^=(const vertexset &other)
+    {
+        if (!_dense and !other._dense) {
+            std::vector<uint> res;
+            res.reserve(_vertices.size() + other._vertices.size());
+            std::set_symmetric_difference(_vertices.begin(), _vertices.end(), other._vertices.begin(), other._vertices.end(), std::back_inserter(res));
+            _vertices.swap(res);
+            if (_vertices.size() > sparse_max()) to_dense();
+        } else {
+            if (!_dense) to_dense();
+            if (other._dense) _bits ^= other._bits;
+            else for (uint v : other._vertices) _bits[v].flip();
+            adapt();
+        }
+        return *this;
+    }
+
+    /**
+     * Returns the vertices as a bitset of size size().
+     */
+    bitset to_bitset() const
+    {
+        if (_dense) return _bits;
+        bitset res(_size);
+        for (uint v : _vertices) res.set(v);
+        return res;
+    }
+
+    inline void swap(vertexset &other)
+    {
+        std::swap(_size, other._size);
+        std::swap(_dense, other._dense);
+        _bits.swap(other._bits);
+        _vertices.swap(other._vertices);
+    }
+
+    friend bitset& operator|=(bitset &left, const vertexset &right);
+    friend bitset& operator-=(bitset &left, const vertexset &right);
+
+private:
+    static const size_t SPARSE_MIN = 16;
+
+    size_t _size;
+    bool _dense;
+    bitset _bits;                // the vertices, if dense
+    std::vector<uint> _vertices; // the sorted vertices, if sparse
+
+    inline std::vector<uint>::const_iterator lower(size_t pos) const
+    {
+        if (pos >= _size) return _vertices.end();
+        return std::lower_bound(_vertices.begin(), _vertices.end(), (uint)pos);
+    }
+
+    /**
+     * Remove the vertices of a sparse set for which <pred> holds.
+     */
+    template <typename P>
+    void filter(P pred)
+    {
+        _vertices.erase(std::remove_if(_vertices.begin(), _vertices.end(), pred), _vertices.end());
+    }
+
+    void to_dense()
+    {
+        bitset b(_size);
+        for (uint v : _vertices) b.set(v);
+        _bits.swap(b);
+        _vertices.clear();
+        _dense = true;
+    }
+
+    /**
+     * Switch a dense set that shrunk to half of sparse_max() vertices to the sparse array.
+     */
+    void adapt()
+    {
+        if (!_dense or sparse_max() == 0) return;
+        const size_t c = _bits.count();
+        if (c > sparse_max()/2) return;
+        _vertices.clear();
+        _vertices.reserve(c);
+        _bits.for_each([&](size_t v) { _vertices.push_back((uint)v); });
+        bitset().swap(_bits);
+        _dense = false;
+    }
+};
+
+inline bitset& operator|=(bitset &left, const vertexset &right)
+{
+    if (right._dense) left |= right._bits;
+    else for (auto v : right._vertices) left.set(v);
+    return left;
+}
+
+inline bitset& operator-=(bitset &left, const vertexset &right)
+{
+    if (right._dense) left -= right._bits;
+    else for (auto v : right._vertices) left.reset(v);
+    return left;
+}
+
+inline void swap(vertexset &left, vertexset &right)
+{
+    left.swap(right);
+}
+
+}
+
+#endif
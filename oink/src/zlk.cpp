@@ -22,6 +22,9 @@
 
 #include "zlk.hpp"
 #include "lace.h"
+#include "mempolicy.hpp"
+#include "phases.hpp"
+#include "uintfrontier.hpp"
 #include "printf.hpp"
 
 namespace pg {
@@ -40,18 +43,12 @@ ZLKSolver::~ZLKSolver()
     delete[] inverse;
 }
 
-typedef struct
-{
-    int count;
-    int items[];
-} par_helper;
-
-par_helper** pvec;
+static uintfrontier par_frontier; // vertices attracted by each worker during attractPar
 
 VOID_TASK_4(attractParT, int, pl, int, cur, int, r, ZLKSolver*, s)
 {
     int c = 0;
-    par_helper* ours = pvec[LACE_WORKER_ID];
+    const int worker = LACE_WORKER_ID;
 
     // attract to <cur>
     for (auto curedge = s->ins(cur); *curedge != -1; curedge++) {
@@ -65,7 +62,7 @@ VOID_TASK_4(attractParT, int, pl, int, cur, int, r, ZLKSolver*, s)
                 if (__sync_bool_compare_and_swap(&s->region[from], _r, r)) {
                     s->winning[from] = pl;
                     s->strategy[from] = cur;
-                    ours->items[ours->count++] = from;
+                    par_frontier.push(worker, from);
                     SPAWN(attractParT, pl, from, r, s);
                     c++;
                     break;
@@ -109,7 +106,7 @@ VOID_TASK_4(attractParT, int, pl, int, cur, int, r, ZLKSolver*, s)
             if (attracted) {
                 s->winning[from] = pl;
                 s->strategy[from] = -1;
-                ours->items[ours->count++] = from;
+                par_frontier.push(worker, from);
                 SPAWN(attractParT, pl, from, r, s);
                 c++;
             }
@@ -121,14 +118,12 @@ VOID_TASK_4(attractParT, int, pl, int, cur, int, r, ZLKSolver*, s)
 
 TASK_4(int, attractPar, int, i, int, r, std::vector<int>*, R, ZLKSolver*, s)
 {
+    OINK_PHASE("attractPar");
+
     const int pr = s->priority(i);
     const int pl = pr & 1;
 
-    // initialize pvec (set count to 0) for all workers
-    const int W = lace_workers();
-    for (int j=0; j<W; j++) pvec[j]->count = 0;
-
-    par_helper* ours = pvec[LACE_WORKER_ID];
+    const int worker = LACE_WORKER_ID;
     int spawn_count = 0;
 
     for (; i>=0; i--) {
@@ -163,7 +158,7 @@ TASK_4(int, attractPar, int, i, int, r, std::vector<int>*, R, ZLKSolver*, s)
 
         s->winning[i] = pl;
         s->strategy[i] = -1; // head nodes have no strategy (for now)
-        ours->items[ours->count++] = i;
+        par_frontier.push(worker, i);
         SPAWN(attractParT, pl, i, r, s);
         spawn_count++;
     }
@@ -171,21 +166,16 @@ TASK_4(int, attractPar, int, i, int, r, std::vector<int>*, R, ZLKSolver*, s)
     // first SYNC on all children (if any)
     while (spawn_count) { SYNC(attractParT); spawn_count--; }
 
-    // update R
-    size_t to_reserve = R->size();
-    for (int j=0; j<W; j++) to_reserve += pvec[j]->count;
-    R->reserve(to_reserve);
-
-    for (int j=0; j<W; j++) {
-        par_helper* x = pvec[j];
-        for (int k=0; k<x->count; k++) {
+    // update R, in a deterministic order when tracing
 #ifndef NDEBUG
-            if (s->trace >= 2) s->logger << "attracted " << x->items[k] << " (" << s->priority(x->items[k]) << ")" << std::endl;
+    const size_t start = R->size();
 #endif
-            R->push_back(x->items[k]);
-        }
-        x->count = 0;
+    par_frontier.drain(*R, s->trace >= 2);
+#ifndef NDEBUG
+    if (s->trace >= 2) {
+        for (size_t k=start; k<R->size(); k++) s->logger << "attracted " << (*R)[k] << " (" << s->priority((*R)[k]) << ")" << std::endl;
     }
+#endif
 
     return i;
 }
@@ -193,6 +183,8 @@ TASK_4(int, attractPar, int, i, int, r, std::vector<int>*, R, ZLKSolver*, s)
 int
 ZLKSolver::attractExt(int i, int r, std::vector<int> *R)
 {
+    OINK_PHASE("attractExt");
+
     const int pr = priority(i);
     const int pl = pr & 1;
 
@@ -278,6 +270,8 @@ ZLKSolver::attractExt(int i, int r, std::vector<int> *R)
 int
 ZLKSolver::attractLosing(const int i, const int r, std::vector<int> *S, std::vector<int> *R)
 {
+    OINK_PHASE("attractLosing");
+
     int count = 0;
 
     const int pr = priority(i);
@@ -394,18 +388,20 @@ ZLKSolver::run()
 {
     iterations = 0;
 
-    // allocate and initialize data structures
-    region = new int[nodecount()];
-    winning = new int[nodecount()];
-    strategy = new int[nodecount()];
+    // allocate and initialize data structures (with the memory policy of Oink)
+    region = (int*)mem_alloc(sizeof(int[nodecount()]));
+    winning = (int*)mem_alloc(sizeof(int[nodecount()]));
+    strategy = (int*)mem_alloc(sizeof(int[nodecount()]));
+    if (region == NULL or winning == NULL or strategy == NULL) abort();
 
     std::vector<int> history;
     std::vector<int> W0, W1;
     std::vector<std::vector<int>> levels;
 
-    // initialize arrays
-    memset(winning, -1, sizeof(int[nodecount()]));
-    memset(strategy, -1, sizeof(int[nodecount()]));
+    // initialize arrays (by the workers with a first-touch memory policy, to place the pages)
+    mem_set(region, -1, sizeof(int[nodecount()]));
+    mem_set(winning, -1, sizeof(int[nodecount()]));
+    mem_set(strategy, -1, sizeof(int[nodecount()]));
 
     // get number of nodes and create and initialize inverse array
     max_prio = -1;
@@ -439,12 +435,10 @@ ZLKSolver::run()
     // Task* __lace_dq_head = NULL;
 
     if (usePar) {
-        // initialize Lace and also allocate space for pvec for each worker
-        const int W = lace_workers();
+        // initialize Lace and also the frontier of attracted vertices for each worker
         // __lace_worker = lace_get_worker();
         // __lace_dq_head = lace_get_head(__lace_worker);
-        pvec = (par_helper**)malloc(sizeof(par_helper*[W]));
-        for (int i=0; i<W; i++) pvec[i] = (par_helper*)malloc(sizeof(par_helper) + sizeof(int[nodecount()]));
+        par_frontier.resize(lace_workers());
     }
 
     // initialize first level (i, r=1, phase=0)
@@ -701,11 +695,7 @@ ZLKSolver::run()
     }
     // ---------- EndWhile ----------
 
-    if (usePar) {
-        const int W = lace_workers();
-        for (int i=0; i<W; i++) free(pvec[i]);
-        free(pvec);
-    }
+    if (usePar) par_frontier.resize(0);
 
     // done
     for (int i=0; i<nodecount(); i++) {
@@ -716,11 +706,12 @@ ZLKSolver::run()
         oink->solve(i, winning[i], strategy[i]);
     }
 
-    delete[] region;
-    delete[] winning;
-    delete[] strategy;
+    mem_free(region, sizeof(int[nodecount()]));
+    mem_free(winning, sizeof(int[nodecount()]));
+    mem_free(strategy, sizeof(int[nodecount()]));
 
     logger << "solved with " << iterations << " iterations." << std::endl;
+    stats.count("iterations", iterations);
 }
 
 }
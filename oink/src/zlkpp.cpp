@@ -269,6 +269,7 @@ void ZLKPPSolver::run() {
     }
 
     logger << "solved with " << iterations << " iterations." << std::endl;
+    stats.count("iterations", iterations);
 
     delete[] cur_nodes_bm;
     delete[] cur_nodes_next;
@@ -37,13 +37,26 @@ ZLKQSolver::~ZLKQSolver()
 {
 }
 
+/**
+ * Returns the highest vertex in <S> that is at most <vtop>, or -1 if there is none.
+ */
+static inline int
+top(const vertexset &S, int vtop)
+{
+    if (vtop < 0 or S[vtop]) return vtop;
+    const size_t v = S.find_prev(vtop);
+    return v == vertexset::npos ? -1 : (int)v;
+}
+
 /**
  * Attract vertices in <R> from subgame <Y> to <v> in region <Z> as player <pl>.
  * We attract only vertices in <R>, but the opponent may escape to <R> and <Y>.
  * Attracted vertices are added to <Z> and to the queue <Q>.
+ * <Z> is a bitset for the winning regions, or a vertexset for a region in the subgame.
  */
+template <typename S>
 void
-ZLKQSolver::attractVertices(const int pl, const int v, bitset &Z, bitset &R, bitset &Y)
+ZLKQSolver::attractVertices(const int pl, const int v, S &Z, const vertexset &R, const vertexset &Y)
 {
     auto curedge = ins(v);
     for (int from = *curedge; from != -1; from = *++curedge) {
@@ -70,7 +83,7 @@ ZLKQSolver::attractVertices(const int pl, const int v, bitset &Z, bitset &R, bit
                 if (escapes) continue;
             }
             // vertex does not escape, so attract it
-            Z[from] = true;
+            Z.set(from);
             str[from] = owner(from) == pl ? v : -1;
             Q.push(from);
 #ifndef NDEBUG
@@ -86,7 +99,7 @@ ZLKQSolver::attractVertices(const int pl, const int v, bitset &Z, bitset &R, bit
 }
 
 void
-ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
+ZLKQSolver::solve(const vertexset &SG, int vtop, const int pe, const int po)
 {
     /**
      * This is based on a universal tree of height pr/2, with parameter n associated with pe or po
@@ -113,11 +126,9 @@ ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
 #ifndef NDEBUG
         if (trace and SG.any()) {
             logger << "End of precision; presumed won by player 0:";
-            for (int v=vtop; v>=0; v--) {
-                if (SG[v]) {
-                    logger << " \033[38;5;38m" << label_vertex(v) << "\033[m";
-                }
-            }
+            SG.for_each_reverse([&](size_t v) {
+                logger << " \033[38;5;38m" << label_vertex(v) << "\033[m";
+            }, 0, vtop+1);
             logger << std::endl;
         }
 #endif
@@ -131,11 +142,9 @@ ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
 #ifndef NDEBUG
         if (trace and SG.any()) {
             logger << "End of precision; presumed won by player 1:";
-            for (int v=vtop; v>=0; v--) {
-                if (SG[v]) {
-                    logger << " \033[38;5;38m" << label_vertex(v) << "\033[m";
-                }
-            }
+            SG.for_each_reverse([&](size_t v) {
+                logger << " \033[38;5;38m" << label_vertex(v) << "\033[m";
+            }, 0, vtop+1);
             logger << std::endl;
         }
 #endif
@@ -147,7 +156,7 @@ ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
      * Move <vtop> to the true top (highest vertex that is in SG)
      */
 
-    while (vtop >= 0 and !SG[vtop]) vtop--;
+    vtop = top(SG, vtop);
 
     /**
      * Check if the game is empty
@@ -195,40 +204,39 @@ ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
      * That is, the intersection of SG and Wm.
      *
      * Consider R to be the game that remains after the steps on the left in the universal tree.
-     * Fmore, SG is immutable, R is a local bitset
+     * Fmore, SG is immutable, R is a local vertexset
      */
 
-    bitset R(SG);
+    vertexset R(SG);
     R &= Wm;
 
     /**
      * Update vtop to the highest vertex in the intersection
      */
-    while (vtop >= 0 and !R[vtop]) vtop--;
+    vtop = top(R, vtop);
     if (vtop == -1) return;
 
     /**
      * Compute H := Attr(vertices of <pr> in <R>)
      */
-    bitset H(nodecount());
+    vertexset H(nodecount());
 
-    for (int v=vtop; v!=-1; v--) {
-        // if (priority(v) != pr) break; // stop attracting ... ;) [todo: add otf compression ?]
-        if ((priority(v)&1) != pl) break; // on-the-fly compression
-        if (R[v]) {
-            H[v] = true;
+    // on-the-fly compression: only the vertices down to the first priority of the other parity
+    if ((priority(vtop)&1) == pl) {
+        R.for_each_reverse([&](size_t v) {
+            H.set(v);
             str[v] = -1;
             Q.push(v);
             while (Q.nonempty()) {
                 attractVertices(pl, Q.pop(), H, R, R);
             }
-        }
+        }, parity_start[vtop], vtop+1);
     }
 
 #ifndef NDEBUG
     if (trace) {
         logger << "\033[1;33mregion \033[36m" << pr << "\033[m";
-        for (auto v = H.find_last(); v != bitset::npos; v = H.find_prev(v)) {
+        for (auto v = H.find_last(); v != vertexset::npos; v = H.find_prev(v)) {
             logger << " \033[38;5;38m" << label_vertex(v) << "\033[m";
         }
         logger << std::endl;
@@ -258,9 +266,7 @@ ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
      * The intersection of H and Wo is the opponent's subgame
      */
     bool opponent_attracted_from_us = false;
-    for (int v=0; v<=vtop; v++) {
-        if (H[v] and Wo[v]) Q.push(v);
-    }
+    H.for_each_and(Wo, [&](size_t v) { Q.push(v); }, 0, vtop+1);
     if (Q.nonempty()) {
         while (Q.nonempty()) {
             const int v = Q.pop();
@@ -282,19 +288,17 @@ ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
      */
     if (trace >= 2) {
         logger << "Subgame of (" << pr << " pe=" << pe << " po=" << po << "):";
-        for (int v=vtop; v>=0; v--) {
-            if (SG[v]) {
-                if (R[v]) {
-                    if (Wm[v]) {
-                        if (Wo[v]) logger << " \033[38;5;202m" << label_vertex(v) << "\033[m";
-                        else if (!H[v]) logger << " \033[1;38;5;46m" << label_vertex(v) << "\033[m";
-                        else logger << " \033[38;5;38m" << label_vertex(v) << "\033[m";
-                    }
-                    else logger << " \033[1;38;5;196m" << label_vertex(v) << "\033[m";
+        SG.for_each_reverse([&](size_t v) {
+            if (R[v]) {
+                if (Wm[v]) {
+                    if (Wo[v]) logger << " \033[38;5;202m" << label_vertex(v) << "\033[m";
+                    else if (!H[v]) logger << " \033[1;38;5;46m" << label_vertex(v) << "\033[m";
+                    else logger << " \033[38;5;38m" << label_vertex(v) << "\033[m";
                 }
-                else logger << " \033[38;5;160m" << label_vertex(v) << "\033[m";
+                else logger << " \033[1;38;5;196m" << label_vertex(v) << "\033[m";
             }
-        }
+            else logger << " \033[38;5;160m" << label_vertex(v) << "\033[m";
+        }, 0, vtop+1);
         logger << std::endl;
     }
 #endif
@@ -312,7 +316,7 @@ ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
         R -= Wo;
 
         // Update vtop
-        while (vtop >= 0 and !R[vtop]) vtop--;
+        vtop = top(R, vtop);
 
         // Check if the game is empty
         if (vtop == -1) return; // empty game, bye
@@ -322,8 +326,8 @@ ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
         else solve(R, vtop, pe/2, po);
     } else {
         // Set strategy for vertices that do not yet have a strategy
-        for (int v=vtop; v>=0; v--) {
-            if (R[v] and Wm[v] and owner(v) == pl and str[v] == -1) {
+        R.for_each_and_reverse(Wm, [&](size_t v) {
+            if (owner(v) == pl and str[v] == -1) {
                 auto curedge = outs(v);
                 for (int to = *curedge; to != -1; to = *++curedge) {
                     if (Wm[to]) {
@@ -332,7 +336,7 @@ ZLKQSolver::solve(bitset &SG, int vtop, const int pe, const int po)
                     }
                 }
             }
-        }
+        }, 0, vtop+1);
     }
 }
 
@@ -343,6 +347,12 @@ ZLKQSolver::run()
 
     str = new int[nodecount()];
 
+    // for every vertex, the lowest vertex below it with only priorities of the same parity between
+    parity_start = new int[nodecount()];
+    for (int v=0; v<nodecount(); v++) {
+        parity_start[v] = (v > 0 and ((priority(v-1) ^ priority(v)) & 1) == 0) ? parity_start[v-1] : v;
+    }
+
     Q.resize(nodecount());
     W0.resize(nodecount());
     W1.resize(nodecount());
@@ -351,7 +361,7 @@ ZLKQSolver::run()
     G = disabled;
     G.flip();
 
-    solve(G, nodecount()-1, nodecount(), nodecount());
+    solve(vertexset(G), nodecount()-1, nodecount(), nodecount());
 
 #ifndef NDEBUG
     if (trace) {
@@ -388,6 +398,7 @@ ZLKQSolver::run()
     }
 
     logger << "solved with " << iterations << " iterations." << std::endl;
+    stats.count("iterations", iterations);
 
     // check if actually all solved
 #ifndef NDEBUG
@@ -397,6 +408,7 @@ ZLKQSolver::run()
 #endif
 
     delete[] str;
+    delete[] parity_start;
 }
 
 }
@@ -21,6 +21,7 @@
 
 #include "oink.hpp"
 #include "solver.hpp"
+#include "vertexset.hpp"
 
 namespace pg {
 
@@ -45,11 +46,13 @@ protected:
 
     uintqueue Q;
     int *str;
+    int *parity_start;
 
     bitset W0, W1; // current approximation of winning areas
 
-    inline void attractVertices(const int pl, const int v, bitset &Z, bitset &R, bitset &Y);
-    void solve(bitset &Subgame, int vtop, int pe, int po);
+    template <typename S>
+    inline void attractVertices(const int pl, const int v, S &Z, const vertexset &R, const vertexset &Y);
+    void solve(const vertexset &Subgame, int vtop, int pe, int po);
 };
 
 }
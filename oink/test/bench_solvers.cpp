@@ -0,0 +1,689 @@
+/*
+ * Copyright 2020 Tom van Dijk
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Benchmark of parity game solvers on a matrix of solvers and games.
+ *
+ * The games are random games, games of the generator library (random, ladder, tc, ...),
+ * games written to stdout by generator commands (tc, stgame, rngame, counter_*, ...) and
+ * game files. Every solver runs on every game in a forked
+ * process, first the warmup runs, then the timed trials, so the peak RSS is that of the
+ * solver and game, and a timeout or crash only loses that pair.
+ * The results are written as JSON or CSV; a CSV file of an earlier run is a baseline to
+ * detect regressions.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/random/mersenne_twister.hpp>
+
+#include "tools/cxxopts.hpp"
+#include "tools/getrss.h"
+#include "game.hpp"
+#include "generators.hpp"
+#include "oink.hpp"
+#include "solvers.hpp"
+#include "verifier.hpp"
+#include "lace.h"
+
+using namespace pg;
+namespace fs = boost::filesystem;
+namespace io = boost::iostreams;
+
+Solvers solvers;
+
+bool opt_inflate = false;
+bool opt_compress = false;
+bool opt_single = false;
+bool opt_loops = false;
+bool opt_wcwc = false;
+bool opt_verify = false;
+int opt_workers = -1;
+int opt_trials = 5;
+int opt_warmup = 1;
+int opt_timeout = 0;
+
+/**
+ * A game of the benchmark.
+ */
+struct bench_game
+{
+    std::string family;
+    std::string name;
+    Game game;
+};
+
+/**
+ * The result of one solver on one game.
+ */
+struct bench_result
+{
+    std::string solver;
+    std::string family;
+    std::string game;
+    long vertices = 0;
+    long edges = 0;
+    std::string status = "crash";       // ok, error, wrong, timeout or crash
+    std::vector<double> wall;           // per trial, in seconds
+    std::vector<double> cpu;            // per trial, in seconds, of all threads
+    long peak_rss = 0;                  // in bytes
+    std::map<std::string, long> counters;
+};
+
+static double
+cputime()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + 1E-9 * ts.tv_nsec;
+}
+
+static double
+median(std::vector<double> v)
+{
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    return n & 1 ? v[n/2] : (v[n/2-1] + v[n/2]) / 2;
+}
+
+/*------------------------------------------------------------------------*/
+
+/**
+ * Run solver <solverid> on <game> in the forked child, and write the results to <out>:
+ * lines "trial <wall> <cpu>", "counter <name> <value>", "rss <bytes>" and "status <status>".
+ */
+static void
+run_child(Game &game, int solverid, FILE *out)
+{
+    if (opt_timeout > 0) alarm(opt_timeout);
+    if (opt_workers >= 0) lace_start(opt_workers, 1000000UL);
+
+    std::stringstream log;
+    std::map<std::string, long> counters;
+    const char *status = "ok";
+
+    for (int i=0; i<opt_warmup+opt_trials; i++) {
+        Game copy(game);
+        Oink solver(copy, log);
+        solver.setRenumber(); // default
+        if (opt_inflate) solver.setInflate();
+        if (opt_compress) solver.setCompress();
+        solver.setSolveSingle(opt_single);
+        solver.setRemoveLoops(opt_loops);
+        solver.setRemoveWCWC(opt_wcwc);
+        solver.setWorkers(opt_workers);
+        solver.setSolver(solverid);
+        solver.setTrace(0);
+
+        log.str("");
+        const auto begin = std::chrono::steady_clock::now();
+        const double cpu_begin = cputime();
+        try {
+            solver.run();
+        } catch (pg::Error &err) {
+            status = "error";
+            break;
+        }
+        const double cpu = cputime() - cpu_begin;
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        if (i == 0 and opt_verify) {
+            try {
+                Game sol(game);
+                sol.copy_solution(copy);
+                Verifier v(&sol, log);
+                v.verify(true, true, true);
+            } catch (const char *err) {
+                status = "wrong";
+                break;
+            }
+        }
+
+        if (i >= opt_warmup) fprintf(out, "trial %.9f %.9f\n", wall, cpu);
+        // the counters of the last run, they are the same for every run of a sequential solver
+        if (i == opt_warmup+opt_trials-1) {
+            for (auto &c : solver.getStats().counters()) counters[c.first] = c.second;
+        }
+    }
+
+    for (auto &c : counters) fprintf(out, "counter %s %ld\n", c.first.c_str(), c.second);
+    fprintf(out, "rss %zu\n", getPeakRSS());
+    fprintf(out, "status %s\n", status);
+    fflush(out);
+
+    if (opt_workers >= 0) lace_stop();
+}
+
+/**
+ * Run solver <solverid> on <bg> in a forked process and collect the results.
+ */
+static bench_result
+run_case(bench_game &bg, int solverid)
+{
+    bench_result res;
+    res.solver = solvers.label(solverid);
+    res.family = bg.family;
+    res.game = bg.name;
+    res.vertices = bg.game.vertexcount();
+    res.edges = bg.game.edgecount();
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        res.status = "error";
+        return res;
+    }
+
+    std::cout << std::flush;
+    const pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        FILE *out = fdopen(fds[1], "w");
+        run_child(bg.game, solverid, out);
+        fclose(out);
+        _exit(0);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        res.status = "error";
+        return res;
+    }
+
+    FILE *in = fdopen(fds[0], "r");
+    char buf[4096];
+    while (fgets(buf, sizeof(buf), in) != NULL) {
+        std::istringstream line(buf);
+        std::string key;
+        line >> key;
+        if (key == "trial") {
+            double wall, cpu;
+            line >> wall >> cpu;
+            res.wall.push_back(wall);
+            res.cpu.push_back(cpu);
+        } else if (key == "counter") {
+            std::string name;
+            long value;
+            line >> name >> value;
+            res.counters[name] = value;
+        } else if (key == "rss") {
+            line >> res.peak_rss;
+        } else if (key == "status") {
+            line >> res.status;
+        }
+    }
+    fclose(in);
+
+    int wstatus;
+    waitpid(pid, &wstatus, 0);
+    if (WIFSIGNALED(wstatus)) res.status = WTERMSIG(wstatus) == SIGALRM ? "timeout" : "crash";
+    else if (WEXITSTATUS(wstatus) != 0) res.status = "crash";
+
+    return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+static void
+add_random_games(std::vector<bench_game*> &games, int size, int count, unsigned int seed)
+{
+    // the same series of game seeds as test_solvers
+    boost::random::mt19937 generator(seed);
+    for (int i=0; i<count; i++) {
+        bench_game *bg = new bench_game();
+        bg->family = "random";
+        bg->name = "random-" + std::to_string(size) + "-" + std::to_string(i);
+        bg->game.set_random_seed(generator());
+        bg->game.init_random_game(size, size, 3L*size);
+        games.push_back(bg);
+    }
+}
+
+/**
+ * Run the generator command <cmd>, which writes a game in PGSolver format to stdout.
+ * A generator without a path is first looked up in the directory <tooldir> of this tool.
+ */
+static void
+add_generated_game(std::vector<bench_game*> &games, const std::string &cmd, const std::string &tooldir)
+{
+    const std::string prog = cmd.substr(0, cmd.find(' '));
+    std::string full = cmd;
+    if (prog.find('/') == std::string::npos and access((tooldir + prog).c_str(), X_OK) == 0) full = tooldir + cmd;
+
+    FILE *p = popen(full.c_str(), "r");
+    if (p == NULL) {
+        std::cerr << "cannot run generator \"" << cmd << "\"" << std::endl;
+        return;
+    }
+    std::string text;
+    char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), p)) != 0) text.append(buf, n);
+    if (pclose(p) != 0) {
+        std::cerr << "generator \"" << cmd << "\" failed" << std::endl;
+        return;
+    }
+
+    bench_game *bg = new bench_game();
+    bg->family = prog.substr(prog.rfind('/') + 1);
+    bg->name = cmd;
+    try {
+        std::istringstream in(text);
+        bg->game.parse_pgsolver(in, opt_loops);
+        games.push_back(bg);
+    } catch (const char *err) {
+        std::cerr << "generator \"" << cmd << "\" did not write a parity game: " << err << std::endl;
+        delete bg;
+    }
+}
+
+/**
+ * Generate the game <spec> ("family arg arg ...") with the generator library.
+ */
+static void
+add_family_game(std::vector<bench_game*> &games, const std::string &spec, unsigned int seed)
+{
+    std::istringstream words(spec);
+    std::string name;
+    words >> name;
+    std::vector<long> args;
+    long arg;
+    while (words >> arg) args.push_back(arg);
+    if (!words.eof()) {
+        std::cerr << "game family \"" << spec << "\": arguments must be numbers" << std::endl;
+        return;
+    }
+
+    bench_game *bg = new bench_game();
+    bg->family = name;
+    bg->name = spec;
+    try {
+        generators::generate(bg->game, name, args, seed);
+        games.push_back(bg);
+    } catch (const char *err) {
+        std::cerr << "game family \"" << spec << "\": " << err << std::endl;
+        delete bg;
+    }
+}
+
+static void
+add_file_game(std::vector<bench_game*> &games, const fs::path &path)
+{
+    const std::string filename = path.filename().string();
+    io::filtering_istream in;
+    if (boost::algorithm::ends_with(filename, ".bz2")) in.push(io::bzip2_decompressor());
+    if (boost::algorithm::ends_with(filename, ".gz")) in.push(io::gzip_decompressor());
+    std::ifstream inp(path.c_str(), std::ios_base::binary);
+    in.push(inp);
+
+    bench_game *bg = new bench_game();
+    bg->family = path.parent_path().filename().string();
+    bg->name = filename;
+    try {
+        bg->game.parse_pgsolver(in, opt_loops);
+        games.push_back(bg);
+    } catch (const char *err) {
+        std::cerr << filename << ": not a parity game input?!" << std::endl;
+        delete bg;
+    }
+}
+
+/*------------------------------------------------------------------------*/
+
+static std::string
+json_string(const std::string &s)
+{
+    std::string res = "\"";
+    for (char c : s) {
+        if (c == '"' or c == '\\') res += '\\';
+        if ((unsigned char)c < 0x20) res += ' ';
+        else res += c;
+    }
+    return res + "\"";
+}
+
+static void
+write_json(std::ostream &out, const std::vector<bench_result> &results)
+{
+    out << std::setprecision(9);
+    out << "{" << std::endl;
+    out << "  \"workers\": " << opt_workers << "," << std::endl;
+    out << "  \"warmup\": " << opt_warmup << "," << std::endl;
+    out << "  \"trials\": " << opt_trials << "," << std::endl;
+    out << "  \"results\": [";
+    for (size_t i=0; i<results.size(); i++) {
+        const bench_result &r = results[i];
+        out << (i ? "," : "") << std::endl << "    {";
+        out << "\"solver\": " << json_string(r.solver);
+        out << ", \"family\": " << json_string(r.family);
+        out << ", \"game\": " << json_string(r.game);
+        out << ", \"vertices\": " << r.vertices << ", \"edges\": " << r.edges;
+        out << ", \"status\": " << json_string(r.status);
+        out << ", \"wall\": [";
+        for (size_t j=0; j<r.wall.size(); j++) out << (j ? ", " : "") << r.wall[j];
+        out << "], \"cpu\": [";
+        for (size_t j=0; j<r.cpu.size(); j++) out << (j ? ", " : "") << r.cpu[j];
+        out << "], \"wall_median\": " << median(r.wall) << ", \"cpu_median\": " << median(r.cpu);
+        out << ", \"peak_rss\": " << r.peak_rss;
+        out << ", \"counters\": {";
+        bool first = true;
+        for (auto &c : r.counters) {
+            out << (first ? "" : ", ") << json_string(c.first) << ": " << c.second;
+            first = false;
+        }
+        out << "}}";
+    }
+    out << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
+
+static std::string
+csv_field(const std::string &s)
+{
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string res = "\"";
+    for (char c : s) {
+        if (c == '"') res += '"';
+        res += c;
+    }
+    return res + "\"";
+}
+
+static const char *CSV_HEADER = "solver,family,game,vertices,edges,status,trials,wall_median,wall_min,wall_max,cpu_median,peak_rss,counters";
+
+static void
+write_csv(std::ostream &out, const std::vector<bench_result> &results)
+{
+    out << std::setprecision(9);
+    out << CSV_HEADER << std::endl;
+    for (const bench_result &r : results) {
+        std::string counters;
+        for (auto &c : r.counters) {
+            if (!counters.empty()) counters += ";";
+            counters += c.first + "=" + std::to_string(c.second);
+        }
+        out << csv_field(r.solver) << "," << csv_field(r.family) << "," << csv_field(r.game) << ",";
+        out << r.vertices << "," << r.edges << "," << r.status << "," << r.wall.size() << ",";
+        if (r.wall.empty()) out << "0,0,0,";
+        else out << median(r.wall) << "," << *std::min_element(r.wall.begin(), r.wall.end()) << "," << *std::max_element(r.wall.begin(), r.wall.end()) << ",";
+        out << median(r.cpu) << "," << r.peak_rss << "," << csv_field(counters) << std::endl;
+    }
+}
+
+static std::vector<std::string>
+csv_split(const std::string &line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i=0; i<line.size(); i++) {
+        const char c = line[i];
+        if (quoted) {
+            if (c != '"') fields.back() += c;
+            else if (i+1 < line.size() and line[i+1] == '"') fields.back() += line[++i];
+            else quoted = false;
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+/**
+ * Compare <results> with the CSV file <filename> of an earlier run.
+ * A regression is a pair that no longer solves, or whose median wall time or peak RSS grew
+ * by more than <threshold> (relative) and more than <noise> seconds or 1 MB.
+ * Returns the number of regressions.
+ */
+static int
+compare_baseline(const std::string &filename, const std::vector<bench_result> &results, double threshold, double noise)
+{
+    std::ifstream in(filename);
+    std::string line;
+    if (!in or !std::getline(in, line) or line != CSV_HEADER) {
+        std::cerr << "baseline " << filename << " is not a CSV file of bench_solvers" << std::endl;
+        return 1;
+    }
+
+    struct base_entry { std::string status; double wall; long rss; };
+    std::map<std::string, base_entry> base;
+    while (std::getline(in, line)) {
+        const auto f = csv_split(line);
+        if (f.size() != 13) continue;
+        base[f[0] + "\n" + f[1] + "\n" + f[2]] = { f[5], std::stod(f[7]), std::stol(f[11]) };
+    }
+
+    int regressions = 0, improvements = 0, compared = 0;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const bench_result &r : results) {
+        auto it = base.find(r.solver + "\n" + r.family + "\n" + r.game);
+        if (it == base.end()) continue;
+        const base_entry &b = it->second;
+        compared++;
+        if (b.status == "ok" and r.status != "ok") {
+            std::cout << "\033[38;5;196mregression\033[m " << r.solver << " " << r.family << "/" << r.game << ": " << r.status << std::endl;
+            regressions++;
+            continue;
+        }
+        if (b.status != "ok" or r.status != "ok") continue;
+
+        const double wall = median(r.wall);
+        if (wall > b.wall * (1.0 + threshold) and wall - b.wall > noise) {
+            std::cout << "\033[38;5;196mregression\033[m " << r.solver << " " << r.family << "/" << r.game << ": ";
+            std::cout << "time " << 1000.0*b.wall << " ms -> " << 1000.0*wall << " ms (+" << 100.0*(wall/b.wall-1.0) << "%)" << std::endl;
+            regressions++;
+        } else if (wall < b.wall * (1.0 - threshold) and b.wall - wall > noise) {
+            improvements++;
+        }
+        if (r.peak_rss > b.rss * (1.0 + threshold) and r.peak_rss - b.rss > (1L<<20)) {
+            std::cout << "\033[38;5;196mregression\033[m " << r.solver << " " << r.family << "/" << r.game << ": ";
+            std::cout << "peak RSS " << b.rss/1048576.0 << " MB -> " << r.peak_rss/1048576.0 << " MB" << std::endl;
+            regressions++;
+        }
+    }
+    std::cout << "\033[38;5;226mbaseline\033[m: " << compared << " compared, " << regressions << " regressions, " << improvements << " improvements" << std::endl;
+    return regressions;
+}
+
+/*------------------------------------------------------------------------*/
+
+int
+main(int argc, char **argv)
+{
+    cxxopts::Options opts(argv[0], "Benchmark parity game solvers");
+    opts.custom_help("[OPTIONS...] [FILES...]");
+    opts.add_options()
+        ("help", "Print help")
+        ;
+    opts.add_options("Games")
+        ("random", "Random games with the given sizes, e.g., 1000,10000", cxxopts::value<std::vector<int>>())
+        ("count", "Number of random games of each size", cxxopts::value<int>()->default_value("1"))
+        ("seed", "Seed for the random seed generator", cxxopts::value<unsigned int>()->default_value("0"))
+        ("family", "Game of the generator library, e.g., \"random 1000000 100 1 5\" (repeatable, see --families)", cxxopts::value<std::vector<std::string>>())
+        ("families", "List the game families of --family")
+        ("gen", "Generator command that writes a game to stdout, e.g., \"tc 8\" (repeatable)", cxxopts::value<std::vector<std::string>>())
+        ;
+    opts.add_options("Preprocessing")
+        ("inflate", "Inflate the game before solving")
+        ("compress", "Compress the game before solving")
+        ("locality", "Renumber the vertices within each priority for memory locality")
+        ("single", "Enable preprocessor \"single\" (solve single-parity games)")
+        ("loops", "Enable preprocessor \"loops\" (remove/solve self-loops)")
+        ("wcwc", "Enable preprocessor \"wcwc\" (solve winner-controlled winning cycles)")
+        ;
+    opts.add_options("Benchmark")
+        ("trials", "Number of timed runs of each solver on each game", cxxopts::value<int>()->default_value("5"))
+        ("warmup", "Number of untimed runs before the trials", cxxopts::value<int>()->default_value("1"))
+        ("timeout", "Seconds for all runs of a solver on a game, 0 for no timeout", cxxopts::value<int>()->default_value("0"))
+        ("verify", "Verify the solution of the first run")
+        ("w,workers", "Number of workers for parallel algorithms, or -1 for sequential, 0 for autodetect", cxxopts::value<int>()->default_value("-1"))
+        ;
+    opts.add_options("Output")
+        ("json", "Write the results as JSON to the given file (- for stdout)", cxxopts::value<std::string>())
+        ("csv", "Write the results as CSV to the given file (- for stdout)", cxxopts::value<std::string>())
+        ("baseline", "Compare with the CSV file of an earlier run, exit with 1 on regressions", cxxopts::value<std::string>())
+        ("threshold", "Relative increase of time or memory that is a regression", cxxopts::value<double>()->default_value("0.1"))
+        ("noise", "Increases of time below this many seconds are no regressions", cxxopts::value<double>()->default_value("0.005"))
+        ;
+    opts.add_options("Solvers")
+        ("all", "Run all solvers")
+        ;
+    for (unsigned id=0; id<solvers.count(); id++) {
+        opts.add_options("Solvers")(solvers.label(id), solvers.desc(id));
+    }
+
+    /* Parse command line */
+    auto options = opts.parse(argc, argv);
+
+    if (options.count("help")) {
+        std::cout << opts.help({"","Games","Preprocessing","Benchmark","Output","Solvers"}) << std::endl;
+        return 0;
+    }
+
+    if (options.count("families")) {
+        for (auto f = generators::families; f->name != NULL; f++) {
+            std::cout << std::left << std::setw(8) << f->name << std::setw(32) << f->args << f->description << std::endl;
+        }
+        return 0;
+    }
+
+    opt_inflate = options.count("inflate") != 0;
+    opt_compress = options.count("compress") != 0;
+    opt_single = options.count("single") != 0;
+    opt_loops = options.count("loops") != 0;
+    opt_wcwc = options.count("wcwc") != 0;
+    opt_verify = options.count("verify") != 0;
+    opt_workers = options["workers"].as<int>();
+    opt_trials = std::max(1, options["trials"].as<int>());
+    opt_warmup = std::max(0, options["warmup"].as<int>());
+    opt_timeout = options["timeout"].as<int>();
+
+    std::vector<int> selected;
+    for (unsigned id=0; id<solvers.count(); id++) {
+        if (options.count("all") or options.count(solvers.label(id))) selected.push_back(id);
+    }
+
+    // collect the games: random games, library games, generated games, then files
+    std::vector<bench_game*> games;
+    if (options.count("random")) {
+        for (int size : options["random"].as<std::vector<int>>()) {
+            add_random_games(games, size, options["count"].as<int>(), options["seed"].as<unsigned int>());
+        }
+    }
+    if (options.count("family")) {
+        // the generators fill ranges of vertices in parallel when Lace runs
+        if (opt_workers >= 0) lace_start(opt_workers, 0);
+        for (auto &spec : options["family"].as<std::vector<std::string>>()) {
+            add_family_game(games, spec, options["seed"].as<unsigned int>());
+        }
+        if (opt_workers >= 0) lace_stop();
+    }
+    if (options.count("gen")) {
+        const std::string self = argv[0];
+        const std::string tooldir = self.substr(0, self.rfind('/') + 1);
+        for (auto &cmd : options["gen"].as<std::vector<std::string>>()) add_generated_game(games, cmd, tooldir);
+    }
+    std::vector<fs::path> files;
+    for (int i=1; i<argc; i++) {
+        fs::path p(argv[i]);
+        if (!exists(p)) {
+            std::cerr << "path \"" << argv[i] << "\" not found!" << std::endl;
+        } else if (is_directory(p)) {
+            for (auto cp=fs::directory_iterator(p); cp != fs::directory_iterator(); cp++) {
+                if (is_regular_file(*cp)) files.push_back(*cp);
+            }
+        } else if (is_regular_file(p)) {
+            files.push_back(p);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    for (auto &p : files) add_file_game(games, p);
+
+    if (selected.empty() or games.empty()) {
+        std::cout << "Use --help for program options." << std::endl << std::endl;
+        std::cout << "- Select one or more solvers" << std::endl;
+        std::cout << "- Select games: --random sizes, --family games, --gen commands and/or files/directories" << std::endl;
+        return 0;
+    }
+
+    for (auto bg : games) {
+        bg->game.reset_solution();
+        if (options.count("locality")) bg->game.sort_locality();
+        else bg->game.ensure_sorted();
+    }
+
+    std::vector<bench_result> results;
+    for (auto bg : games) {
+        for (int id : selected) {
+            bench_result r = run_case(*bg, id);
+            std::cout << std::left << std::setw(8) << r.solver << std::right << " " << r.family << "/" << r.game << ": ";
+            if (r.status == "ok") {
+                std::cout << std::fixed << std::setprecision(1) << 1000.0*median(r.wall) << " ms";
+                std::cout << " \033[38;5;8m(cpu " << 1000.0*median(r.cpu) << " ms, rss " << r.peak_rss/1048576.0 << " MB";
+                for (auto &c : r.counters) std::cout << ", " << c.first << " " << c.second;
+                std::cout << ")\033[m" << std::endl;
+            } else {
+                std::cout << "\033[38;5;196m" << r.status << "\033[m" << std::endl;
+            }
+            results.push_back(r);
+        }
+    }
+
+    for (auto bg : games) delete bg;
+
+    if (options.count("json")) {
+        const std::string fn = options["json"].as<std::string>();
+        if (fn == "-") {
+            write_json(std::cout, results);
+        } else {
+            std::ofstream out(fn);
+            write_json(out, results);
+        }
+    }
+    if (options.count("csv")) {
+        const std::string fn = options["csv"].as<std::string>();
+        if (fn == "-") {
+            write_csv(std::cout, results);
+        } else {
+            std::ofstream out(fn);
+            write_csv(out, results);
+        }
+    }
+
+    int res = 0;
+    if (options.count("baseline")) {
+        if (compare_baseline(options["baseline"].as<std::string>(), results, options["threshold"].as<double>(), options["noise"].as<double>()) != 0) res = 1;
+    }
+    return res;
+}
@@ -47,6 +47,8 @@ bool opt_single = false;
 bool opt_loops = false;
 bool opt_wcwc = false;
 bool opt_sort = false;
+bool opt_par_verify = false;
+bool opt_cert = false;
 int opt_workers = 0;
 int opt_trace = -1;
 
@@ -118,12 +120,25 @@ test_solver(Game &game, int solverid, double &time, std::ostream &log)
 
     try {
         Verifier v(&game, log);
+        if (opt_par_verify) v.setWorkers(opt_workers >= 0 ? opt_workers : 0);
         v.verify(true, true, true);
     } catch (const char *err) {
         log << "verification error: " << err << std::endl;
         return 2;
     }
 
+    if (opt_cert) {
+        try {
+            std::stringstream cert;
+            Verifier v(&game, log);
+            v.certify(cert);
+            v.verifyCertificate(cert);
+        } catch (const char *err) {
+            log << "certificate error: " << err << std::endl;
+            return 2;
+        }
+    }
+
     return 0;
 }
  
@@ -161,6 +176,8 @@ main(int argc, char **argv)
     opts.add_options("Solving")
         ("t,trace", "Write trace with given level (0-3) to stdout", cxxopts::value<int>())
         ("w,workers", "Number of workers for parallel algorithms, or -1 for sequential, 0 for autodetect", cxxopts::value<int>()->default_value("-1"))
+        ("par-verify", "Verify solutions with the parallel verifier (with --workers, default autodetect)")
+        ("cert", "Also check a certificate of each solution")
         ;
 
     /* Parse command line */
@@ -195,6 +212,8 @@ main(int argc, char **argv)
     opt_loops = options.count("loops") != 0;
     opt_wcwc = options.count("wcwc") != 0;
     opt_sort = options.count("sort") != 0;
+    opt_par_verify = options.count("par-verify") != 0;
+    opt_cert = options.count("cert") != 0;
     if (options.count("workers")) opt_workers = options["workers"].as<int>();
     if (options.count("trace")) opt_trace = options["trace"].as<int>();
 